@@ -4,6 +4,7 @@
 // single reader, single writer queue
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 
 #include "Common/Atomic.h"
@@ -117,4 +118,94 @@ private:
 	volatile u32 m_size;
 };
 
+// A lockless, bounded queue with any number of writers and a single reader.
+// Elements are stored inline in a ring of Capacity slots, so pushing never
+// allocates; Push fails instead when the ring is full.
+//
+// Every slot carries a sequence number telling whether it is free for the
+// writer that claimed it, or filled and ready for the reader (see Dmitry
+// Vyukov's bounded MPMC queue, of which this is the single reader variant).
+template <typename T, u32 Capacity>
+class BoundedMPSCQueue
+{
+public:
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+	              "BoundedMPSCQueue capacity must be a power of two");
+
+	BoundedMPSCQueue() : m_write_pos(0), m_read_pos(0)
+	{
+		for (u32 i = 0; i < Capacity; ++i)
+			m_slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	// Can be called from any thread. Returns false if the queue is full.
+	template <typename Arg>
+	bool Push(Arg&& t)
+	{
+		u32 pos = m_write_pos.load(std::memory_order_relaxed);
+		Slot* slot;
+		while (true)
+		{
+			slot = &m_slots[pos & (Capacity - 1)];
+			u32 sequence = slot->sequence.load(std::memory_order_acquire);
+			s32 diff = (s32)(sequence - pos);
+			if (diff == 0)
+			{
+				// The slot is free; try to claim it.
+				if (m_write_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (diff < 0)
+			{
+				// The reader has not consumed this slot yet.
+				return false;
+			}
+			else
+			{
+				// Another writer claimed the slot first.
+				pos = m_write_pos.load(std::memory_order_relaxed);
+			}
+		}
+
+		slot->value = std::forward<Arg>(t);
+		slot->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Reader thread only. Returns false if the queue is empty, or if the next
+	// element is still being written.
+	bool Pop(T& t)
+	{
+		Slot& slot = m_slots[m_read_pos & (Capacity - 1)];
+		if (slot.sequence.load(std::memory_order_acquire) != m_read_pos + 1)
+			return false;
+
+		t = std::move(slot.value);
+		slot.sequence.store(m_read_pos + Capacity, std::memory_order_release);
+		++m_read_pos;
+		return true;
+	}
+
+	// Reader thread only.
+	bool Empty() const
+	{
+		const Slot& slot = m_slots[m_read_pos & (Capacity - 1)];
+		return slot.sequence.load(std::memory_order_acquire) != m_read_pos + 1;
+	}
+
+private:
+	struct Slot
+	{
+		std::atomic<u32> sequence;
+		T value;
+	};
+
+	Slot m_slots[Capacity];
+	// Keep the writers' and the reader's position on separate cache lines.
+	char m_pad0[64];
+	std::atomic<u32> m_write_pos;
+	char m_pad1[64];
+	u32 m_read_pos;
+};
+
 }
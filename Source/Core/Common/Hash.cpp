@@ -4,11 +4,19 @@
 
 #include <algorithm>
 #include "Common/Hash.h"
-#if _M_SSE >= 0x402
+#if _M_SSE >= 0x402 || _M_X86_64
 #include "Common/CPUDetect.h"
 #include <nmmintrin.h>
 #endif
 
+// The 64 bit CRC32 hash is picked at runtime, so it is built for SSE4.2 even
+// when the rest of the build isn't.
+#if _M_X86_64 && defined __GNUC__
+#define TARGET_SSE42 __attribute__((target("sse4.2")))
+#else
+#define TARGET_SSE42
+#endif
+
 static u64 (*ptrHashFunction)(const u8 *src, int len, u32 samples) = &GetMurmurHash3;
 
 // uint32_t
@@ -225,25 +233,42 @@ u64 GetMurmurHash3(const u8 *src, int len, u32 samples)
 }
 
 
-// CRC32 hash using the SSE4.2 instruction
-u64 GetCRC32(const u8 *src, int len, u32 samples)
+// CRC32 hash using the SSE4.2 instruction.
+// A full hash runs four CRCs over interleaved qwords: one alone is bound by
+// the latency of the instruction, and its 32 bits are too few for a 64 bit
+// hash. A sampled hash only needs a single one.
+TARGET_SSE42 u64 GetCRC32(const u8 *src, int len, u32 samples)
 {
-#if _M_SSE >= 0x402
-	u64 h = len;
+#if _M_X86_64
 	u32 Step = (len / 8);
 	const u64 *data = (const u64 *)src;
 	const u64 *end = data + Step;
-	if (samples == 0) samples = std::max(Step, 1u);
-	Step = Step / samples;
-	if (Step < 1) Step = 1;
-	while (data < end)
+	u64 h[4] = { (u64)len, 0x9368e53c, 0x586dcd20, 0x2f6af274 };
+
+	if (samples == 0)
 	{
-		h = _mm_crc32_u64(h, data[0]);
-		data += Step;
+		for (; data + 4 <= end; data += 4)
+		{
+			h[0] = _mm_crc32_u64(h[0], data[0]);
+			h[1] = _mm_crc32_u64(h[1], data[1]);
+			h[2] = _mm_crc32_u64(h[2], data[2]);
+			h[3] = _mm_crc32_u64(h[3], data[3]);
+		}
+		Step = 1;
 	}
+	else
+	{
+		Step = Step / samples;
+		if (Step < 1) Step = 1;
+	}
+	for (; data < end; data += Step)
+		h[0] = _mm_crc32_u64(h[0], data[0]);
 
 	const u8 *data2 = (const u8*)end;
-	return _mm_crc32_u64(h, u64(data2[0]));
+	for (int i = 0; i < (len & 7); ++i)
+		h[1] = _mm_crc32_u8((u32)h[1], data2[i]);
+
+	return fmix64(h[0] | (h[1] << 32)) ^ fmix64(h[2] | (h[3] << 32));
 #else
 	return 0;
 #endif
@@ -504,7 +529,7 @@ void SetHash64Function(bool useHiresTextures)
 	{
 		ptrHashFunction = &GetHashHiresTexture;
 	}
-#if _M_SSE >= 0x402
+#if _M_SSE >= 0x402 || _M_X86_64
 	else if (cpu_info.bSSE4_2 && !useHiresTextures) // sse crc32 version
 	{
 		ptrHashFunction = &GetCRC32;
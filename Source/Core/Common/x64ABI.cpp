@@ -229,6 +229,15 @@ void XEmitter::ABI_CallFunctionPPC(void *func, void *param1, void *param2,u32 pa
 	ABI_RestoreStack(3 * 4);
 }
 
+void XEmitter::ABI_CallFunctionPCA(void *func, void *param1, u32 param2, const Gen::OpArg &arg3) {
+	ABI_AlignStack(3 * 4);
+	PUSH(32, arg3);
+	PUSH(32, Imm32(param2));
+	PUSH(32, Imm32((u32)param1));
+	CALL(func);
+	ABI_RestoreStack(3 * 4);
+}
+
 // Pass a register as a parameter.
 void XEmitter::ABI_CallFunctionR(void *func, X64Reg reg1) {
 	ABI_AlignStack(1 * 4);
@@ -494,6 +503,28 @@ void XEmitter::ABI_CallFunctionPPC(void *func, void *param1, void *param2, u32 p
 	ABI_RestoreStack(0);
 }
 
+void XEmitter::ABI_CallFunctionPCA(void *func, void *param1, u32 param2, const Gen::OpArg &arg3) {
+	ABI_AlignStack(0);
+	// arg3 first, it may be in one of the other parameter registers.
+	if (!arg3.IsSimpleReg(ABI_PARAM3))
+		MOV(32, R(ABI_PARAM3), arg3);
+	MOV(64, R(ABI_PARAM1), Imm64((u64)param1));
+	MOV(32, R(ABI_PARAM2), Imm32(param2));
+	u64 distance = u64(func) - (u64(code) + 5);
+	if (distance >= 0x0000000080000000ULL &&
+	    distance <  0xFFFFFFFF80000000ULL)
+	{
+		// Far call
+		MOV(64, R(RAX), Imm64((u64)func));
+		CALLptr(R(RAX));
+	}
+	else
+	{
+		CALL(func);
+	}
+	ABI_RestoreStack(0);
+}
+
 // Pass a register as a parameter.
 void XEmitter::ABI_CallFunctionR(void *func, X64Reg reg1) {
 	ABI_AlignStack(0);
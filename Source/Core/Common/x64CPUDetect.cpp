@@ -42,7 +42,7 @@ static inline void do_cpuid(unsigned int *eax, unsigned int *ebx,
 		"movl  %%ebx,%1;"
 		: "=a" (*eax),
 		  "=S" (*ebx),
-		  "=c" (*ecx),
+		  "+c" (*ecx),
 		  "=d" (*edx)
 		: "a"  (*eax)
 		: "rbx"
@@ -53,7 +53,7 @@ static inline void do_cpuid(unsigned int *eax, unsigned int *ebx,
 		"movl  %%ebx,%1;"
 		: "=a" (*eax),
 		  "=S" (*ebx),
-		  "=c" (*ecx),
+		  "+c" (*ecx),
 		  "=d" (*edx)
 		: "a"  (*eax)
 		: "ebx"
@@ -62,12 +62,12 @@ static inline void do_cpuid(unsigned int *eax, unsigned int *ebx,
 }
 #endif /* defined __FreeBSD__ */
 
-static void __cpuid(int info[4], int x)
+static void __cpuidex(int info[4], int function_id, int subfunction_id)
 {
 #if defined __FreeBSD__
-	do_cpuid((unsigned int)x, (unsigned int*)info);
+	cpuid_count((unsigned int)function_id, (unsigned int)subfunction_id, (unsigned int*)info);
 #else
-	unsigned int eax = x, ebx = 0, ecx = 0, edx = 0;
+	unsigned int eax = function_id, ebx = 0, ecx = subfunction_id, edx = 0;
 	do_cpuid(&eax, &ebx, &ecx, &edx);
 	info[0] = eax;
 	info[1] = ebx;
@@ -76,6 +76,11 @@ static void __cpuid(int info[4], int x)
 #endif
 }
 
+static void __cpuid(int info[4], int x)
+{
+	__cpuidex(info, x, 0);
+}
+
 #define _XCR_XFEATURE_ENABLED_MASK 0
 static unsigned long long _xgetbv(unsigned int index)
 {
@@ -204,6 +209,13 @@ void CPUInfo::Detect()
 			}
 		}
 	}
+	if (max_std_fn >= 7)
+	{
+		__cpuidex(cpu_id, 0x00000007, 0x00000000);
+		// Needs the same OS support as AVX.
+		if ((cpu_id[1] >> 5) & 1)
+			bAVX2 = bAVX;
+	}
 	if (max_ex_fn >= 0x80000004) {
 		// Extract brand string
 		__cpuid(cpu_id, 0x80000002);
@@ -262,6 +274,7 @@ std::string CPUInfo::Summarize()
 	if (bSSE4_2) sum += ", SSE4.2";
 	if (HTT) sum += ", HTT";
 	if (bAVX) sum += ", AVX";
+	if (bAVX2) sum += ", AVX2";
 	if (bFMA) sum += ", FMA";
 	if (bAES) sum += ", AES";
 	if (bMOVBE) sum += ", MOVBE";
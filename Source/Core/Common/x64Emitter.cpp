@@ -158,22 +158,15 @@ void OpArg::WriteRex(XEmitter *emit, int opBits, int bits, int customOp) const
 #endif
 }
 
-void OpArg::WriteVex(XEmitter* emit, int size, int packed, Gen::X64Reg regOp1, Gen::X64Reg regOp2) const
+// pp encodes the implied 66/F3/F2 prefix, mmmmm the opcode map (aka
+// map_select in AMD manuals): 1 for 0F, 2 for 0F 38, 3 for 0F 3A.
+void OpArg::WriteVex(XEmitter* emit, X64Reg regOp1, X64Reg regOp2, int L, int pp, int mmmmm, int W) const
 {
 	int R = !(regOp1 & 8);
 	int X = !(indexReg & 8);
 	int B = !(offsetOrBaseReg & 8);
 
-	// not so sure about this one...
-	int W = 0;
-
-	// aka map_select in AMD manuals
-	// only support VEX opcode map 1 for now (analog to secondary opcode map)
-	int mmmmm = 1;
-
 	int vvvv = (regOp2 == X64Reg::INVALID_REG) ? 0xf : (regOp2 ^ 0xf);
-	int L = size == 256;
-	int pp = (packed << 1) | (size == 64);
 
 	// do we need any VEX fields that only appear in the three-byte form?
 	if (X == 1 && B == 1 && W == 0 && mmmmm == 1)
@@ -576,6 +569,7 @@ void XEmitter::NOP(size_t size)
 }
 
 void XEmitter::PAUSE() {Write8(0xF3); NOP();} //use in tight spinloops for energy saving on some cpu
+void XEmitter::RDTSC() {Write8(0x0F); Write8(0x31);}
 void XEmitter::CLC()  {Write8(0xF8);} //clear carry
 void XEmitter::CMC()  {Write8(0xF5);} //flip carry
 void XEmitter::STC()  {Write8(0xF9);} //set carry
@@ -1256,10 +1250,35 @@ void XEmitter::WriteAVXOp(int size, u8 sseOp, bool packed, X64Reg regOp, OpArg a
 	WriteAVXOp(size, sseOp, packed, regOp, X64Reg::INVALID_REG, arg, extrabytes);
 }
 
+// Same operand size conventions as WriteSSEOp.
 void XEmitter::WriteAVXOp(int size, u8 sseOp, bool packed, X64Reg regOp1, X64Reg regOp2, OpArg arg, int extrabytes)
 {
-	arg.WriteVex(this, size, packed, regOp1, regOp2);
-	Write8(sseOp);
+	u8 opPrefix;
+	if (packed)
+		opPrefix = size == 64 ? 0x66 : 0;
+	else
+		opPrefix = size == 64 ? 0xF2 : 0xF3;
+	WriteVEXOp(opPrefix, sseOp, regOp1, regOp2, arg, 0, extrabytes);
+}
+
+// op is the opcode after 0F, prefixed with 0x38 or 0x3A for those maps.
+void XEmitter::WriteVEXOp(u8 opPrefix, u16 op, X64Reg regOp1, X64Reg regOp2, OpArg arg, int W, int extrabytes)
+{
+	int pp;
+	switch (opPrefix)
+	{
+	case 0x66: pp = 1; break;
+	case 0xF3: pp = 2; break;
+	case 0xF2: pp = 3; break;
+	default:   pp = 0; break;
+	}
+	int mmmmm = 1;
+	if ((op >> 8) == 0x38)
+		mmmmm = 2;
+	else if ((op >> 8) == 0x3A)
+		mmmmm = 3;
+	arg.WriteVex(this, regOp1, regOp2, 0, pp, mmmmm, W);
+	Write8(op & 0xFF);
 	arg.WriteRest(this, extrabytes, regOp1);
 }
 
@@ -1588,8 +1607,38 @@ void XEmitter::VSUBSD(X64Reg regOp1, X64Reg regOp2, OpArg arg)   {WriteAVXOp(64,
 void XEmitter::VMULSD(X64Reg regOp1, X64Reg regOp2, OpArg arg)   {WriteAVXOp(64, sseMUL, false, regOp1, regOp2, arg);}
 void XEmitter::VDIVSD(X64Reg regOp1, X64Reg regOp2, OpArg arg)   {WriteAVXOp(64, sseDIV, false, regOp1, regOp2, arg);}
 void XEmitter::VSQRTSD(X64Reg regOp1, X64Reg regOp2, OpArg arg)  {WriteAVXOp(64, sseSQRT, false, regOp1, regOp2, arg);}
-void XEmitter::VPAND(X64Reg regOp1, X64Reg regOp2, OpArg arg)    {WriteAVXOp(64, sseAND, false, regOp1, regOp2, arg);}
-void XEmitter::VPANDN(X64Reg regOp1, X64Reg regOp2, OpArg arg)   {WriteAVXOp(64, sseANDN, false, regOp1, regOp2, arg);}
+void XEmitter::VADDPD(X64Reg regOp1, X64Reg regOp2, OpArg arg)   {WriteAVXOp(64, sseADD, true, regOp1, regOp2, arg);}
+void XEmitter::VSUBPD(X64Reg regOp1, X64Reg regOp2, OpArg arg)   {WriteAVXOp(64, sseSUB, true, regOp1, regOp2, arg);}
+void XEmitter::VMULPD(X64Reg regOp1, X64Reg regOp2, OpArg arg)   {WriteAVXOp(64, sseMUL, true, regOp1, regOp2, arg);}
+void XEmitter::VDIVPD(X64Reg regOp1, X64Reg regOp2, OpArg arg)   {WriteAVXOp(64, sseDIV, true, regOp1, regOp2, arg);}
+void XEmitter::VANDPD(X64Reg regOp1, X64Reg regOp2, OpArg arg)   {WriteAVXOp(64, sseAND, true, regOp1, regOp2, arg);}
+void XEmitter::VANDNPD(X64Reg regOp1, X64Reg regOp2, OpArg arg)  {WriteAVXOp(64, sseANDN, true, regOp1, regOp2, arg);}
+void XEmitter::VORPD(X64Reg regOp1, X64Reg regOp2, OpArg arg)    {WriteAVXOp(64, sseOR, true, regOp1, regOp2, arg);}
+void XEmitter::VXORPD(X64Reg regOp1, X64Reg regOp2, OpArg arg)   {WriteAVXOp(64, sseXOR, true, regOp1, regOp2, arg);}
+void XEmitter::VPAND(X64Reg regOp1, X64Reg regOp2, OpArg arg)    {WriteVEXOp(0x66, 0xDB, regOp1, regOp2, arg);}
+void XEmitter::VPANDN(X64Reg regOp1, X64Reg regOp2, OpArg arg)   {WriteVEXOp(0x66, 0xDF, regOp1, regOp2, arg);}
+void XEmitter::VPOR(X64Reg regOp1, X64Reg regOp2, OpArg arg)     {WriteVEXOp(0x66, 0xEB, regOp1, regOp2, arg);}
+void XEmitter::VPXOR(X64Reg regOp1, X64Reg regOp2, OpArg arg)    {WriteVEXOp(0x66, 0xEF, regOp1, regOp2, arg);}
+
+void XEmitter::VSHUFPD(X64Reg regOp1, X64Reg regOp2, OpArg arg, u8 shuffle) {WriteAVXOp(64, sseSHUF, true, regOp1, regOp2, arg, 1); Write8(shuffle);}
+void XEmitter::VUNPCKLPD(X64Reg regOp1, X64Reg regOp2, OpArg arg) {WriteAVXOp(64, 0x14, true, regOp1, regOp2, arg);}
+void XEmitter::VUNPCKHPD(X64Reg regOp1, X64Reg regOp2, OpArg arg) {WriteAVXOp(64, 0x15, true, regOp1, regOp2, arg);}
+
+void XEmitter::VBLENDPD(X64Reg regOp1, X64Reg regOp2, OpArg arg, u8 blend) {WriteVEXOp(0x66, 0x3A0D, regOp1, regOp2, arg, 0, 1); Write8(blend);}
+void XEmitter::VBLENDVPD(X64Reg regOp1, X64Reg regOp2, OpArg arg, X64Reg mask) {WriteVEXOp(0x66, 0x3A4B, regOp1, regOp2, arg, 0, 1); Write8((u8)mask << 4);}
+
+void XEmitter::VFMADD132SD(X64Reg regOp1, X64Reg regOp2, OpArg arg) {WriteVEXOp(0x66, 0x3899, regOp1, regOp2, arg, 1);}
+void XEmitter::VFMADD213SD(X64Reg regOp1, X64Reg regOp2, OpArg arg) {WriteVEXOp(0x66, 0x38A9, regOp1, regOp2, arg, 1);}
+void XEmitter::VFMADD231SD(X64Reg regOp1, X64Reg regOp2, OpArg arg) {WriteVEXOp(0x66, 0x38B9, regOp1, regOp2, arg, 1);}
+void XEmitter::VFMADD132PD(X64Reg regOp1, X64Reg regOp2, OpArg arg) {WriteVEXOp(0x66, 0x3898, regOp1, regOp2, arg, 1);}
+void XEmitter::VFMADD213PD(X64Reg regOp1, X64Reg regOp2, OpArg arg) {WriteVEXOp(0x66, 0x38A8, regOp1, regOp2, arg, 1);}
+void XEmitter::VFMADD231PD(X64Reg regOp1, X64Reg regOp2, OpArg arg) {WriteVEXOp(0x66, 0x38B8, regOp1, regOp2, arg, 1);}
+void XEmitter::VFMSUB132SD(X64Reg regOp1, X64Reg regOp2, OpArg arg) {WriteVEXOp(0x66, 0x389B, regOp1, regOp2, arg, 1);}
+void XEmitter::VFMSUB213SD(X64Reg regOp1, X64Reg regOp2, OpArg arg) {WriteVEXOp(0x66, 0x38AB, regOp1, regOp2, arg, 1);}
+void XEmitter::VFMSUB231SD(X64Reg regOp1, X64Reg regOp2, OpArg arg) {WriteVEXOp(0x66, 0x38BB, regOp1, regOp2, arg, 1);}
+void XEmitter::VFMSUB132PD(X64Reg regOp1, X64Reg regOp2, OpArg arg) {WriteVEXOp(0x66, 0x389A, regOp1, regOp2, arg, 1);}
+void XEmitter::VFMSUB213PD(X64Reg regOp1, X64Reg regOp2, OpArg arg) {WriteVEXOp(0x66, 0x38AA, regOp1, regOp2, arg, 1);}
+void XEmitter::VFMSUB231PD(X64Reg regOp1, X64Reg regOp2, OpArg arg) {WriteVEXOp(0x66, 0x38BA, regOp1, regOp2, arg, 1);}
 
 // Prefixes
 
@@ -47,7 +47,7 @@ namespace BootManager
 // Apply fire liberally
 struct ConfigCache
 {
-	bool valid, bCPUThread, bSkipIdle, bEnableFPRF, bMMU, bDCBZOFF, m_EnableJIT, bDSPThread,
+	bool valid, bCPUThread, bSkipIdle, bEnableFPRF, bFusedMultiplyAdd, bJITTieredCompilation, bMMU, bDCBZOFF, m_EnableJIT, bDSPThread,
 	     bVBeamSpeedHack, bSyncGPU, bFastDiscSpeed, bMergeBlocks, bDSPHLE, bHLE_BS2, bTLBHack;
 	int iCPUCore, Volume;
 	int iWiimoteSource[MAX_BBMOTES];
@@ -102,6 +102,8 @@ bool BootCore(const std::string& _rFilename)
 		config_cache.bSkipIdle = StartUp.bSkipIdle;
 		config_cache.iCPUCore = StartUp.iCPUCore;
 		config_cache.bEnableFPRF = StartUp.bEnableFPRF;
+		config_cache.bFusedMultiplyAdd = StartUp.bFusedMultiplyAdd;
+		config_cache.bJITTieredCompilation = StartUp.bJITTieredCompilation;
 		config_cache.bMMU = StartUp.bMMU;
 		config_cache.bDCBZOFF = StartUp.bDCBZOFF;
 		config_cache.bTLBHack = StartUp.bTLBHack;
@@ -139,6 +141,8 @@ bool BootCore(const std::string& _rFilename)
 		game_ini.Get("Core", "CPUThread",        &StartUp.bCPUThread, StartUp.bCPUThread);
 		game_ini.Get("Core", "SkipIdle",         &StartUp.bSkipIdle, StartUp.bSkipIdle);
 		game_ini.Get("Core", "EnableFPRF",       &StartUp.bEnableFPRF, StartUp.bEnableFPRF);
+		game_ini.Get("Core", "FusedMultiplyAdd", &StartUp.bFusedMultiplyAdd, StartUp.bFusedMultiplyAdd);
+		game_ini.Get("Core", "TieredCompilation", &StartUp.bJITTieredCompilation, StartUp.bJITTieredCompilation);
 		game_ini.Get("Core", "MMU",              &StartUp.bMMU, StartUp.bMMU);
 		game_ini.Get("Core", "TLBHack",          &StartUp.bTLBHack, StartUp.bTLBHack);
 		game_ini.Get("Core", "DCBZ",             &StartUp.bDCBZOFF, StartUp.bDCBZOFF);
@@ -257,6 +261,8 @@ void Stop()
 		StartUp.bSkipIdle = config_cache.bSkipIdle;
 		StartUp.iCPUCore = config_cache.iCPUCore;
 		StartUp.bEnableFPRF = config_cache.bEnableFPRF;
+		StartUp.bFusedMultiplyAdd = config_cache.bFusedMultiplyAdd;
+		StartUp.bJITTieredCompilation = config_cache.bJITTieredCompilation;
 		StartUp.bMMU = config_cache.bMMU;
 		StartUp.bDCBZOFF = config_cache.bDCBZOFF;
 		StartUp.bTLBHack = config_cache.bTLBHack;
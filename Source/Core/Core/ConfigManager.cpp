@@ -244,6 +244,7 @@ void SConfig::SaveSettings()
 	ini.Set("Core", "DSPThread",        m_LocalCoreStartupParameter.bDSPThread);
 	ini.Set("Core", "DSPHLE",           m_LocalCoreStartupParameter.bDSPHLE);
 	ini.Set("Core", "SkipIdle",         m_LocalCoreStartupParameter.bSkipIdle);
+	ini.Set("Core", "FusedMultiplyAdd", m_LocalCoreStartupParameter.bFusedMultiplyAdd);
 	ini.Set("Core", "DefaultGCM",       m_LocalCoreStartupParameter.m_strDefaultGCM);
 	ini.Set("Core", "DVDRoot",          m_LocalCoreStartupParameter.m_strDVDRoot);
 	ini.Set("Core", "Apploader",        m_LocalCoreStartupParameter.m_strApploader);
@@ -412,6 +413,7 @@ void SConfig::LoadSettings()
 		ini.Get("Core", "DSPHLE",            &m_LocalCoreStartupParameter.bDSPHLE,       true);
 		ini.Get("Core", "CPUThread",         &m_LocalCoreStartupParameter.bCPUThread,    true);
 		ini.Get("Core", "SkipIdle",          &m_LocalCoreStartupParameter.bSkipIdle,     true);
+		ini.Get("Core", "FusedMultiplyAdd",  &m_LocalCoreStartupParameter.bFusedMultiplyAdd, false);
 		ini.Get("Core", "DefaultGCM",        &m_LocalCoreStartupParameter.m_strDefaultGCM);
 		ini.Get("Core", "DVDRoot",           &m_LocalCoreStartupParameter.m_strDVDRoot);
 		ini.Get("Core", "Apploader",         &m_LocalCoreStartupParameter.m_strApploader);
@@ -427,6 +429,8 @@ void SConfig::LoadSettings()
 		ini.Get("Core", "BBA_MAC",           &m_bba_mac);
 		ini.Get("Core", "TimeProfiling",     &m_LocalCoreStartupParameter.bJITILTimeProfiling, false);
 		ini.Get("Core", "OutputIR",          &m_LocalCoreStartupParameter.bJITILOutputIR,      false);
+		ini.Get("Core", "TieredCompilation", &m_LocalCoreStartupParameter.bJITTieredCompilation, true);
+		ini.Get("Core", "PerfMap",           &m_LocalCoreStartupParameter.bJITPerfMap,         false);
 		for (int i = 0; i < MAX_SI_CHANNELS; ++i)
 		{
 			ini.Get("Core", StringFromFormat("SIDevice%i", i), (u32*)&m_SIDevice[i], (i == 0) ? SIDEVICE_GC_CONTROLLER : SIDEVICE_NONE);
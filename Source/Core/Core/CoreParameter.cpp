@@ -32,7 +32,8 @@ SCoreStartupParameter::SCoreStartupParameter()
   bJITPairedOff(false), bJITSystemRegistersOff(false),
   bJITBranchOff(false),
   bJITILTimeProfiling(false), bJITILOutputIR(false),
-  bEnableFPRF(false),
+  bJITTieredCompilation(true), bJITPerfMap(false),
+  bEnableFPRF(false), bFusedMultiplyAdd(false),
   bCPUThread(true), bDSPThread(false), bDSPHLE(true),
   bSkipIdle(true), bNTSC(false), bForceNTSCJ(false),
   bHLE_BS2(true), bEnableCheats(false),
@@ -73,6 +74,7 @@ void SCoreStartupParameter::LoadDefaults()
 	bDSPThread = true;
 	bFastmem = true;
 	bEnableFPRF = false;
+	bFusedMultiplyAdd = false;
 	bMMU = false;
 	bDCBZOFF = false;
 	bTLBHack = false;
@@ -114,9 +114,17 @@ struct SCoreStartupParameter
 	bool bJITBranchOff;
 	bool bJITILTimeProfiling;
 	bool bJITILOutputIR;
+	bool bJITTieredCompilation; // recompile hot blocks with the optimizing tier (Jit64)
+	bool bJITPerfMap; // describe the blocks in /tmp/perf-<pid>.map for perf (Linux)
 
 	bool bFastmem;
 	bool bEnableFPRF;
+	// Rounds the fmadd and ps_madd families once, like the hardware, instead of
+	// after the multiply and again after the add. [Core] FusedMultiplyAdd in
+	// Dolphin.ini or a game ini. Off by default: the result then matches what
+	// Dolphin always computed, and Jit64 has to interpret these instructions
+	// on hosts without FMA3.
+	bool bFusedMultiplyAdd;
 
 	bool bCPUThread;
 	bool bDSPThread;
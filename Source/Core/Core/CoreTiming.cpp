@@ -2,6 +2,8 @@
 // Licensed under GPLv2
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <atomic>
 #include <cinttypes>
 #include <string>
 #include <vector>
@@ -25,6 +27,8 @@ struct EventType
 {
 	TimedCallback callback;
 	std::string name;
+	// Pool index of the first scheduled event of this type, or -1.
+	int first_scheduled;
 };
 
 std::vector<EventType> event_types;
@@ -36,15 +40,53 @@ struct BaseEvent
 	int type;
 };
 
-typedef LinkedListItem<BaseEvent> Event;
+// Events live in a pool and are referenced by index. The pending events form
+// a binary min-heap ordered by (time, order); every event is also linked into
+// a list of the events sharing its type, so that removing all events of one
+// type does not need to scan the whole queue.
+struct Event : public BaseEvent
+{
+	// Position in the heap, or -1 if this pool slot is free.
+	int heap_index;
+	// Links of the per-type list. next_of_type doubles as the free list link.
+	int next_of_type;
+	int prev_of_type;
+};
+
+// The sort key is kept in the heap itself so that sifting does not have to
+// touch the pool.
+struct HeapEntry
+{
+	s64 time;
+	// Insertion order, so that events scheduled for the same time run in the
+	// order they were scheduled. Compared modulo 2^32.
+	u32 order;
+	int event;
+};
+
+// Number of events preallocated at Init. The pool only grows if more events
+// than this are pending at once, which does not happen in practice.
+#define INITIAL_EVENT_POOL_SIZE 256
 
 // STATE_TO_SAVE
-static Event *first;
+static std::vector<Event> eventPool;
+static std::vector<HeapEntry> eventHeap;
+static int firstFreeEvent = -1;
+static u32 eventOrder;
+
+// Events scheduled from other threads. They go through a lockless ring, and
+// only if the CPU thread falls behind and lets it fill up do the writers take
+// tsWriteLock and use the overflow queue instead. The ring then stays closed
+// until the CPU thread has moved the overflowed events, so that the events
+// after them cannot overtake them through the ring.
+#define TS_QUEUE_SIZE 1024
+static Common::BoundedMPSCQueue<BaseEvent, TS_QUEUE_SIZE> tsQueue;
 static std::mutex tsWriteLock;
-Common::FifoQueue<BaseEvent, false> tsQueue;
-
-// event pools
-Event *eventPool = nullptr;
+static Common::FifoQueue<BaseEvent, false> tsOverflowQueue;
+static std::atomic<bool> tsRingClosed;
+// Writers that may be pushing into the ring. Raised before tsRingClosed is
+// checked, so that whoever closes the ring can wait for them.
+static std::atomic<int> tsRingWriters;
 
 int downcount, slicelength;
 int maxSliceLength = MAX_SLICE_LENGTH;
@@ -62,20 +104,148 @@ int ev_lost;
 
 void (*advanceCallback)(int cyclesExecuted) = nullptr;
 
-Event* GetNewEvent()
+static inline bool EventBefore(const HeapEntry& a, const HeapEntry& b)
 {
-	if (!eventPool)
-		return new Event;
+	return a.time < b.time || (a.time == b.time && (s32)(a.order - b.order) < 0);
+}
+
+static inline void HeapSet(int pos, const HeapEntry& entry)
+{
+	eventHeap[pos] = entry;
+	eventPool[entry.event].heap_index = pos;
+}
+
+// Both sift functions fill the hole at pos with entry, moving the entries in
+// the way up or down the heap.
+static void HeapSiftUp(int pos, HeapEntry entry)
+{
+	while (pos > 0)
+	{
+		int parent = (pos - 1) / 2;
+		if (!EventBefore(entry, eventHeap[parent]))
+			break;
+		HeapSet(pos, eventHeap[parent]);
+		pos = parent;
+	}
+	HeapSet(pos, entry);
+}
 
-	Event* ev = eventPool;
-	eventPool = ev->next;
+static void HeapSiftDown(int pos, HeapEntry entry)
+{
+	int size = (int)eventHeap.size();
+	while (true)
+	{
+		int child = 2 * pos + 1;
+		if (child >= size)
+			break;
+		if (child + 1 < size)
+			child += EventBefore(eventHeap[child + 1], eventHeap[child]);
+		if (!EventBefore(eventHeap[child], entry))
+			break;
+		HeapSet(pos, eventHeap[child]);
+		pos = child;
+	}
+	HeapSet(pos, entry);
+}
+
+// Adds new slots to the pool and threads them onto the free list.
+static void GrowEventPool()
+{
+	int old_size = (int)eventPool.size();
+	int new_size = old_size ? old_size * 2 : INITIAL_EVENT_POOL_SIZE;
+	if (old_size)
+		WARN_LOG(POWERPC, "Growing the event pool to %d events", new_size);
+	eventPool.resize(new_size);
+	eventHeap.reserve(new_size);
+	for (int i = new_size - 1; i >= old_size; --i)
+	{
+		eventPool[i].heap_index = -1;
+		eventPool[i].next_of_type = firstFreeEvent;
+		firstFreeEvent = i;
+	}
+}
+
+static int GetNewEvent()
+{
+	if (firstFreeEvent < 0)
+		GrowEventPool();
+
+	int ev = firstFreeEvent;
+	firstFreeEvent = eventPool[ev].next_of_type;
 	return ev;
 }
 
-void FreeEvent(Event* ev)
+// Unlinks the event from the heap and from its type list, and returns it to the pool.
+static void FreeEvent(int ev)
 {
-	ev->next = eventPool;
-	eventPool = ev;
+	Event& e = eventPool[ev];
+
+	int pos = e.heap_index;
+	HeapEntry last = eventHeap.back();
+	eventHeap.pop_back();
+	if (last.event != ev)
+	{
+		if (pos > 0 && EventBefore(last, eventHeap[(pos - 1) / 2]))
+			HeapSiftUp(pos, last);
+		else
+			HeapSiftDown(pos, last);
+	}
+
+	if (e.prev_of_type >= 0)
+		eventPool[e.prev_of_type].next_of_type = e.next_of_type;
+	else
+		event_types[e.type].first_scheduled = e.next_of_type;
+	if (e.next_of_type >= 0)
+		eventPool[e.next_of_type].prev_of_type = e.prev_of_type;
+
+	e.heap_index = -1;
+	e.next_of_type = firstFreeEvent;
+	firstFreeEvent = ev;
+}
+
+static inline bool HasEvents()
+{
+	return !eventHeap.empty();
+}
+
+static inline Event& FirstEvent()
+{
+	return eventPool[eventHeap[0].event];
+}
+
+// Returns the indices of all pending events, in the order they will be run.
+static std::vector<int> GetSortedEvents()
+{
+	std::vector<HeapEntry> sorted(eventHeap);
+	std::sort(sorted.begin(), sorted.end(), EventBefore);
+
+	std::vector<int> events;
+	events.reserve(sorted.size());
+	for (const HeapEntry& entry : sorted)
+		events.push_back(entry.event);
+	return events;
+}
+
+static void AddEventToQueue(const BaseEvent& base);
+
+// Keeps the other threads out of the ring, so that they queue up on
+// tsWriteLock, which the caller holds. Moves all their events so far, in the
+// order they were scheduled: the ones in the ring came before the overflowed
+// ones.
+static void CloseRing()
+{
+	// Both this and ScheduleEvent_Threadsafe store their flag, then load the
+	// other's: all four have to be sequentially consistent so that at least
+	// one side sees the other.
+	tsRingClosed.store(true);
+	while (tsRingWriters.load() != 0)
+		Common::YieldCPU();
+
+	BaseEvent sevt;
+	while (tsQueue.Pop(sevt))
+		AddEventToQueue(sevt);
+	while (tsOverflowQueue.Pop(sevt))
+		AddEventToQueue(sevt);
 }
 
 static void EmptyTimedCallback(u64 userdata, int cyclesLate) {}
@@ -85,6 +255,7 @@ int RegisterEvent(const std::string& name, TimedCallback callback)
 	EventType type;
 	type.name = name;
 	type.callback = callback;
+	type.first_scheduled = -1;
 
 	// check for existing type with same name.
 	// we want event type names to remain unique so that we can use them for serialization.
@@ -106,7 +277,7 @@ int RegisterEvent(const std::string& name, TimedCallback callback)
 
 void UnregisterAllEvents()
 {
-	if (first)
+	if (HasEvents())
 		PanicAlertT("Cannot unregister events with events pending");
 	event_types.clear();
 }
@@ -119,21 +290,21 @@ void Init()
 	idledCycles = 0;
 
 	ev_lost = RegisterEvent("_lost_event", &EmptyTimedCallback);
+
+	if (eventPool.empty())
+		GrowEventPool();
 }
 
 void Shutdown()
 {
 	std::lock_guard<std::mutex> lk(tsWriteLock);
-	MoveEvents();
+	CloseRing();
 	ClearPendingEvents();
 	UnregisterAllEvents();
 
-	while (eventPool)
-	{
-		Event *ev = eventPool;
-		eventPool = ev->next;
-		delete ev;
-	}
+	eventPool.clear();
+	eventHeap.clear();
+	firstFreeEvent = -1;
 }
 
 void EventDoState(PointerWrap &p, BaseEvent* ev)
@@ -172,7 +343,11 @@ void EventDoState(PointerWrap &p, BaseEvent* ev)
 
 void DoState(PointerWrap &p)
 {
+	// The other threads wait on the lock until the state is done, and the ring
+	// reopens at the next MoveEvents.
 	std::lock_guard<std::mutex> lk(tsWriteLock);
+	CloseRing();
+
 	p.Do(downcount);
 	p.Do(slicelength);
 	p.Do(globalTimer);
@@ -183,9 +358,34 @@ void DoState(PointerWrap &p)
 	p.Do(fakeTBStartTicks);
 	p.DoMarker("CoreTimingData");
 
-	MoveEvents();
+	// The events are stored the way PointerWrap::DoLinkedList stores a list,
+	// sorted by time, to keep old savestates loadable.
+	if (p.GetMode() == PointerWrap::MODE_READ)
+	{
+		ClearPendingEvents();
+		while (true)
+		{
+			u8 shouldExist = 0;
+			p.Do(shouldExist);
+			if (shouldExist != 1)
+				break;
 
-	p.DoLinkedList<BaseEvent, GetNewEvent, FreeEvent, EventDoState>(first);
+			BaseEvent ev;
+			EventDoState(p, &ev);
+			AddEventToQueue(ev);
+		}
+	}
+	else
+	{
+		for (int ev : GetSortedEvents())
+		{
+			u8 shouldExist = 1;
+			p.Do(shouldExist);
+			EventDoState(p, &eventPool[ev]);
+		}
+		u8 shouldExist = 0;
+		p.Do(shouldExist);
+	}
 	p.DoMarker("CoreTimingEvents");
 }
 
@@ -203,12 +403,20 @@ u64 GetIdleTicks()
 // schedule things to be executed on the main thread.
 void ScheduleEvent_Threadsafe(int cyclesIntoFuture, int event_type, u64 userdata)
 {
-	std::lock_guard<std::mutex> lk(tsWriteLock);
-	Event ne;
+	BaseEvent ne;
 	ne.time = globalTimer + cyclesIntoFuture;
 	ne.type = event_type;
 	ne.userdata = userdata;
-	tsQueue.Push(ne);
+
+	tsRingWriters.fetch_add(1);
+	bool pushed = !tsRingClosed.load() && tsQueue.Push(ne);
+	tsRingWriters.fetch_sub(1, std::memory_order_release);
+	if (pushed)
+		return;
+
+	std::lock_guard<std::mutex> lk(tsWriteLock);
+	tsRingClosed.store(true, std::memory_order_relaxed);
+	tsOverflowQueue.Push(ne);
 }
 
 // Same as ScheduleEvent_Threadsafe(0, ...) EXCEPT if we are already on the CPU thread
@@ -227,30 +435,39 @@ void ScheduleEvent_Threadsafe_Immediate(int event_type, u64 userdata)
 
 void ClearPendingEvents()
 {
-	while (first)
+	for (const HeapEntry& entry : eventHeap)
 	{
-		Event *e = first->next;
-		FreeEvent(first);
-		first = e;
+		int ev = entry.event;
+		Event& e = eventPool[ev];
+		event_types[e.type].first_scheduled = -1;
+		e.heap_index = -1;
+		e.next_of_type = firstFreeEvent;
+		firstFreeEvent = ev;
 	}
+	eventHeap.clear();
 }
 
-void AddEventToQueue(Event* ne)
+static void AddEventToQueue(const BaseEvent& base)
 {
-	Event* prev = nullptr;
-	Event** pNext = &first;
-	for (;;)
-	{
-		Event*& next = *pNext;
-		if (!next || ne->time < next->time)
-		{
-			ne->next = next;
-			next = ne;
-			break;
-		}
-		prev = next;
-		pNext = &prev->next;
-	}
+	int ev = GetNewEvent();
+	Event& ne = eventPool[ev];
+	ne.time = base.time;
+	ne.userdata = base.userdata;
+	ne.type = base.type;
+
+	int& first_of_type = event_types[ne.type].first_scheduled;
+	ne.prev_of_type = -1;
+	ne.next_of_type = first_of_type;
+	if (first_of_type >= 0)
+		eventPool[first_of_type].prev_of_type = ev;
+	first_of_type = ev;
+
+	HeapEntry entry;
+	entry.time = ne.time;
+	entry.order = eventOrder++;
+	entry.event = ev;
+	eventHeap.emplace_back();
+	HeapSiftUp((int)eventHeap.size() - 1, entry);
 }
 
 // This must be run ONLY from within the cpu thread
@@ -258,10 +475,10 @@ void AddEventToQueue(Event* ne)
 // than Advance
 void ScheduleEvent(int cyclesIntoFuture, int event_type, u64 userdata)
 {
-	Event *ne = GetNewEvent();
-	ne->userdata = userdata;
-	ne->type = event_type;
-	ne->time = globalTimer + cyclesIntoFuture;
+	BaseEvent ne;
+	ne.userdata = userdata;
+	ne.type = event_type;
+	ne.time = globalTimer + cyclesIntoFuture;
 	AddEventToQueue(ne);
 }
 
@@ -272,55 +489,14 @@ void RegisterAdvanceCallback(void (*callback)(int cyclesExecuted))
 
 bool IsScheduled(int event_type)
 {
-	if (!first)
-		return false;
-	Event *e = first;
-	while (e) {
-		if (e->type == event_type)
-			return true;
-		e = e->next;
-	}
-	return false;
+	return event_types[event_type].first_scheduled >= 0;
 }
 
 void RemoveEvent(int event_type)
 {
-	if (!first)
-		return;
-
-	while (first)
-	{
-		if (first->type == event_type)
-		{
-			Event *next = first->next;
-			FreeEvent(first);
-			first = next;
-		}
-		else
-		{
-			break;
-		}
-	}
-
-	if (!first)
-		return;
-
-	Event *prev = first;
-	Event *ptr = prev->next;
-	while (ptr)
-	{
-		if (ptr->type == event_type)
-		{
-			prev->next = ptr->next;
-			FreeEvent(ptr);
-			ptr = prev->next;
-		}
-		else
-		{
-			prev = ptr;
-			ptr = ptr->next;
-		}
-	}
+	int& first_of_type = event_types[event_type].first_scheduled;
+	while (first_of_type >= 0)
+		FreeEvent(first_of_type);
 }
 
 void RemoveAllEvents(int event_type)
@@ -349,40 +525,38 @@ void ResetSliceLength()
 }
 
 
+// Pops the earliest event off the queue and runs its callback. The event's
+// slot is released first, so the callback can reschedule into it.
+static void RunFirstEvent()
+{
+	int ev = eventHeap[0].event;
+	s64 time = eventPool[ev].time;
+	u64 userdata = eventPool[ev].userdata;
+	int type = eventPool[ev].type;
+	FreeEvent(ev);
+	event_types[type].callback(userdata, (int)(globalTimer - time));
+}
+
 //This raise only the events required while the fifo is processing data
 void ProcessFifoWaitEvents()
 {
 	MoveEvents();
 
-	if (!first)
-		return;
-
-	while (first)
-	{
-		if (first->time <= globalTimer)
-		{
-			Event* evt = first;
-			first = first->next;
-			event_types[evt->type].callback(evt->userdata, (int)(globalTimer - evt->time));
-			FreeEvent(evt);
-		}
-		else
-		{
-			break;
-		}
-	}
+	while (HasEvents() && FirstEvent().time <= globalTimer)
+		RunFirstEvent();
 }
 
 void MoveEvents()
 {
 	BaseEvent sevt;
 	while (tsQueue.Pop(sevt))
+		AddEventToQueue(sevt);
+
+	if (tsRingClosed.load(std::memory_order_acquire))
 	{
-		Event *evt = GetNewEvent();
-		evt->time = sevt.time;
-		evt->userdata = sevt.userdata;
-		evt->type = sevt.type;
-		AddEventToQueue(evt);
+		std::lock_guard<std::mutex> lk(tsWriteLock);
+		CloseRing();
+		tsRingClosed.store(false, std::memory_order_release);
 	}
 }
 
@@ -394,31 +568,21 @@ void Advance()
 	globalTimer += cyclesExecuted;
 	downcount = slicelength;
 
-	while (first)
+	while (HasEvents() && FirstEvent().time <= globalTimer)
 	{
-		if (first->time <= globalTimer)
-		{
-			//LOG(POWERPC, "[Scheduler] %s     (%lld, %lld) ",
-			//             event_types[first->type].name ? event_types[first->type].name : "?", (u64)globalTimer, (u64)first->time);
-			Event* evt = first;
-			first = first->next;
-			event_types[evt->type].callback(evt->userdata, (int)(globalTimer - evt->time));
-			FreeEvent(evt);
-		}
-		else
-		{
-			break;
-		}
+		//LOG(POWERPC, "[Scheduler] %s     (%lld, %lld) ",
+		//             event_types[FirstEvent().type].name.c_str(), (u64)globalTimer, (u64)FirstEvent().time);
+		RunFirstEvent();
 	}
 
-	if (!first)
+	if (!HasEvents())
 	{
 		WARN_LOG(POWERPC, "WARNING - no events in queue. Setting downcount to 10000");
 		downcount += 10000;
 	}
 	else
 	{
-		slicelength = (int)(first->time - globalTimer);
+		slicelength = (int)(FirstEvent().time - globalTimer);
 		if (slicelength > maxSliceLength)
 			slicelength = maxSliceLength;
 		downcount = slicelength;
@@ -430,11 +594,10 @@ void Advance()
 
 void LogPendingEvents()
 {
-	Event *ptr = first;
-	while (ptr)
+	for (int ev : GetSortedEvents())
 	{
-		INFO_LOG(POWERPC, "PENDING: Now: %" PRId64 " Pending: %" PRId64 " Type: %d", globalTimer, ptr->time, ptr->type);
-		ptr = ptr->next;
+		const Event& e = eventPool[ev];
+		INFO_LOG(POWERPC, "PENDING: Now: %" PRId64 " Pending: %" PRId64 " Type: %d", globalTimer, e.time, e.type);
 	}
 }
 
@@ -459,19 +622,18 @@ void Idle()
 
 std::string GetScheduledEventsSummary()
 {
-	Event *ptr = first;
 	std::string text = "Scheduled events\n";
 	text.reserve(1000);
-	while (ptr)
+	for (int ev : GetSortedEvents())
 	{
-		unsigned int t = ptr->type;
+		const Event& e = eventPool[ev];
+		unsigned int t = e.type;
 		if (t >= event_types.size())
 			PanicAlertT("Invalid event type %i", t);
 
-		const std::string& name = event_types[ptr->type].name;
+		const std::string& name = event_types[e.type].name;
 
-		text += StringFromFormat("%s : %" PRIi64 " %016" PRIx64 "\n", name.c_str(), ptr->time, ptr->userdata);
-		ptr = ptr->next;
+		text += StringFromFormat("%s : %" PRIi64 " %016" PRIx64 "\n", name.c_str(), e.time, e.userdata);
 	}
 	return text;
 }
@@ -149,6 +149,7 @@ enum XCheckTLBFlag
 };
 u32 TranslateAddress(u32 _Address, XCheckTLBFlag _Flag);
 void InvalidateTLBEntry(u32 _Address);
+void InvalidateTLB();
 extern u32 pagetable_base;
 extern u32 pagetable_hashmask;
 };
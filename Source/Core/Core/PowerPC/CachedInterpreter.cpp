@@ -0,0 +1,248 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#include "Common/Atomic.h"
+
+#include "Core/PatchEngine.h"
+#include "Core/HLE/HLE.h"
+#include "Core/PowerPC/CachedInterpreter.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/PPCTables.h"
+
+void CachedInterpreter::Init()
+{
+	m_code.reserve(CODE_SIZE);
+
+	js.memcheck = Core::g_CoreStartupParameter.bMMU;
+
+	code_block.m_stats = &js.st;
+	code_block.m_gpa = &js.gpa;
+	code_block.m_fpa = &js.fpa;
+
+	m_block_cache.Init();
+}
+
+void CachedInterpreter::Shutdown()
+{
+	m_block_cache.Shutdown();
+}
+
+void CachedInterpreter::ExecuteOneBlock()
+{
+	int block_num = m_block_cache.GetBlockNumberFromStartAddress(PC);
+	if (block_num < 0)
+	{
+		Jit(PC);
+		block_num = m_block_cache.GetBlockNumberFromStartAddress(PC);
+	}
+	m_block_cache.GetBlock(block_num)->runCount++;
+
+	const Instruction* code = (const Instruction*)m_block_cache.GetCompiledCodeFromBlock(block_num);
+	while (true)
+	{
+		switch (code->type)
+		{
+		case Instruction::INSTRUCTION_ABORT:
+			return;
+
+		case Instruction::INSTRUCTION_COMMON:
+			code->common_callback(UGeckoInstruction(code->data));
+			break;
+
+		case Instruction::INSTRUCTION_CONDITIONAL:
+			if (code->conditional_callback(code->data))
+				return;
+			break;
+		}
+		code++;
+	}
+}
+
+void CachedInterpreter::Run()
+{
+	// Breakpoints and stepping are the interpreter's job.
+	if (Core::g_CoreStartupParameter.bEnableDebugging)
+	{
+		Interpreter::getInstance()->Run();
+		return;
+	}
+
+	while (!PowerPC::GetState())
+	{
+		while (CoreTiming::downcount > 0)
+			ExecuteOneBlock();
+
+		CoreTiming::Advance();
+
+		if (PowerPC::ppcState.Exceptions)
+		{
+			PowerPC::CheckExceptions();
+			PC = NPC;
+		}
+	}
+}
+
+void CachedInterpreter::SingleStep()
+{
+	Interpreter::getInstance()->SingleStep();
+}
+
+// Some of the interpreter's instructions read PC, and NPC is where the block
+// continues unless the instruction branches.
+static void WritePC(UGeckoInstruction data)
+{
+	PC = data.hex;
+	NPC = data.hex + 4;
+}
+
+static bool EndBlock(u32 downcount)
+{
+	PC = NPC;
+	CoreTiming::downcount -= downcount;
+	return true;
+}
+
+static bool CheckFPU(u32 downcount)
+{
+	if (!((UReg_MSR&)MSR).FP)
+	{
+		Common::AtomicOr(PowerPC::ppcState.Exceptions, EXCEPTION_FPU_UNAVAILABLE);
+		PowerPC::CheckExceptions();
+		return EndBlock(downcount);
+	}
+	return false;
+}
+
+static bool CheckDSI(u32 downcount)
+{
+	if (PowerPC::ppcState.Exceptions & EXCEPTION_DSI)
+	{
+		PowerPC::CheckExceptions();
+		return EndBlock(downcount);
+	}
+	return false;
+}
+
+static bool RaiseISI(u32 address)
+{
+	// Address of instruction could not be translated
+	NPC = address;
+	Common::AtomicOr(PowerPC::ppcState.Exceptions, EXCEPTION_ISI);
+	PowerPC::CheckExceptions();
+	// Remove the invalid instruction from the icache, forcing a recompile
+	*jit->GetBlockCache()->GetICachePtr(address) = JIT_ICACHE_INVALID_WORD;
+	PC = NPC;
+	return true;
+}
+
+static void CheckIdleLoop(UGeckoInstruction destination)
+{
+	// Taken, the loop only waits for the next event.
+	if (NPC == destination.hex)
+		PowerPC::OnIdleLoop(destination.hex);
+}
+
+void CachedInterpreter::Jit(u32 em_address)
+{
+	// No analyzer options: blocks end at the first branch, like the interpreter's.
+	u32 nextPC = analyzer.Analyze(em_address, &code_block, &code_buffer, code_buffer.GetSize());
+	u32 num_inst = code_block.m_num_instructions;
+
+	if (m_code.size() + MaxCodeSize(num_inst) > CODE_SIZE || m_block_cache.IsFull() ||
+	    Core::g_CoreStartupParameter.bJITNoBlockCache)
+	{
+		ClearCache();
+	}
+
+	int block_num = m_block_cache.AllocateBlock(em_address);
+	JitBlock *b = m_block_cache.GetBlock(block_num);
+	b->checkedEntry = b->normalEntry = (const u8*)(m_code.data() + m_code.size());
+	b->ticCounter = 0;
+	b->ticStart = 0;
+	b->ticStop = 0;
+
+	PPCAnalyst::CodeOp *ops = code_buffer.codebuffer;
+	size_t start = m_code.size();
+	js.downcountAmount = PatchEngine::GetSpeedhackCycles(em_address);
+	js.firstFPInstructionFound = false;
+	bool ended = false;
+	for (u32 i = 0; i < num_inst && !ended; i++)
+	{
+		const PPCAnalyst::CodeOp &op = ops[i];
+		const GekkoOPInfo *opinfo = op.opinfo;
+		js.downcountAmount += opinfo->numCycles;
+
+		bool check_fpu = (opinfo->flags & FL_USE_FPU) && !js.firstFPInstructionFound;
+		bool check_dsi = js.memcheck && (opinfo->flags & FL_LOADSTORE);
+		bool end = (opinfo->flags & FL_ENDBLOCK) || i == num_inst - 1;
+		if (check_fpu || check_dsi || end)
+			m_code.emplace_back(WritePC, op.address);
+
+		u32 function = HLE::GetFunctionIndex(op.address);
+		if (function != 0)
+		{
+			int type = HLE::GetFunctionTypeByIndex(function);
+			if (type == HLE::HLE_HOOK_START || type == HLE::HLE_HOOK_REPLACE)
+			{
+				int flags = HLE::GetFunctionFlagsByIndex(function);
+				if (HLE::IsEnabled(flags))
+				{
+					if (!check_fpu && !check_dsi && !end)
+						m_code.emplace_back(WritePC, op.address);
+					m_code.emplace_back(Interpreter::HLEFunction, function);
+					if (type == HLE::HLE_HOOK_REPLACE)
+					{
+						m_code.emplace_back(EndBlock, js.downcountAmount);
+						ended = true;
+						break;
+					}
+				}
+			}
+		}
+
+		if (check_fpu)
+		{
+			m_code.emplace_back(CheckFPU, js.downcountAmount);
+			js.firstFPInstructionFound = true;
+		}
+
+		Interpreter::_interpreterInstruction handler = GetInterpreterOp(op.inst);
+		if (!handler)
+			handler = Interpreter::unknown_instruction;
+		m_code.emplace_back(handler, op.inst);
+
+		if (check_dsi)
+			m_code.emplace_back(CheckDSI, js.downcountAmount);
+
+		if (end)
+		{
+			if (op.branchIsIdleLoop && Core::g_CoreStartupParameter.bSkipIdle)
+			{
+				u32 destination = op.inst.OPCD == 16 ?
+					(op.inst.AA ? 0 : op.address) + SignExt16(op.inst.BD << 2) :
+					(op.inst.AA ? 0 : op.address) + SignExt26(op.inst.LI << 2);
+				m_code.emplace_back(CheckIdleLoop, destination);
+			}
+			m_code.emplace_back(EndBlock, js.downcountAmount);
+			ended = true;
+		}
+	}
+
+	// Only a block whose first instruction can't be fetched gets here without
+	// an end, the ones before a failed fetch end normally.
+	if (!ended)
+		m_code.emplace_back(RaiseISI, nextPC);
+	m_code.emplace_back();
+
+	b->codeSize = (u32)(m_code.size() - start);
+	_assert_msg_(POWERPC, b->codeSize <= MaxCodeSize(num_inst), "Block at %08x took %u entries", em_address, b->codeSize);
+	b->originalSize = num_inst;
+	m_block_cache.FinalizeBlock(block_num, false, b->checkedEntry);
+}
+
+void CachedInterpreter::ClearCache()
+{
+	m_code.clear();
+	m_block_cache.Clear();
+}
@@ -0,0 +1,94 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <vector>
+
+#include "Common/Common.h"
+
+#include "Core/PowerPC/PPCAnalyst.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
+#include "Core/PowerPC/JitCommon/JitBase.h"
+#include "Core/PowerPC/JitCommon/JitCache.h"
+
+// The blocks of the cached interpreter are arrays of these instead of code,
+// one entry per interpreter call, with the checks the interpreter does for
+// every instruction only where the block needs them.
+class CachedInterpreterBlockCache : public JitBaseBlockCache
+{
+private:
+	// There is no code to patch, blocks are entered through the lookup.
+	void WriteLinkBlock(u8* location, const u8* address) override {}
+	void WriteDestroyBlock(const u8* location, u32 address) override {}
+};
+
+class CachedInterpreter : public JitBase
+{
+public:
+	CachedInterpreter() : code_buffer(32000) {}
+	~CachedInterpreter() {}
+
+	void Init() override;
+	void Shutdown() override;
+
+	void ClearCache() override;
+
+	void Run() override;
+	void SingleStep() override;
+
+	void Jit(u32 em_address) override;
+
+	JitBaseBlockCache *GetBlockCache() override { return &m_block_cache; }
+
+	const char *GetName() override { return "Cached Interpreter"; }
+
+	const u8 *BackPatch(u8 *codePtr, u32 em_address, void *ctx) override { return nullptr; }
+	const CommonAsmRoutinesBase *GetAsmRoutines() override { return nullptr; }
+	bool IsInCodeSpace(u8 *ptr) override { return false; }
+
+private:
+	struct Instruction
+	{
+		typedef void (*CommonCallback)(UGeckoInstruction);
+		// Returns true when the block is left.
+		typedef bool (*ConditionalCallback)(u32 data);
+
+		enum Type
+		{
+			INSTRUCTION_ABORT,
+			INSTRUCTION_COMMON,
+			INSTRUCTION_CONDITIONAL,
+		};
+
+		Instruction() : type(INSTRUCTION_ABORT) {}
+		Instruction(CommonCallback c, UGeckoInstruction i) : common_callback(c), data(i.hex), type(INSTRUCTION_COMMON) {}
+		Instruction(ConditionalCallback c, u32 d) : conditional_callback(c), data(d), type(INSTRUCTION_CONDITIONAL) {}
+
+		union
+		{
+			CommonCallback common_callback;
+			ConditionalCallback conditional_callback;
+		};
+		u32 data;
+		Type type;
+	};
+
+	enum
+	{
+		// Entries, the array is never reallocated so that blocks can point into it.
+		CODE_SIZE = 1024 * 1024,
+	};
+
+	// Every instruction takes up to five entries: WritePC, an HLE hook,
+	// CheckFPU, the handler and CheckDSI. The end of the block adds up to
+	// three: CheckIdleLoop and EndBlock, or RaiseISI, then the abort.
+	static u32 MaxCodeSize(u32 num_inst) { return 5 * num_inst + 3; }
+
+	void ExecuteOneBlock();
+
+	CachedInterpreterBlockCache m_block_cache;
+	std::vector<Instruction> m_code;
+	PPCAnalyst::CodeBuffer code_buffer;
+};
@@ -6,6 +6,7 @@
 
 #include "PowerPCDisasm.h"
 
+#include "Core/Core.h"
 #include "Core/Host.h"
 #include "Core/Debugger/Debugger_SymbolMap.h"
 #include "Core/IPC_HLE/WII_IPC_HLE.h"
@@ -21,6 +22,7 @@ namespace {
 }
 
 bool Interpreter::m_EndBlock;
+bool Interpreter::m_FusedMultiplyAdd;
 
 // function tables
 Interpreter::_interpreterInstruction Interpreter::m_opTable[64];
@@ -40,6 +42,7 @@ void Interpreter::Init()
 {
 	g_bReserve = false;
 	m_EndBlock = false;
+	m_FusedMultiplyAdd = Core::g_CoreStartupParameter.bFusedMultiplyAdd;
 }
 
 void Interpreter::Shutdown()
@@ -37,6 +37,9 @@ public:
 	// to keep the code cleaner
 	#define m_GPR (PowerPC::ppcState.gpr)
 	static bool m_EndBlock;
+	// Whether the fmadd and ps_madd families round once, see
+	// SCoreStartupParameter::bFusedMultiplyAdd.
+	static bool m_FusedMultiplyAdd;
 
 	static void unknown_instruction(UGeckoInstruction _inst);
 
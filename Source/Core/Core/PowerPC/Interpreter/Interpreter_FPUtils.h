@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cmath>
 #include <limits>
 
 #include "Common/CPUDetect.h"
@@ -169,6 +170,9 @@ inline double NI_madd(const double a, const double b, const double c)
 	}
 	return t;
 #else
+	// When fused, like the hardware, the product isn't rounded before the add.
+	if (Interpreter::m_FusedMultiplyAdd)
+		return std::fma(a, b, c);
 	return NI_add(NI_mul(a, b), c);
 #endif
 }
@@ -198,6 +202,8 @@ inline double NI_msub(const double a, const double b, const double c)
 //	return t;
 //#else
 //	This code does not calculate QNAN's correctly but calculates negative zero correctly.
+	if (Interpreter::m_FusedMultiplyAdd)
+		return std::fma(a, b, -c);
 	return NI_sub(NI_mul(a, b), c);
 // #endif
 }
@@ -175,6 +175,8 @@ void Interpreter::mtmsr(UGeckoInstruction _inst)
 
 static void SetSR(int index, u32 value) {
 	DEBUG_LOG(POWERPC, "%08x: MMU: Segment register %i set to %08x", PowerPC::ppcState.pc, index, value);
+	if (PowerPC::ppcState.sr[index] != value)
+		Memory::InvalidateTLB();
 	PowerPC::ppcState.sr[index] = value;
 }
 
@@ -351,6 +353,19 @@ void Interpreter::mtspr(UGeckoInstruction _inst)
 	case SPR_SDR:
 		Memory::SDRUpdated();
 		break;
+
+	case SPR_IBAT0U: case SPR_IBAT0L: case SPR_IBAT1U: case SPR_IBAT1L:
+	case SPR_IBAT2U: case SPR_IBAT2L: case SPR_IBAT3U: case SPR_IBAT3L:
+	case SPR_DBAT0U: case SPR_DBAT0L: case SPR_DBAT1U: case SPR_DBAT1L:
+	case SPR_DBAT2U: case SPR_DBAT2L: case SPR_DBAT3U: case SPR_DBAT3L:
+	case SPR_IBAT4U: case SPR_IBAT4L: case SPR_IBAT5U: case SPR_IBAT5L:
+	case SPR_IBAT6U: case SPR_IBAT6L: case SPR_IBAT7U: case SPR_IBAT7L:
+	case SPR_DBAT4U: case SPR_DBAT4L: case SPR_DBAT5U: case SPR_DBAT5L:
+	case SPR_DBAT6U: case SPR_DBAT6L: case SPR_DBAT7U: case SPR_DBAT7L:
+		// BATs take precedence over the cached page translations.
+		if (oldValue != m_GPR[_inst.RD])
+			Memory::InvalidateTLB();
+		break;
 	}
 }
 
@@ -137,10 +137,10 @@ static GekkoOPTemplate table4_2[] =
 
 static GekkoOPTemplate table4_3[] =
 {
-	{6,  Interpreter::psq_lx,       {"psq_lx",   OPTYPE_PS, FL_USE_FPU | FL_LOADSTORE, 1, 0, 0, 0}},
-	{7,  Interpreter::psq_stx,      {"psq_stx",  OPTYPE_PS, FL_USE_FPU | FL_LOADSTORE, 1, 0, 0, 0}},
-	{38, Interpreter::psq_lux,      {"psq_lux",  OPTYPE_PS, FL_USE_FPU | FL_LOADSTORE, 1, 0, 0, 0}},
-	{39, Interpreter::psq_stux,     {"psq_stux", OPTYPE_PS, FL_USE_FPU | FL_LOADSTORE, 1, 0, 0, 0}},
+	{6,  Interpreter::psq_lx,       {"psq_lx",   OPTYPE_PS, FL_IN_A0B | FL_USE_FPU | FL_LOADSTORE, 1, 0, 0, 0}},
+	{7,  Interpreter::psq_stx,      {"psq_stx",  OPTYPE_PS, FL_IN_A0B | FL_USE_FPU | FL_LOADSTORE, 1, 0, 0, 0}},
+	{38, Interpreter::psq_lux,      {"psq_lux",  OPTYPE_PS, FL_OUT_A | FL_IN_AB | FL_USE_FPU | FL_LOADSTORE, 1, 0, 0, 0}},
+	{39, Interpreter::psq_stux,     {"psq_stux", OPTYPE_PS, FL_OUT_A | FL_IN_AB | FL_USE_FPU | FL_LOADSTORE, 1, 0, 0, 0}},
 };
 
 static GekkoOPTemplate table19[] =
@@ -221,20 +221,20 @@ static GekkoOPTemplate table31[] =
 	{597, Interpreter::lswi,        {"lswi",  OPTYPE_LOAD, FL_EVIL | FL_IN_AB | FL_OUT_D | FL_LOADSTORE, 1, 0, 0, 0}},
 
 	//store word
-	{151, Interpreter::stwx,        {"stwx",   OPTYPE_STORE, FL_IN_A0 | FL_IN_B | FL_LOADSTORE, 1, 0, 0, 0}},
-	{183, Interpreter::stwux,       {"stwux",  OPTYPE_STORE, FL_OUT_A | FL_IN_A | FL_IN_B | FL_LOADSTORE, 1, 0, 0, 0}},
+	{151, Interpreter::stwx,        {"stwx",   OPTYPE_STORE, FL_IN_A0 | FL_IN_B | FL_IN_S | FL_LOADSTORE, 1, 0, 0, 0}},
+	{183, Interpreter::stwux,       {"stwux",  OPTYPE_STORE, FL_OUT_A | FL_IN_A | FL_IN_B | FL_IN_S | FL_LOADSTORE, 1, 0, 0, 0}},
 
 	//store halfword
-	{407, Interpreter::sthx,        {"sthx",   OPTYPE_STORE, FL_IN_A0 | FL_IN_B | FL_LOADSTORE, 1, 0, 0, 0}},
-	{439, Interpreter::sthux,       {"sthux",  OPTYPE_STORE, FL_OUT_A | FL_IN_A | FL_IN_B | FL_LOADSTORE, 1, 0, 0, 0}},
+	{407, Interpreter::sthx,        {"sthx",   OPTYPE_STORE, FL_IN_A0 | FL_IN_B | FL_IN_S | FL_LOADSTORE, 1, 0, 0, 0}},
+	{439, Interpreter::sthux,       {"sthux",  OPTYPE_STORE, FL_OUT_A | FL_IN_A | FL_IN_B | FL_IN_S | FL_LOADSTORE, 1, 0, 0, 0}},
 
 	//store byte
-	{215, Interpreter::stbx,        {"stbx",   OPTYPE_STORE, FL_IN_A0 | FL_IN_B | FL_LOADSTORE, 1, 0, 0, 0}},
-	{247, Interpreter::stbux,       {"stbux",  OPTYPE_STORE, FL_OUT_A | FL_IN_A | FL_IN_B | FL_LOADSTORE, 1, 0, 0, 0}},
+	{215, Interpreter::stbx,        {"stbx",   OPTYPE_STORE, FL_IN_A0 | FL_IN_B | FL_IN_S | FL_LOADSTORE, 1, 0, 0, 0}},
+	{247, Interpreter::stbux,       {"stbux",  OPTYPE_STORE, FL_OUT_A | FL_IN_A | FL_IN_B | FL_IN_S | FL_LOADSTORE, 1, 0, 0, 0}},
 
 	//store bytereverse
-	{662, Interpreter::stwbrx,      {"stwbrx", OPTYPE_STORE, FL_IN_A0 | FL_IN_B | FL_LOADSTORE, 1, 0, 0, 0}},
-	{918, Interpreter::sthbrx,      {"sthbrx", OPTYPE_STORE, FL_IN_A | FL_IN_B | FL_LOADSTORE, 1, 0, 0, 0}},
+	{662, Interpreter::stwbrx,      {"stwbrx", OPTYPE_STORE, FL_IN_A0 | FL_IN_B | FL_IN_S | FL_LOADSTORE, 1, 0, 0, 0}},
+	{918, Interpreter::sthbrx,      {"sthbrx", OPTYPE_STORE, FL_IN_A0 | FL_IN_B | FL_IN_S | FL_LOADSTORE, 1, 0, 0, 0}},
 
 	{661, Interpreter::stswx,       {"stswx",  OPTYPE_STORE, FL_EVIL | FL_LOADSTORE, 1, 0, 0, 0}},
 	{725, Interpreter::stswi,       {"stswi",  OPTYPE_STORE, FL_EVIL | FL_LOADSTORE, 1, 0, 0, 0}},
@@ -269,8 +269,8 @@ static GekkoOPTemplate table31[] =
 	{982, Interpreter::icbi,        {"icbi",   OPTYPE_SYSTEM, FL_ENDBLOCK, 4, 0, 0, 0}},
 
 	// Unused instructions on GC
-	{310, Interpreter::eciwx,       {"eciwx",   OPTYPE_INTEGER, FL_RC_BIT, 1, 0, 0, 0}},
-	{438, Interpreter::ecowx,       {"ecowx",   OPTYPE_INTEGER, FL_RC_BIT, 1, 0, 0, 0}},
+	{310, Interpreter::eciwx,       {"eciwx",   OPTYPE_INTEGER, FL_OUT_D | FL_IN_A0B | FL_RC_BIT, 1, 0, 0, 0}},
+	{438, Interpreter::ecowx,       {"ecowx",   OPTYPE_INTEGER, FL_IN_A0B | FL_IN_S | FL_RC_BIT, 1, 0, 0, 0}},
 	{854, Interpreter::eieio,       {"eieio",   OPTYPE_INTEGER, FL_RC_BIT, 1, 0, 0, 0}},
 	{306, Interpreter::tlbie,       {"tlbie",   OPTYPE_SYSTEM, 0, 1, 0, 0, 0}},
 	{370, Interpreter::tlbia,       {"tlbia",   OPTYPE_SYSTEM, 0, 1, 0, 0, 0}},
@@ -145,6 +145,42 @@ namespace CPUCompare
 	extern u32 m_BlockStart;
 }
 
+// Exits which can be linked to a block are this large (see
+// JitBaseBlockCache::WriteDestroyBlock).
+static const int INDIRECT_EXIT_SLOT_SIZE = 15;
+
+#if _M_X86_64
+// Predicts the destination of blr: each call pushes its return address along
+// with an exit of the calling block which jumps there.
+struct ReturnStackEntry
+{
+	u32 address;
+	const u8 *code;
+};
+
+enum
+{
+	RETURN_STACK_SIZE = 16,
+};
+
+static ReturnStackEntry s_return_stack[RETURN_STACK_SIZE];
+static u32 s_return_stack_top;
+#endif
+
+// Must be called whenever the code of the entries may have gone away.
+static void ClearReturnStack()
+{
+#if _M_X86_64
+	for (ReturnStackEntry &entry : s_return_stack)
+	{
+		// Unaligned, so never a return address.
+		entry.address = 1;
+		entry.code = nullptr;
+	}
+	s_return_stack_top = 0;
+#endif
+}
+
 void Jit64::Init()
 {
 	jo.optimizeStack = true;
@@ -171,6 +207,7 @@ void Jit64::Init()
 	jo.optimizeGatherPipe = true;
 	jo.fastInterrupts = false;
 	jo.accurateSinglePrecision = true;
+	jo.tieredCompilation = Core::g_CoreStartupParameter.bJITTieredCompilation;
 	js.memcheck = Core::g_CoreStartupParameter.bMMU;
 
 	gpr.SetEmitter(this);
@@ -181,6 +218,7 @@ void Jit64::Init()
 
 	blocks.Init();
 	asm_routines.Init();
+	ClearReturnStack();
 
 	code_block.m_stats = &js.st;
 	code_block.m_gpa = &js.gpa;
@@ -193,6 +231,65 @@ void Jit64::ClearCache()
 	blocks.Clear();
 	trampolines.ClearCodeSpace();
 	ClearCodeSpace();
+	code_region = 0;
+	ClearReturnStack();
+}
+
+void Jit64::EvictCodeRegion()
+{
+	ClearReturnStack();
+
+	// How often the blocks of each region ran since the last eviction.
+	u64 heat[NUM_CODE_REGIONS] = {};
+	int numBlocks[NUM_CODE_REGIONS] = {};
+	for (int i = 0; i < blocks.GetNumBlocks(); i++)
+	{
+		JitBlock *b = blocks.GetBlock(i);
+		if (b->invalid)
+			continue;
+		int r = (int)((b->checkedEntry - region) / (region_size / NUM_CODE_REGIONS));
+		// Blocks only count their runs until they are promoted, or while
+		// blocks are profiled. The others flag that they ran, and one which
+		// still runs weighs as much as getting hot takes.
+		heat[r] += (u32)(b->runCount - b->evictionRunCount);
+		if (b->used)
+			heat[r] += HOT_BLOCK_THRESHOLD;
+		numBlocks[r]++;
+		b->evictionRunCount = b->runCount;
+		b->used = false;
+	}
+
+	// Prefer a region which doesn't need evicting, unless we are out of blocks.
+	// Ties go to the region which was filled the longest time ago.
+	bool needBlocks = blocks.IsFull();
+	int victim = -1;
+	for (int n = 1; n <= NUM_CODE_REGIONS; n++)
+	{
+		int r = (code_region + n) % NUM_CODE_REGIONS;
+		if (needBlocks && !numBlocks[r])
+			continue;
+		if (!needBlocks && !numBlocks[r] && r != code_region)
+		{
+			victim = r;
+			break;
+		}
+		if (victim == -1 || heat[r] < heat[victim])
+			victim = r;
+	}
+
+	int evicted = blocks.EvictBlocks(GetCodeRegionStart(victim), GetCodeRegionEnd(victim));
+	INFO_LOG(DYNA_REC, "Evicted %d blocks from code region %d", evicted, victim);
+
+	code_region = victim;
+	SetCodePtr(GetCodeRegionStart(victim));
+}
+
+static void PromoteHotBlock(u32 address)
+{
+	JitBlockCache *blocks = ((Jit64 *)jit)->GetBlockCache();
+	int block_num = blocks->GetBlockNumberFromStartAddress(address);
+	if (block_num >= 0)
+		blocks->PromoteBlock(block_num);
 }
 
 void Jit64::Shutdown()
@@ -225,6 +322,7 @@ void Jit64::unknown_instruction(UGeckoInstruction inst)
 
 void Jit64::FallBackToInterpreter(UGeckoInstruction _inst)
 {
+	js.curBlock->numFallbacks++;
 	WriteCallInterpreter(_inst.hex);
 }
 
@@ -271,6 +369,20 @@ static void ImHere()
 
 void Jit64::Cleanup()
 {
+	// Every exit from a block goes through here, so this is where the time
+	// spent in the block is accounted.
+	if (Profiler::g_ProfileBlocks)
+	{
+		JitBlock *b = js.curBlock;
+		// CAUTION!!! push on stack regs you use, do your stuff, then pop
+		PROFILER_VPUSH;
+		// get end tic
+		PROFILER_QUERY_PERFORMANCE_COUNTER(&b->ticStop);
+		// tic counter += (end tic - start tic)
+		PROFILER_ADD_DIFF_LARGE_INTEGER(&b->ticCounter, &b->ticStop, &b->ticStart);
+		PROFILER_VPOP;
+	}
+
 	if (jo.optimizeGatherPipe && js.fifoBytesThisBlock > 0)
 	{
 		ABI_CallFunction((void *)&GPFifo::CheckGatherPipe);
@@ -287,6 +399,13 @@ void Jit64::WriteExit(u32 destination)
 
 	SUB(32, M(&CoreTiming::downcount), js.downcountAmount > 127 ? Imm32(js.downcountAmount) : Imm8(js.downcountAmount));
 
+	WriteLinkableJump(destination);
+}
+
+// Jumps to the block at destination, directly once that block exists.
+// Expects the flags of the downcount subtraction.
+void Jit64::WriteLinkableJump(u32 destination)
+{
 	//If nobody has taken care of this yet (this can be removed when all branches are done)
 	JitBlock *b = js.curBlock;
 	JitBlock::LinkData linkData;
@@ -294,21 +413,150 @@ void Jit64::WriteExit(u32 destination)
 	linkData.exitPtrs = GetWritableCodePtr();
 	linkData.linkStatus = false;
 
+	// Always emit the unlinked exit, so that there is room to unlink it again
+	// if the destination is evicted (see JitBaseBlockCache::EvictBlocks).
+	MOV(32, M(&PC), Imm32(destination));
+	JMP(asm_routines.dispatcher, true);
+
 	// Link opportunity!
 	int block;
 	if (jo.enableBlocklink && (block = blocks.GetBlockNumberFromStartAddress(destination)) >= 0)
 	{
 		// It exists! Joy of joy!
+		u8 *exitEnd = GetWritableCodePtr();
+		SetCodePtr(linkData.exitPtrs);
 		JMP(blocks.GetBlock(block)->checkedEntry, true);
+		SetCodePtr(exitEnd);
 		linkData.linkStatus = true;
 	}
-	else
+
+	b->linkData.push_back(linkData);
+}
+
+// Jumps to the destination of the branch instruction at branch_index. This
+// stays within the block if the analyzer found the destination in it.
+void Jit64::WriteBranch(u32 destination, u32 branch_index)
+{
+	const PPCAnalyst::CodeOp &op = code_buffer.codebuffer[branch_index];
+	if (op.branchIsIdleLoop && Core::g_CoreStartupParameter.bSkipIdle)
 	{
+		// Nothing changes until the next event, wait for it instead of spinning.
+		ABI_CallFunctionC((void *)&PowerPC::OnIdleLoop, destination);
 		MOV(32, M(&PC), Imm32(destination));
-		JMP(asm_routines.dispatcher, true);
+		WriteExceptionExit();
+		return;
+	}
+	if (op.branchToIndex < 0)
+	{
+		WriteExit(destination);
+		return;
 	}
 
-	b->linkData.push_back(linkData);
+	// The registers go where the destination expects them. The code after the
+	// branch continues with them where they are.
+	u32 target = op.branchToIndex;
+	gpr.SaveState();
+	fpr.SaveState();
+	gpr.FlushKeeping(target_regs[target], loop_homes);
+	fpr.Flush(FLUSH_ALL);
+
+	if (target > branch_index)
+	{
+		// Exits after the destination count the skipped instructions too.
+		int skipped = op_cycles[target] - op_cycles[branch_index + 1];
+		if (skipped)
+			ADD(32, M(&CoreTiming::downcount), Imm32(skipped));
+		forward_branches.push_back(std::make_pair(target, J(true)));
+		gpr.LoadState();
+		fpr.LoadState();
+		return;
+	}
+
+	// Loop back edge. This is the only place the loop checks the downcount, each
+	// iteration pays for itself here.
+	int loopCycles = op_cycles[branch_index + 1] - op_cycles[target];
+	if (jo.optimizeGatherPipe && js.fifoBytesThisBlock > 0)
+	{
+		u32 registersInUse = RegistersInUse();
+		ABI_PushRegistersAndAdjustStack(registersInUse, false);
+		ABI_CallFunction((void *)&GPFifo::CheckGatherPipe);
+		ABI_PopRegistersAndAdjustStack(registersInUse, false);
+	}
+	SUB(32, M(&CoreTiming::downcount), Imm32(loopCycles));
+	J_CC(CC_NBE, branch_targets[target]);
+
+	// Out of time. The iterations were already paid for, only account for the
+	// code before the loop. This can't leave through WriteExit: the downcount
+	// is no longer positive, and a subtraction of its own would leave flags
+	// which let the next block run on anyway.
+	gpr.Flush(FLUSH_ALL);
+	Cleanup();
+	int downcountAmount = std::max(js.downcountAmount - loopCycles, 0);
+	if (downcountAmount)
+		SUB(32, M(&CoreTiming::downcount), Imm32(downcountAmount));
+	MOV(32, M(&PC), Imm32(destination));
+	JMP(asm_routines.doTiming, true);
+	gpr.LoadState();
+	fpr.LoadState();
+}
+
+bool Jit64::IsBranchInBlock(const PPCAnalyst::CodeOp &op) const
+{
+	return op.branchToIndex >= 0 && !(op.branchIsIdleLoop && Core::g_CoreStartupParameter.bSkipIdle);
+}
+
+// Picks the GPRs to keep in host registers around the loops, and which branch
+// targets expect them there: those in a loop.
+void Jit64::AllocateLoopRegs(const PPCAnalyst::CodeOp *ops, u32 num_instructions)
+{
+	std::vector<bool> in_loop(num_instructions, false);
+	int uses[32] = {};
+	for (u32 i = 0; i < num_instructions; i++)
+	{
+		if (!IsBranchInBlock(ops[i]) || (u32)ops[i].branchToIndex > i)
+			continue;
+		for (u32 j = ops[i].branchToIndex; j <= i; j++)
+		{
+			if (in_loop[j])
+				continue;
+			in_loop[j] = true;
+			for (s8 reg : ops[j].regsIn)
+			{
+				if (reg >= 0)
+					uses[reg]++;
+			}
+			for (s8 reg : ops[j].regsOut)
+			{
+				if (reg >= 0)
+					uses[reg]++;
+			}
+		}
+	}
+
+	// The most used ones, leaving two host registers for the others.
+	int count;
+	const int *order = gpr.GetAllocationOrder(count);
+	loop_regs = 0;
+	for (int n = 0; n < count - 2; n++)
+	{
+		int best = -1;
+		for (int reg = 0; reg < 32; reg++)
+		{
+			if (uses[reg] && !(loop_regs & (1 << reg)) && (best < 0 || uses[reg] > uses[best]))
+				best = reg;
+		}
+		if (best < 0)
+			break;
+		loop_regs |= 1 << best;
+		loop_homes[best] = (X64Reg)order[n];
+	}
+
+	target_regs.assign(num_instructions, 0);
+	for (u32 i = 0; i < num_instructions; i++)
+	{
+		if (ops[i].isBranchTarget && in_loop[i])
+			target_regs[i] = loop_regs;
+	}
 }
 
 void Jit64::WriteExitDestInEAX()
@@ -319,6 +567,129 @@ void Jit64::WriteExitDestInEAX()
 	JMP(asm_routines.dispatcher, true);
 }
 
+// Called the first time an indirect branch misses its inline cache: the
+// current destination becomes its guess, and the exit at slot is linked to it.
+// Later misses go straight to the dispatcher.
+static void LearnIndirectBranch(u8 *slot, u32 *guess, u32 block_num)
+{
+	JitBaseBlockCache *blocks = jit->GetBlockCache();
+	JitBlock *b = blocks->GetBlock(block_num);
+	// The block may have been destroyed while it ran.
+	if (b->invalid || slot < b->normalEntry || slot >= b->normalEntry + b->codeSize)
+		return;
+
+	*guess = PC;
+	blocks->AddBlockExit(block_num, slot, PC);
+	XEmitter emit(slot + INDIRECT_EXIT_SLOT_SIZE);
+	emit.JMP(jit->GetAsmRoutines()->dispatcherNoCheck, true);
+}
+
+// An exit through bcctr, with an inline cache of the destination it took
+// the first time.
+void Jit64::WriteIndirectExitDestInEAX()
+{
+	if (!jo.enableBlocklink)
+	{
+		WriteExitDestInEAX();
+		return;
+	}
+
+	MOV(32, M(&PC), R(EAX));
+	Cleanup();
+	MOV(32, R(EAX), M(&PC));
+	SUB(32, M(&CoreTiming::downcount), js.downcountAmount > 127 ? Imm32(js.downcountAmount) : Imm8(js.downcountAmount));
+	// Out of time, let the dispatcher take care of it.
+	J_CC(CC_BE, asm_routines.dispatcher);
+
+	FixupBranch skipGuess = J();
+	u32 *guess = (u32 *)GetWritableCodePtr();
+	Write32(0);
+	SetJumpTarget(skipGuess);
+
+	CMP(32, R(EAX), M(guess));
+	FixupBranch miss = J_CC(CC_NE, true);
+	// The linked block checks for "above", like after the downcount subtraction.
+	TEST(32, R(EAX), R(EAX));
+	// Same as an unlinked exit, so that the block cache can link it.
+	u8 *slot = GetWritableCodePtr();
+	MOV(32, M(&PC), R(EAX));
+	JMP(asm_routines.dispatcher, true);
+	while (GetCodePtr() < slot + INDIRECT_EXIT_SLOT_SIZE)
+		NOP(1);
+
+	// Patched to go to the dispatcher once the guess is learnt.
+	SetJumpTarget(miss);
+	FixupBranch learn = J(true);
+	SetJumpTarget(learn);
+	ABI_CallFunctionPPC((void *)&LearnIndirectBranch, slot, guess, (u32)(js.curBlock - blocks.GetBlock(0)));
+	JMP(asm_routines.dispatcherNoCheck, true);
+}
+
+// Called for calls, before their exit. Expects the destination of bcctrl in
+// EAX, if any.
+void Jit64::PushReturnStack(u32 return_address)
+{
+#if _M_X86_64
+	if (!jo.enableBlocklink)
+		return;
+
+	// The code returning to the caller, only reached through the return stack.
+	FixupBranch skip = J(true);
+	const u8 *return_code = GetCodePtr();
+	WriteLinkableJump(return_address);
+	SetJumpTarget(skip);
+
+	MOV(32, R(EDX), M(&s_return_stack_top));
+	ADD(32, R(EDX), Imm8(1));
+	AND(32, R(EDX), Imm8(RETURN_STACK_SIZE - 1));
+	MOV(32, M(&s_return_stack_top), R(EDX));
+	SHL(32, R(EDX), Imm8(4));
+	MOV(64, R(RCX), ImmPtr(s_return_stack));
+	ADD(64, R(RCX), R(RDX));
+	MOV(32, MatR(RCX), Imm32(return_address));
+	MOV(64, R(RDX), ImmPtr(return_code));
+	MOV(64, MDisp(RCX, offsetof(ReturnStackEntry, code)), R(RDX));
+#endif
+}
+
+// An exit through blr, which returns to the caller directly if it was the
+// last call on the return stack.
+void Jit64::WriteReturnExitDestInEAX()
+{
+#if _M_X86_64
+	if (!jo.enableBlocklink)
+	{
+		WriteExitDestInEAX();
+		return;
+	}
+
+	MOV(32, M(&PC), R(EAX));
+	Cleanup();
+	MOV(32, R(EAX), M(&PC));
+	SUB(32, M(&CoreTiming::downcount), js.downcountAmount > 127 ? Imm32(js.downcountAmount) : Imm8(js.downcountAmount));
+	// Out of time, let the dispatcher take care of it.
+	J_CC(CC_BE, asm_routines.dispatcher);
+
+	// Pop, whether the prediction turns out right or not.
+	MOV(32, R(EDX), M(&s_return_stack_top));
+	MOV(32, R(ECX), R(EDX));
+	SUB(32, R(ECX), Imm8(1));
+	AND(32, R(ECX), Imm8(RETURN_STACK_SIZE - 1));
+	MOV(32, M(&s_return_stack_top), R(ECX));
+	SHL(32, R(EDX), Imm8(4));
+	MOV(64, R(RCX), ImmPtr(s_return_stack));
+	CMP(32, R(EAX), MComplex(RCX, RDX, SCALE_1, offsetof(ReturnStackEntry, address)));
+	FixupBranch miss = J_CC(CC_NE);
+	// The exit checks for "above", like after the downcount subtraction.
+	TEST(32, R(EAX), R(EAX));
+	JMPptr(MComplex(RCX, RDX, SCALE_1, offsetof(ReturnStackEntry, code)));
+	SetJumpTarget(miss);
+	JMP(asm_routines.dispatcherNoCheck, true);
+#else
+	WriteExitDestInEAX();
+#endif
+}
+
 void Jit64::WriteRfiExitDestInEAX()
 {
 	MOV(32, M(&PC), R(EAX));
@@ -392,13 +763,18 @@ void Jit64::Trace()
 
 void STACKALIGN Jit64::Jit(u32 em_address)
 {
-	if (GetSpaceLeft() < 0x10000 || blocks.IsFull() || Core::g_CoreStartupParameter.bJITNoBlockCache)
+	if (trampolines.GetSpaceLeft() < 0x10000 || Core::g_CoreStartupParameter.bJITNoBlockCache)
 	{
 		ClearCache();
 	}
+	else if (GetCodeRegionEnd(code_region) - GetCodePtr() < 0x10000 || blocks.IsFull())
+	{
+		EvictCodeRegion();
+	}
 
 	int block_num = blocks.AllocateBlock(em_address);
 	JitBlock *b = blocks.GetBlock(block_num);
+	b->tier = blocks.IsPromoted(em_address) ? 1 : 0;
 	blocks.FinalizeBlock(block_num, jo.enableBlocklink, DoJit(em_address, &code_buffer, b));
 }
 
@@ -422,9 +798,29 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBloc
 	js.blockStart = em_address;
 	js.fifoBytesThisBlock = 0;
 	js.curBlock = b;
+	js.skipDeadResults = !js.memcheck && !Core::g_CoreStartupParameter.bEnableDebugging;
 	jit->js.numLoadStoreInst = 0;
 	jit->js.numFloatingPointInst = 0;
 
+	// The optimizing tier spends more time on analysis.
+	analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_REORDER);
+	analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_COMPLEX_BLOCK);
+	analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_FORWARD_JUMP);
+	analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_LEAF_INLINE);
+	analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_SUCCESSOR_LIVENESS);
+	if (b->tier)
+	{
+		analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_REORDER);
+		// Branches within the block need the branch instructions to be compiled.
+		if (!Core::g_CoreStartupParameter.bJITOff && !Core::g_CoreStartupParameter.bJITBranchOff)
+		{
+			analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_COMPLEX_BLOCK);
+			analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_FORWARD_JUMP);
+			analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_LEAF_INLINE);
+		}
+		analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_SUCCESSOR_LIVENESS);
+	}
+
 	u32 nextPC = em_address;
 	// Analyze the block, collect all instructions it is made of (including inlining,
 	// if that is enabled), reorder instructions for optimal performance, and join joinable instructions.
@@ -432,6 +828,14 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBloc
 
 	PPCAnalyst::CodeOp *ops = code_buf->codebuffer;
 
+	op_cycles.resize(code_block.m_num_instructions + 1);
+	op_cycles[0] = 0;
+	for (u32 i = 0; i < code_block.m_num_instructions; i++)
+		op_cycles[i + 1] = op_cycles[i] + ops[i].opinfo->numCycles;
+	branch_targets.assign(code_block.m_num_instructions, nullptr);
+	forward_branches.clear();
+	AllocateLoopRegs(ops, code_block.m_num_instructions);
+
 	const u8 *start = AlignCode4(); // TODO: Test if this or AlignCode16 make a difference from GetCodePtr
 	b->checkedEntry = start;
 	b->runCount = 0;
@@ -449,15 +853,37 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBloc
 		ABI_CallFunction((void *)&ImHere); //Used to get a trace of the last few blocks before a crash, sometimes VERY useful
 
 	// Conditionally add profiling code.
+	// Nothing is cached in registers yet, so RAX, RCX and RDX are free here.
+	// The first tier counts its runs until the block gets promoted, which
+	// bounds what the counting costs. After that only profiling needs it.
+	bool promotable = !b->tier && jo.tieredCompilation;
+	if (promotable || Profiler::g_ProfileBlocks)
+	{
+		MOV(64, R(RCX), ImmPtr(&b->runCount));
+		ADD(32, MatR(RCX), Imm8(1));
+	}
+	else
+	{
+		// Tells the eviction policy that the block is still in use.
+		MOV(64, R(RCX), ImmPtr(&b->used));
+		MOV(8, MatR(RCX), Imm8(1));
+	}
+	if (promotable)
+	{
+		// Once the block got hot, throw it away and let the dispatcher compile
+		// it again with the optimizing tier.
+		CMP(32, MatR(RCX), Imm32(HOT_BLOCK_THRESHOLD));
+		FixupBranch notHot = J_CC(CC_NE, true);
+		MOV(32, M(&PC), Imm32(js.blockStart));
+		ABI_CallFunctionC((void *)&PromoteHotBlock, js.blockStart);
+		JMP(asm_routines.dispatcherNoCheck, true);
+		SetJumpTarget(notHot);
+	}
+
+	b->ticCounter = 0;
+	b->ticStart = 0;
+	b->ticStop = 0;
 	if (Profiler::g_ProfileBlocks) {
-		ADD(32, M(&b->runCount), Imm8(1));
-#ifdef _WIN32
-		b->ticCounter = 0;
-		b->ticStart = 0;
-		b->ticStop = 0;
-#else
-//TODO
-#endif
 		// get start tic
 		PROFILER_QUERY_PERFORMANCE_COUNTER(&b->ticStart);
 	}
@@ -474,6 +900,10 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBloc
 	js.downcountAmount = 0;
 	if (!Core::g_CoreStartupParameter.bEnableDebugging)
 		js.downcountAmount += PatchEngine::GetSpeedhackCycles(code_block.m_address);
+	// A compare merged with a branch counts one more, a branch to itself 8
+	// more, and an HLE function which replaces the code counts the block again.
+	max_downcount_amount = js.downcountAmount + op_cycles[code_block.m_num_instructions] +
+		code_block.m_num_instructions + 8 + js.st.numCycles;
 
 	js.skipnext = false;
 	js.compilerPC = nextPC;
@@ -486,20 +916,34 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBloc
 		const GekkoOPInfo *opinfo = ops[i].opinfo;
 		js.downcountAmount += opinfo->numCycles;
 
+		if (ops[i].isBranchTarget)
+		{
+			// The paths meeting here agree on the loop's registers being in their
+			// homes, and everything else in memory.
+			gpr.FlushKeeping(target_regs[i], loop_homes);
+			fpr.Flush(FLUSH_ALL);
+			for (auto it = forward_branches.begin(); it != forward_branches.end();)
+			{
+				if (it->first == i)
+				{
+					SetJumpTarget(it->second);
+					it = forward_branches.erase(it);
+				}
+				else
+				{
+					++it;
+				}
+			}
+			branch_targets[i] = GetCodePtr();
+			// A forward branch may have skipped the FPU check.
+			js.firstFPInstructionFound = false;
+		}
+
 		if (i == (code_block.m_num_instructions - 1))
 		{
 			// WARNING - cmp->branch merging will screw this up.
 			js.isLastInstruction = true;
 			js.next_inst = 0;
-			if (Profiler::g_ProfileBlocks) {
-				// CAUTION!!! push on stack regs you use, do your stuff, then pop
-				PROFILER_VPUSH;
-				// get end tic
-				PROFILER_QUERY_PERFORMANCE_COUNTER(&b->ticStop);
-				// tic counter += (end tic - start tic)
-				PROFILER_ADD_DIFF_LARGE_INTEGER(&b->ticCounter, &b->ticStop, &b->ticStart);
-				PROFILER_VPOP;
-			}
 		}
 		else
 		{
@@ -543,19 +987,25 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBloc
 		{
 			if ((opinfo->flags & FL_USE_FPU) && !js.firstFPInstructionFound)
 			{
-				gpr.Flush(FLUSH_ALL);
-				fpr.Flush(FLUSH_ALL);
-
 				//This instruction uses FPU - needs to add FP exception bailout
 				TEST(32, M(&PowerPC::ppcState.msr), Imm32(1 << 13)); // Test FP enabled bit
 				FixupBranch b1 = J_CC(CC_NZ, true);
 
+				// Only the exception needs the registers in memory, e.g. a loop
+				// keeps them where they are.
+				gpr.SaveState();
+				fpr.SaveState();
+				gpr.Flush(FLUSH_ALL);
+				fpr.Flush(FLUSH_ALL);
+
 				// If a FPU exception occurs, the exception handler will read
 				// from PC.  Update PC with the latest value in case that happens.
 				MOV(32, M(&PC), Imm32(ops[i].address));
 				OR(32, M((void *)&PowerPC::ppcState.Exceptions), Imm32(EXCEPTION_FPU_UNAVAILABLE));
 				WriteExceptionExit();
 
+				gpr.LoadState();
+				fpr.LoadState();
 				SetJumpTarget(b1);
 
 				js.firstFPInstructionFound = true;
@@ -677,8 +1127,26 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBloc
 		WriteExit(nextPC);
 	}
 
+	// Forward branches whose destination wasn't compiled, e.g. because an HLE
+	// function ended the block early, leave it instead.
+	for (auto& branch : forward_branches)
+	{
+		SetJumpTarget(branch.second);
+		// The branch put the loop's registers where the destination expects them.
+		for (int reg = 0; reg < 32; reg++)
+		{
+			if (target_regs[branch.first] & (1 << reg))
+				MOV(32, M(&PowerPC::ppcState.gpr[reg]), R(loop_homes[reg]));
+		}
+		WriteExit(ops[branch.first].address);
+	}
+	forward_branches.clear();
+
 	b->codeSize = (u32)(GetCodePtr() - normalEntry);
 	b->originalSize = code_block.m_num_instructions;
+	b->inlinedCode = code_block.m_inlined;
+	if (Profiler::g_ProfileBlocks)
+		blocks.CountInlinedFunctions(*b);
 
 #ifdef JIT_LOG_X86
 	LogGeneratedX86(code_block.m_num_instructions, code_buf, normalEntry, b);
@@ -48,8 +48,45 @@ private:
 	PPCAnalyst::CodeBuffer code_buffer;
 	Jit64AsmRoutineManager asm_routines;
 
+	// The code space is split into regions which are filled one after the
+	// other. When the current one is full, or we run out of blocks, the
+	// region whose blocks ran the least since the last eviction is evicted
+	// and compiled into next, so that hot code doesn't need to be recompiled.
+	enum
+	{
+		NUM_CODE_REGIONS = 8,
+	};
+	int code_region;
+
+	u8 *GetCodeRegionStart(int r) const { return region + r * (region_size / NUM_CODE_REGIONS); }
+	u8 *GetCodeRegionEnd(int r) const { return GetCodeRegionStart(r + 1); }
+	void EvictCodeRegion();
+
+	// Blocks are first compiled without the more expensive analysis. Once a
+	// block ran this many times it is recompiled by the optimizing tier.
+	enum
+	{
+		HOT_BLOCK_THRESHOLD = 1000,
+	};
+
+	// Branches within the block being compiled (see OPTION_COMPLEX_BLOCK and
+	// OPTION_FORWARD_JUMP).
+	std::vector<int> op_cycles;              // cycles of the instructions before each one
+	std::vector<const u8*> branch_targets;   // code of the instructions which were jumped to
+	std::vector<std::pair<u32, Gen::FixupBranch>> forward_branches; // instruction index -> pending jump
+	// The most an exit of the block subtracts from the downcount (see
+	// GPRRegCache::StoreDeadRegs).
+	int max_downcount_amount;
+	// The GPRs most used in the loops of the block stay in host registers
+	// around them: the branch targets in loops expect them in loop_homes,
+	// the other targets everything in memory.
+	u32 loop_regs;
+	Gen::X64Reg loop_homes[32];
+	std::vector<u32> target_regs;            // the GPRs each instruction expects in loop_homes if it's jumped to
+	void AllocateLoopRegs(const PPCAnalyst::CodeOp *ops, u32 num_instructions);
+
 public:
-	Jit64() : code_buffer(32000) {}
+	Jit64() : code_buffer(32000), code_region(0) {}
 	~Jit64() {}
 
 	void Init() override;
@@ -90,7 +127,14 @@ public:
 	// Utilities for use by opcodes
 
 	void WriteExit(u32 destination);
+	void WriteLinkableJump(u32 destination);
+	void WriteBranch(u32 destination, u32 branch_index);
+	// Branches within the block don't flush the registers beforehand.
+	bool IsBranchInBlock(const PPCAnalyst::CodeOp &op) const;
 	void WriteExitDestInEAX();
+	void WriteIndirectExitDestInEAX();
+	void WriteReturnExitDestInEAX();
+	void PushReturnStack(u32 return_address);
 	void WriteExceptionExit();
 	void WriteExternalExceptionExit();
 	void WriteRfiExitDestInEAX();
@@ -105,11 +149,19 @@ public:
 	void GenerateCarry();
 	void GenerateRC();
 	void ComputeRC(const Gen::OpArg & arg);
-
-	void tri_op(int d, int a, int b, bool reversible, void (XEmitter::*op)(Gen::X64Reg, Gen::OpArg));
+	void SetCRFieldFromFlags(int crf, Gen::CCFlags less_than, Gen::CCFlags greater_than);
+	// Whether the current instruction's results may be read before they're overwritten.
+	bool IsCRFieldLive(int crf) const { return !js.skipDeadResults || (js.op->crLiveAfter & (1 << crf)); }
+	bool IsCarryLive() const { return !js.skipDeadResults || js.op->caLiveAfter; }
+	void WriteMergedBranch();
+	void WriteMergedBranchFallthrough();
+
+	void tri_op(int d, int a, int b, bool reversible, void (XEmitter::*avxOp)(Gen::X64Reg, Gen::X64Reg, Gen::OpArg),
+	            void (XEmitter::*sseOp)(Gen::X64Reg, Gen::OpArg));
 	typedef u32 (*Operation)(u32 a, u32 b);
 	void regimmop(int d, int a, bool binary, u32 value, Operation doop, void (XEmitter::*op)(int, const Gen::OpArg&, const Gen::OpArg&), bool Rc = false, bool carry = false);
-	void fp_tri_op(int d, int a, int b, bool reversible, bool single, void (XEmitter::*op)(Gen::X64Reg, Gen::OpArg));
+	void fp_tri_op(int d, int a, int b, bool reversible, bool single, void (XEmitter::*avxOp)(Gen::X64Reg, Gen::X64Reg, Gen::OpArg),
+	               void (XEmitter::*sseOp)(Gen::X64Reg, Gen::OpArg));
 
 	// OPCODES
 	void unknown_instruction(UGeckoInstruction _inst);
@@ -362,6 +362,94 @@ void FPURegCache::StoreFromRegister(int i)
 	}
 }
 
+// The registers which differ from memory and aren't read after op.
+u32 GPRRegCache::GetDeadRegs(PPCAnalyst::CodeOp *op) const
+{
+	if (!jit->js.skipDeadResults)
+		return 0;
+	u32 dead = 0;
+	for (int i = 0; i < 32; i++)
+	{
+		if (!regs[i].away)
+			continue;
+		if (regs[i].location.IsSimpleReg() && !xregs[RX(i)].dirty)
+			continue;
+		if (!(op->gprLiveAfter & (1 << i)))
+			dead |= 1 << i;
+	}
+	return dead;
+}
+
+void GPRRegCache::StoreDeadRegs(PPCAnalyst::CodeOp *op, int maxDowncountAmount)
+{
+	u32 dead = GetDeadRegs(op);
+	if (!dead)
+		return;
+
+	emit->CMP(32, M(&CoreTiming::downcount), Imm32(maxDowncountAmount));
+	FixupBranch inTime = emit->J_CC(CC_G);
+	for (int i = 0; i < 32; i++)
+	{
+		if (dead & (1 << i))
+			emit->MOV(32, GetDefaultLocation(i), regs[i].location);
+	}
+	emit->SetJumpTarget(inTime);
+}
+
+void GPRRegCache::Flush(PPCAnalyst::CodeOp *op)
+{
+	u32 dead = GetDeadRegs(op);
+	for (int i = 0; i < 32; i++)
+	{
+		if (!regs[i].away)
+			continue;
+		if (regs[i].location.IsSimpleReg() && !xregs[RX(i)].dirty)
+			continue;
+
+		if (!(dead & (1 << i)))
+		{
+			jit->js.curBlock->numExitStores++;
+		}
+		else
+		{
+			// Overwritten before it's read, forget it. StoreDeadRegs took
+			// care of the exits which may take an interrupt.
+			jit->js.curBlock->numDeadStores++;
+			DiscardRegContentsIfCached(i);
+			regs[i].away = false;
+			regs[i].location = GetDefaultLocation(i);
+		}
+	}
+	Flush(FLUSH_ALL);
+}
+
+void GPRRegCache::FlushKeeping(u32 pregs, const X64Reg *homes)
+{
+	for (int i = 0; i < 32; i++)
+	{
+		bool home = (pregs & (1 << i)) && IsBound(i) && RX(i) == homes[i];
+		if (regs[i].away && !home)
+			StoreFromRegister(i);
+	}
+
+	// The homes are free now, unless they already hold their register.
+	for (int i = 0; i < 32; i++)
+	{
+		if (!(pregs & (1 << i)))
+			continue;
+		X64Reg xr = homes[i];
+		if (!regs[i].away)
+		{
+			emit->MOV(32, ::Gen::R(xr), regs[i].location);
+			xregs[xr].free = false;
+			xregs[xr].ppcReg = i;
+			regs[i].away = true;
+			regs[i].location = ::Gen::R(xr);
+		}
+		xregs[xr].dirty = true;
+	}
+}
+
 void RegCache::Flush(FlushMode mode)
 {
 	for (int i = 0; i < NUMXREGS; i++)
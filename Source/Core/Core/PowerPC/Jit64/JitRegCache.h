@@ -80,6 +80,7 @@ public:
 		LockX(reg1); LockX(reg2);
 	}
 	virtual void Flush(FlushMode mode);
+	// Flushes everything the code after op, an exit, may need.
 	virtual void Flush(PPCAnalyst::CodeOp *op) {Flush(FLUSH_ALL);}
 	int SanityCheck() const;
 	void KillImmediate(int preg, bool doLoad, bool makeDirty);
@@ -125,12 +126,28 @@ public:
 class GPRRegCache : public RegCache
 {
 public:
+	using RegCache::Flush;
 	void Start(PPCAnalyst::BlockRegStats &stats) override;
+	// Leaves out the registers which are overwritten before they're read. Call
+	// StoreDeadRegs for op first.
+	void Flush(PPCAnalyst::CodeOp *op) override;
+	// Stores the registers Flush(op) leaves out if the downcount may run out
+	// before they're written again, that is, if it is at most the most an exit
+	// of the block subtracts. An interrupt is taken then, and its handler sees
+	// them in memory. This clobbers the flags.
+	void StoreDeadRegs(PPCAnalyst::CodeOp *op, int maxDowncountAmount);
+	// Flushes everything but pregs, which are put in the host registers homes
+	// gives for them and marked dirty. Paths which meet do this with the same
+	// arguments to agree on where everything is. Only emits MOVs.
+	void FlushKeeping(u32 pregs, const X64Reg *homes);
 	void BindToRegister(int preg, bool doLoad = true, bool makeDirty = true) override;
 	void StoreFromRegister(int preg) override;
 	OpArg GetDefaultLocation(int reg) const override;
 	const int *GetAllocationOrder(int &count) override;
 	void SetImmediate32(int preg, u32 immValue);
+
+private:
+	u32 GetDeadRegs(PPCAnalyst::CodeOp *op) const;
 };
 
 
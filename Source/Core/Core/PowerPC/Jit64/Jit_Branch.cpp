@@ -64,21 +64,24 @@ void Jit64::bx(UGeckoInstruction inst)
 	if (inst.LK)
 		MOV(32, M(&LR), Imm32(js.compilerPC + 4));
 
-	// If this is not the last instruction of a block,
-	// we will skip the rest process.
-	// Because PPCAnalyst::Flatten() merged the blocks.
-	if (!js.isLastInstruction) {
-		return;
-	}
-
-	gpr.Flush(FLUSH_ALL);
-	fpr.Flush(FLUSH_ALL);
-
 	u32 destination;
 	if (inst.AA)
 		destination = SignExt26(inst.LI << 2);
 	else
 		destination = js.compilerPC + SignExt26(inst.LI << 2);
+
+	// If the analyzer followed the branch, e.g. to inline the function it
+	// calls, the destination comes next and we will skip the rest process.
+	if (!js.isLastInstruction && js.next_compilerPC == destination) {
+		return;
+	}
+
+	if (!IsBranchInBlock(*js.op))
+	{
+		gpr.StoreDeadRegs(js.op, max_downcount_amount);
+		gpr.Flush(js.op);
+		fpr.Flush(FLUSH_ALL);
+	}
 #ifdef ACID_TEST
 	if (inst.LK)
 		AND(32, M(&PowerPC::ppcState.cr), Imm32(~(0xFF000000)));
@@ -91,7 +94,9 @@ void Jit64::bx(UGeckoInstruction inst)
 		// make idle loops go faster
 		js.downcountAmount += 8;
 	}
-	WriteExit(destination);
+	if (inst.LK)
+		PushReturnStack(js.compilerPC + 4);
+	WriteBranch(destination, js.instructionNumber);
 }
 
 // TODO - optimize to hell and beyond
@@ -104,8 +109,13 @@ void Jit64::bcx(UGeckoInstruction inst)
 
 	// USES_CR
 
-	gpr.Flush(FLUSH_ALL);
-	fpr.Flush(FLUSH_ALL);
+	// Only memory is looked at before the branch is taken.
+	if (!IsBranchInBlock(*js.op))
+	{
+		gpr.StoreDeadRegs(js.op, max_downcount_amount);
+		gpr.Flush(js.op);
+		fpr.Flush(FLUSH_ALL);
+	}
 
 	FixupBranch pCTRDontBranch;
 	if ((inst.BO & BO_DONT_DECREMENT_FLAG) == 0)  // Decrement and test CTR
@@ -135,7 +145,9 @@ void Jit64::bcx(UGeckoInstruction inst)
 		destination = SignExt16(inst.BD << 2);
 	else
 		destination = js.compilerPC + SignExt16(inst.BD << 2);
-	WriteExit(destination);
+	if (inst.LK)
+		PushReturnStack(js.compilerPC + 4);
+	WriteBranch(destination, js.instructionNumber);
 
 	if ((inst.BO & BO_DONT_CHECK_CONDITION) == 0)
 		SetJumpTarget( pConditionDontBranch );
@@ -151,7 +163,8 @@ void Jit64::bcctrx(UGeckoInstruction inst)
 	INSTRUCTION_START
 	JITDISABLE(bJITBranchOff)
 
-	gpr.Flush(FLUSH_ALL);
+	gpr.StoreDeadRegs(js.op, max_downcount_amount);
+	gpr.Flush(js.op);
 	fpr.Flush(FLUSH_ALL);
 
 	// bcctrx doesn't decrement and/or test CTR
@@ -166,7 +179,9 @@ void Jit64::bcctrx(UGeckoInstruction inst)
 		if (inst.LK_3)
 			MOV(32, M(&LR), Imm32(js.compilerPC + 4)); // LR = PC + 4;
 		AND(32, R(EAX), Imm32(0xFFFFFFFC));
-		WriteExitDestInEAX();
+		if (inst.LK_3)
+			PushReturnStack(js.compilerPC + 4);
+		WriteIndirectExitDestInEAX();
 	}
 	else
 	{
@@ -188,7 +203,9 @@ void Jit64::bcctrx(UGeckoInstruction inst)
 		//MOV(32, M(&PC), R(EAX)); => Already done in WriteExitDestInEAX()
 		if (inst.LK_3)
 			MOV(32, M(&LR), Imm32(js.compilerPC + 4)); // LR = PC + 4;
-		WriteExitDestInEAX();
+		if (inst.LK_3)
+			PushReturnStack(js.compilerPC + 4);
+		WriteIndirectExitDestInEAX();
 		// Would really like to continue the block here, but it ends. TODO.
 		SetJumpTarget(b);
 
@@ -202,7 +219,8 @@ void Jit64::bclrx(UGeckoInstruction inst)
 	INSTRUCTION_START
 	JITDISABLE(bJITBranchOff)
 
-	gpr.Flush(FLUSH_ALL);
+	gpr.StoreDeadRegs(js.op, max_downcount_amount);
+	gpr.Flush(js.op);
 	fpr.Flush(FLUSH_ALL);
 
 	FixupBranch pCTRDontBranch;
@@ -234,8 +252,16 @@ void Jit64::bclrx(UGeckoInstruction inst)
 	MOV(32, R(EAX), M(&LR));
 	AND(32, R(EAX), Imm32(0xFFFFFFFC));
 	if (inst.LK)
+	{
+		// blrl is a call, not a return.
 		MOV(32, M(&LR), Imm32(js.compilerPC + 4));
-	WriteExitDestInEAX();
+		PushReturnStack(js.compilerPC + 4);
+		WriteExitDestInEAX();
+	}
+	else
+	{
+		WriteReturnExitDestInEAX();
+	}
 
 	if ((inst.BO & BO_DONT_CHECK_CONDITION) == 0)
 		SetJumpTarget( pConditionDontBranch );
@@ -11,17 +11,26 @@
 static const u64 GC_ALIGNED16(psSignBits2[2]) = {0x8000000000000000ULL, 0x8000000000000000ULL};
 static const u64 GC_ALIGNED16(psAbsMask2[2])  = {0x7FFFFFFFFFFFFFFFULL, 0x7FFFFFFFFFFFFFFFULL};
 
-void Jit64::fp_tri_op(int d, int a, int b, bool reversible, bool single, void (XEmitter::*op)(Gen::X64Reg, Gen::OpArg))
+void Jit64::fp_tri_op(int d, int a, int b, bool reversible, bool single, void (XEmitter::*avxOp)(Gen::X64Reg, Gen::X64Reg, Gen::OpArg),
+                      void (XEmitter::*sseOp)(Gen::X64Reg, Gen::OpArg))
 {
 	fpr.Lock(d, a, b);
-	if (d == a)
+	// The three operand form takes the upper half from a instead of keeping d's,
+	// which only matters for doubles.
+	if (single && cpu_info.bAVX && d != a && (d != b || !reversible))
+	{
+		fpr.BindToRegister(a, true, false);
+		fpr.BindToRegister(d, d == b);
+		(this->*avxOp)(fpr.RX(d), fpr.RX(a), fpr.R(b));
+	}
+	else if (d == a)
 	{
 		fpr.BindToRegister(d, true);
 		if (!single)
 		{
 			fpr.BindToRegister(b, true, false);
 		}
-		(this->*op)(fpr.RX(d), fpr.R(b));
+		(this->*sseOp)(fpr.RX(d), fpr.R(b));
 	}
 	else if (d == b)
 	{
@@ -32,14 +41,14 @@ void Jit64::fp_tri_op(int d, int a, int b, bool reversible, bool single, void (X
 			{
 				fpr.BindToRegister(a, true, false);
 			}
-			(this->*op)(fpr.RX(d), fpr.R(a));
+			(this->*sseOp)(fpr.RX(d), fpr.R(a));
 		}
 		else
 		{
 			MOVSD(XMM0, fpr.R(b));
 			fpr.BindToRegister(d, !single);
 			MOVSD(fpr.RX(d), fpr.R(a));
-			(this->*op)(fpr.RX(d), Gen::R(XMM0));
+			(this->*sseOp)(fpr.RX(d), Gen::R(XMM0));
 		}
 	}
 	else
@@ -51,7 +60,7 @@ void Jit64::fp_tri_op(int d, int a, int b, bool reversible, bool single, void (X
 			fpr.BindToRegister(b, true, false);
 		}
 		MOVSD(fpr.RX(d), fpr.R(a));
-		(this->*op)(fpr.RX(d), fpr.R(b));
+		(this->*sseOp)(fpr.RX(d), fpr.R(b));
 	}
 	if (single)
 	{
@@ -91,10 +100,10 @@ void Jit64::fp_arith(UGeckoInstruction inst)
 	bool single = inst.OPCD == 59;
 	switch (inst.SUBOP5)
 	{
-	case 18: fp_tri_op(inst.FD, inst.FA, inst.FB, false, single, &XEmitter::DIVSD); break; //div
-	case 20: fp_tri_op(inst.FD, inst.FA, inst.FB, false, single, &XEmitter::SUBSD); break; //sub
-	case 21: fp_tri_op(inst.FD, inst.FA, inst.FB, true,  single, &XEmitter::ADDSD); break; //add
-	case 25: fp_tri_op(inst.FD, inst.FA, inst.FC, true, single, &XEmitter::MULSD); break; //mul
+	case 18: fp_tri_op(inst.FD, inst.FA, inst.FB, false, single, &XEmitter::VDIVSD, &XEmitter::DIVSD); break; //div
+	case 20: fp_tri_op(inst.FD, inst.FA, inst.FB, false, single, &XEmitter::VSUBSD, &XEmitter::SUBSD); break; //sub
+	case 21: fp_tri_op(inst.FD, inst.FA, inst.FB, true,  single, &XEmitter::VADDSD, &XEmitter::ADDSD); break; //add
+	case 25: fp_tri_op(inst.FD, inst.FA, inst.FC, true,  single, &XEmitter::VMULSD, &XEmitter::MULSD); break; //mul
 	default:
 		_assert_msg_(DYNA_REC, 0, "fp_arith WTF!!!");
 	}
@@ -118,6 +127,14 @@ void Jit64::fmaddXX(UGeckoInstruction inst)
 		return;
 	}
 
+	// Without FMA3, only the interpreter rounds once.
+	bool fused = Core::g_CoreStartupParameter.bFusedMultiplyAdd;
+	if (fused && !cpu_info.bFMA)
+	{
+		FallBackToInterpreter(inst);
+		return;
+	}
+
 	bool single_precision = inst.OPCD == 59;
 
 	int a = inst.FA;
@@ -125,29 +142,13 @@ void Jit64::fmaddXX(UGeckoInstruction inst)
 	int c = inst.FC;
 	int d = inst.FD;
 
+	bool subtract = inst.SUBOP5 == 28 || inst.SUBOP5 == 30; //msub, nmsub
+	bool negate = inst.SUBOP5 == 30 || inst.SUBOP5 == 31; //nmsub, nmadd
+
 	fpr.Lock(a, b, c, d);
+	fpr.BindToRegister(c, true, false);
 	MOVSD(XMM0, fpr.R(a));
-	switch (inst.SUBOP5)
-	{
-	case 28: //msub
-		MULSD(XMM0, fpr.R(c));
-		SUBSD(XMM0, fpr.R(b));
-		break;
-	case 29: //madd
-		MULSD(XMM0, fpr.R(c));
-		ADDSD(XMM0, fpr.R(b));
-		break;
-	case 30: //nmsub
-		MULSD(XMM0, fpr.R(c));
-		SUBSD(XMM0, fpr.R(b));
-		PXOR(XMM0, M((void*)&psSignBits2));
-		break;
-	case 31: //nmadd
-		MULSD(XMM0, fpr.R(c));
-		ADDSD(XMM0, fpr.R(b));
-		PXOR(XMM0, M((void*)&psSignBits2));
-		break;
-	}
+	MultiplyAdd(XMM0, fpr.RX(c), fpr.R(b), subtract, negate, false, fused);
 	fpr.BindToRegister(d, false);
 	//YES it is necessary to dupe the result :(
 	//TODO : analysis - does the top reg get used? If so, dupe, if not, don't.
@@ -55,7 +55,7 @@ void Jit64::FinalizeCarryOverflow(bool oe, bool inv)
 		SetJumpTarget(carry2);
 		SetJumpTarget(exit);
 	}
-	else
+	else if (IsCarryLive())
 	{
 		// Do carry
 		FixupBranch carry1 = J_CC(inv ? CC_C : CC_NC);
@@ -95,6 +95,9 @@ void Jit64::FinalizeCarryGenerateOverflowEAX(bool oe, bool inv)
 	}
 	else
 	{
+		// Nothing else changes XER, so there's nothing to do if the carry is dead.
+		if (!IsCarryLive())
+			return;
 		// Do carry
 		FixupBranch carry1 = J_CC(inv ? CC_C : CC_NC);
 		OR(32, R(EAX), Imm32(XER_CA_MASK));
@@ -108,6 +111,8 @@ void Jit64::FinalizeCarryGenerateOverflowEAX(bool oe, bool inv)
 void Jit64::GenerateCarry()
 {
 	// USES_XER
+	if (!IsCarryLive())
+		return;
 	FixupBranch pNoCarry = J_CC(CC_NC);
 	OR(32, M(&PowerPC::ppcState.spr[SPR_XER]), Imm32(XER_CA_MASK));
 	FixupBranch pContinue = J();
@@ -119,6 +124,8 @@ void Jit64::GenerateCarry()
 // Assumes that Sign and Zero flags were set by the last operation. Preserves all flags and registers.
 void Jit64::GenerateRC()
 {
+	if (!IsCRFieldLive(0))
+		return;
 	FixupBranch pZero  = J_CC(CC_Z);
 	FixupBranch pNegative = J_CC(CC_S);
 	MOV(8, M(&PowerPC::ppcState.cr_fast[0]), Imm8(0x4)); // Result > 0
@@ -137,6 +144,8 @@ void Jit64::GenerateRC()
 
 void Jit64::ComputeRC(const Gen::OpArg & arg)
 {
+	if (!IsCRFieldLive(0))
+		return;
 	if (arg.IsImm())
 	{
 		s32 value = (s32)arg.offset;
@@ -303,6 +312,84 @@ void Jit64::reg_imm(UGeckoInstruction inst)
 	}
 }
 
+// Stores the result of the preceding CMP to a CR field, leaving the host flags
+// alone.
+void Jit64::SetCRFieldFromFlags(int crf, Gen::CCFlags less_than, Gen::CCFlags greater_than)
+{
+	FixupBranch pLesser  = J_CC(less_than);
+	FixupBranch pGreater = J_CC(greater_than);
+	MOV(8, M(&PowerPC::ppcState.cr_fast[crf]), Imm8(0x2)); // _x86Reg == 0
+	FixupBranch continue1 = J();
+	SetJumpTarget(pGreater);
+	MOV(8, M(&PowerPC::ppcState.cr_fast[crf]), Imm8(0x4)); // _x86Reg > 0
+	FixupBranch continue2 = J();
+	SetJumpTarget(pLesser);
+	MOV(8, M(&PowerPC::ppcState.cr_fast[crf]), Imm8(0x8)); // _x86Reg < 0
+	SetJumpTarget(continue1);
+	SetJumpTarget(continue2);
+	// TODO: If we ever care about SO, borrow a trick from
+	// http://maws.mameworld.info/maws/mamesrc/src/emu/cpu/powerpc/drc_ops.c : bt, adc
+}
+
+// The taken side of a conditional branch merged into the preceding compare.
+void Jit64::WriteMergedBranch()
+{
+	if (js.next_inst.OPCD == 16) // bcx
+	{
+		if (js.next_inst.LK)
+			MOV(32, M(&LR), Imm32(js.next_compilerPC + 4));
+
+		u32 destination;
+		if (js.next_inst.AA)
+			destination = SignExt16(js.next_inst.BD << 2);
+		else
+			destination = js.next_compilerPC + SignExt16(js.next_inst.BD << 2);
+		if (js.next_inst.LK)
+			PushReturnStack(js.next_compilerPC + 4);
+		WriteBranch(destination, js.instructionNumber + 1);
+	}
+	else if ((js.next_inst.OPCD == 19) && (js.next_inst.SUBOP10 == 528)) // bcctrx
+	{
+		if (js.next_inst.LK)
+			MOV(32, M(&LR), Imm32(js.next_compilerPC + 4));
+		MOV(32, R(EAX), M(&CTR));
+		AND(32, R(EAX), Imm32(0xFFFFFFFC));
+		if (js.next_inst.LK)
+			PushReturnStack(js.next_compilerPC + 4);
+		WriteIndirectExitDestInEAX();
+	}
+	else if ((js.next_inst.OPCD == 19) && (js.next_inst.SUBOP10 == 16)) // bclrx
+	{
+		MOV(32, R(EAX), M(&LR));
+		AND(32, R(EAX), Imm32(0xFFFFFFFC));
+		if (js.next_inst.LK)
+		{
+			MOV(32, M(&LR), Imm32(js.next_compilerPC + 4));
+			WriteExitDestInEAX();
+		}
+		else
+		{
+			WriteReturnExitDestInEAX();
+		}
+	}
+	else
+	{
+		PanicAlert("WTF invalid branch");
+	}
+}
+
+// The fall through side of a merged branch. Continues the block after it if
+// the analyzer allows, otherwise leaves.
+void Jit64::WriteMergedBranchFallthrough()
+{
+	js.skipnext = true;
+	// The link register is set whether the branch is taken or not.
+	if (js.next_inst.LK)
+		MOV(32, M(&LR), Imm32(js.next_compilerPC + 4));
+	if (!analyzer.HasOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE))
+		WriteExit(js.next_compilerPC + 4);
+}
+
 void Jit64::cmpXX(UGeckoInstruction inst)
 {
 	// USES_CR
@@ -321,12 +408,19 @@ void Jit64::cmpXX(UGeckoInstruction inst)
 		(js.next_inst.BO & BO_DONT_DECREMENT_FLAG) &&
 		!(js.next_inst.BO & BO_DONT_CHECK_CONDITION)) {
 			// Looks like a decent conditional branch that we can merge with.
-			// It only test CR, not CTR.
-			if (test_crf == crf) {
+			// It only test CR, not CTR. The compare never sets SO, and the
+			// branch must not be reachable by itself.
+			if (test_crf == crf && (js.next_inst.BI & 3) != 3 && !js.op[1].isBranchTarget) {
 				merge_branch = true;
 			}
 	}
 
+	// The fall through side only has to store the CR field if something reads
+	// it before it's overwritten.
+	bool store_cr_on_fallthrough = !merge_branch ||
+		!analyzer.HasOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE) ||
+		(js.op[1].crLiveAfter & (1 << crf)) || !js.skipDeadResults;
+
 	OpArg comparand;
 	bool signedCompare;
 	if (inst.OPCD == 31) {
@@ -379,61 +473,37 @@ void Jit64::cmpXX(UGeckoInstruction inst)
 			else
 				compareResult = 0x8;
 		}
-		MOV(8, M(&PowerPC::ppcState.cr_fast[crf]), Imm8(compareResult));
 		gpr.UnlockAll();
 
 		if (merge_branch)
 		{
 			js.downcountAmount++;
 
-			gpr.Flush(FLUSH_ALL);
-			fpr.Flush(FLUSH_ALL);
+			if (!IsBranchInBlock(js.op[1]))
+			{
+				gpr.StoreDeadRegs(&js.op[1], max_downcount_amount);
+				gpr.Flush(&js.op[1]);
+				fpr.Flush(FLUSH_ALL);
+			}
 
 			int test_bit = 8 >> (js.next_inst.BI & 3);
 			u8 conditionResult = (js.next_inst.BO & BO_BRANCH_IF_TRUE) ? test_bit : 0;
 			if ((compareResult & test_bit) == conditionResult)
 			{
-				if (js.next_inst.OPCD == 16) // bcx
-				{
-					if (js.next_inst.LK)
-						MOV(32, M(&LR), Imm32(js.compilerPC + 4));
-
-					u32 destination;
-					if (js.next_inst.AA)
-						destination = SignExt16(js.next_inst.BD << 2);
-					else
-						destination = js.next_compilerPC + SignExt16(js.next_inst.BD << 2);
-					WriteExit(destination);
-				}
-				else if ((js.next_inst.OPCD == 19) && (js.next_inst.SUBOP10 == 528)) // bcctrx
-				{
-					if (js.next_inst.LK)
-						MOV(32, M(&LR), Imm32(js.compilerPC + 4));
-					MOV(32, R(EAX), M(&CTR));
-					AND(32, R(EAX), Imm32(0xFFFFFFFC));
-					WriteExitDestInEAX();
-				}
-				else if ((js.next_inst.OPCD == 19) && (js.next_inst.SUBOP10 == 16)) // bclrx
-				{
-					MOV(32, R(EAX), M(&LR));
-					if (js.next_inst.LK)
-						MOV(32, M(&LR), Imm32(js.compilerPC + 4));
-					WriteExitDestInEAX();
-				}
-				else
-				{
-					PanicAlert("WTF invalid branch");
-				}
+				MOV(8, M(&PowerPC::ppcState.cr_fast[crf]), Imm8(compareResult));
+				WriteMergedBranch();
 			}
 			else
 			{
-				if (!analyzer.HasOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE))
-				{
-					js.skipnext = true;
-					WriteExit(js.next_compilerPC + 4);
-				}
+				if (store_cr_on_fallthrough)
+					MOV(8, M(&PowerPC::ppcState.cr_fast[crf]), Imm8(compareResult));
+				WriteMergedBranchFallthrough();
 			}
 		}
+		else
+		{
+			MOV(8, M(&PowerPC::ppcState.cr_fast[crf]), Imm8(compareResult));
+		}
 	}
 	else
 	{
@@ -454,96 +524,47 @@ void Jit64::cmpXX(UGeckoInstruction inst)
 			// Syntax for CMP is invalid with such arguments. We must load RA in a register.
 			gpr.BindToRegister(a, true, false);
 		}
+		// Ahead of the compare, whose flags the branch uses.
+		if (merge_branch && !IsBranchInBlock(js.op[1]))
+			gpr.StoreDeadRegs(&js.op[1], max_downcount_amount);
 		CMP(32, gpr.R(a), comparand);
 		gpr.UnlockAll();
 
 		if (!merge_branch)
 		{
-			// Keep the normal code separate for clarity.
-
-			FixupBranch pLesser  = J_CC(less_than);
-			FixupBranch pGreater = J_CC(greater_than);
-			MOV(8, M(&PowerPC::ppcState.cr_fast[crf]), Imm8(0x2)); // _x86Reg == 0
-			FixupBranch continue1 = J();
-			SetJumpTarget(pGreater);
-			MOV(8, M(&PowerPC::ppcState.cr_fast[crf]), Imm8(0x4)); // _x86Reg > 0
-			FixupBranch continue2 = J();
-			SetJumpTarget(pLesser);
-			MOV(8, M(&PowerPC::ppcState.cr_fast[crf]), Imm8(0x8)); // _x86Reg < 0
-			SetJumpTarget(continue1);
-			SetJumpTarget(continue2);
-			// TODO: If we ever care about SO, borrow a trick from
-			// http://maws.mameworld.info/maws/mamesrc/src/emu/cpu/powerpc/drc_ops.c : bt, adc
+			SetCRFieldFromFlags(crf, less_than, greater_than);
 		}
 		else
 		{
 			js.downcountAmount++;
-			int test_bit = 8 >> (js.next_inst.BI & 3);
-			bool condition = (js.next_inst.BO & BO_BRANCH_IF_TRUE) ? false : true;
-
-			// Test swapping (in the future, will be used to inline across branches the right way)
-			// if (rand() & 1)
-			//     std::swap(destination1, destination2), condition = !condition;
-
-			gpr.Flush(FLUSH_ALL);
-			fpr.Flush(FLUSH_ALL);
-			FixupBranch pLesser  = J_CC(less_than);
-			FixupBranch pGreater = J_CC(greater_than);
-			MOV(8, M(&PowerPC::ppcState.cr_fast[crf]), Imm8(0x2));  //  == 0
-			FixupBranch continue1 = J();
-
-			SetJumpTarget(pGreater);
-			MOV(8, M(&PowerPC::ppcState.cr_fast[crf]), Imm8(0x4));  //  > 0
-			FixupBranch continue2 = J();
-
-			SetJumpTarget(pLesser);
-			MOV(8, M(&PowerPC::ppcState.cr_fast[crf]), Imm8(0x8));  //  < 0
-			FixupBranch continue3;
-			if (!!(8 & test_bit) == condition) continue3 = J();
-			if (!!(4 & test_bit) != condition) SetJumpTarget(continue2);
-			if (!!(2 & test_bit) != condition) SetJumpTarget(continue1);
-			if (js.next_inst.OPCD == 16) // bcx
-			{
-				if (js.next_inst.LK)
-					MOV(32, M(&LR), Imm32(js.compilerPC + 4));
 
-				u32 destination;
-				if (js.next_inst.AA)
-					destination = SignExt16(js.next_inst.BD << 2);
-				else
-					destination = js.next_compilerPC + SignExt16(js.next_inst.BD << 2);
-				WriteExit(destination);
-			}
-			else if ((js.next_inst.OPCD == 19) && (js.next_inst.SUBOP10 == 528)) // bcctrx
+			// Flushing is only MOVs, the flags survive.
+			if (!IsBranchInBlock(js.op[1]))
 			{
-				if (js.next_inst.LK)
-					MOV(32, M(&LR), Imm32(js.compilerPC + 4));
-				MOV(32, R(EAX), M(&CTR));
-				AND(32, R(EAX), Imm32(0xFFFFFFFC));
-				WriteExitDestInEAX();
+				gpr.Flush(&js.op[1]);
+				fpr.Flush(FLUSH_ALL);
 			}
-			else if ((js.next_inst.OPCD == 19) && (js.next_inst.SUBOP10 == 16)) // bclrx
-			{
-				MOV(32, R(EAX), M(&LR));
-				AND(32, R(EAX), Imm32(0xFFFFFFFC));
-				if (js.next_inst.LK)
-					MOV(32, M(&LR), Imm32(js.compilerPC + 4));
-				WriteExitDestInEAX();
-			}
-			else
+
+			// Branch on the host flags directly rather than on the stored field.
+			Gen::CCFlags taken;
+			switch (js.next_inst.BI & 3)
 			{
-				PanicAlert("WTF invalid branch");
+			case 0: taken = less_than; break;
+			case 1: taken = greater_than; break;
+			default: taken = CC_E; break;
 			}
+			if (!(js.next_inst.BO & BO_BRANCH_IF_TRUE))
+				taken = (Gen::CCFlags)(taken ^ 1);
 
-			if (!!(8 & test_bit) == condition) SetJumpTarget(continue3);
-			if (!!(4 & test_bit) == condition) SetJumpTarget(continue2);
-			if (!!(2 & test_bit) == condition) SetJumpTarget(continue1);
+			FixupBranch not_taken = J_CC((Gen::CCFlags)(taken ^ 1), true);
+			// Leaving the block, whoever runs next may want the field.
+			SetCRFieldFromFlags(crf, less_than, greater_than);
+			WriteMergedBranch();
 
-			if (!analyzer.HasOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE))
-			{
-				js.skipnext = true;
-				WriteExit(js.next_compilerPC + 4);
-			}
+			SetJumpTarget(not_taken);
+			if (store_cr_on_fallthrough)
+				SetCRFieldFromFlags(crf, less_than, greater_than);
+			WriteMergedBranchFallthrough();
 		}
 	}
 
@@ -2097,7 +2118,9 @@ void Jit64::srawix(UGeckoInstruction inst)
 	{
 		gpr.Lock(a, s);
 		gpr.BindToRegister(a, a == s, true);
-		JitClearCA();
+		bool carry = IsCarryLive();
+		if (carry)
+			JitClearCA();
 		MOV(32, R(EAX), gpr.R(s));
 		if (a != s)
 		{
@@ -2108,11 +2131,14 @@ void Jit64::srawix(UGeckoInstruction inst)
 		{
 			GenerateRC();
 		}
-		SHL(32, R(EAX), Imm8(32-amount));
-		TEST(32, R(EAX), gpr.R(a));
-		FixupBranch nocarry = J_CC(CC_Z);
-		JitSetCA();
-		SetJumpTarget(nocarry);
+		if (carry)
+		{
+			SHL(32, R(EAX), Imm8(32-amount));
+			TEST(32, R(EAX), gpr.R(a));
+			FixupBranch nocarry = J_CC(CC_Z);
+			JitSetCA();
+			SetJumpTarget(nocarry);
+		}
 		gpr.UnlockAll();
 	}
 	else
@@ -7,6 +7,7 @@
 
 #include "Common/Common.h"
 
+#include "Core/HW/MMIO.h"
 #include "Core/PowerPC/Jit64/Jit.h"
 #include "Core/PowerPC/Jit64/JitAsm.h"
 #include "Core/PowerPC/Jit64/JitRegCache.h"
@@ -38,6 +39,7 @@ void Jit64::lXXx(UGeckoInstruction inst)
 	// Determine memory access size and sign extend
 	int accessSize = 0;
 	bool signExtend = false;
+	bool byteReverse = false;
 	switch (inst.OPCD)
 	{
 	case 32: /* lwz */
@@ -90,6 +92,16 @@ void Jit64::lXXx(UGeckoInstruction inst)
 			signExtend = true;
 			break;
 
+		case 534: /* lwbrx */
+			accessSize = 32;
+			byteReverse = true;
+			break;
+
+		case 790: /* lhbrx */
+			accessSize = 16;
+			byteReverse = true;
+			break;
+
 		default:
 			PanicAlert("Invalid instruction");
 		}
@@ -99,50 +111,6 @@ void Jit64::lXXx(UGeckoInstruction inst)
 		PanicAlert("Invalid instruction");
 	}
 
-	// TODO(ector): Make it dynamically enable/disable idle skipping where appropriate
-	// Will give nice boost to dual core mode
-	// (mb2): I agree,
-	// IMHO those Idles should always be skipped and replaced by a more controllable "native" Idle methode
-	// ... maybe the throttle one already do that :p
-	// if (CommandProcessor::AllowIdleSkipping() && PixelEngine::AllowIdleSkipping())
-	if (SConfig::GetInstance().m_LocalCoreStartupParameter.bSkipIdle &&
-		inst.OPCD == 32 &&
-		(inst.hex & 0xFFFF0000) == 0x800D0000 &&
-		(Memory::ReadUnchecked_U32(js.compilerPC + 4) == 0x28000000 ||
-		(SConfig::GetInstance().m_LocalCoreStartupParameter.bWii && Memory::ReadUnchecked_U32(js.compilerPC + 4) == 0x2C000000)) &&
-		Memory::ReadUnchecked_U32(js.compilerPC + 8) == 0x4182fff8)
-	{
-		// TODO(LinesPrower):
-		// - Rewrite this!
-		// It seems to be ugly and inefficient, but I don't know JIT stuff enough to make it right
-		// It only demonstrates the idea
-
-		// do our job at first
-		s32 offset = (s32)(s16)inst.SIMM_16;
-		gpr.BindToRegister(d, false, true);
-		SafeLoadToReg(gpr.RX(d), gpr.R(a), accessSize, offset, RegistersInUse(), signExtend);
-
-		// if it's still 0, we can wait until the next event
-		TEST(32, gpr.R(d), gpr.R(d));
-		FixupBranch noIdle = J_CC(CC_NZ);
-
-		u32 registersInUse = RegistersInUse();
-		ABI_PushRegistersAndAdjustStack(registersInUse, false);
-
-		ABI_CallFunctionC((void *)&PowerPC::OnIdle, PowerPC::ppcState.gpr[a] + (s32)(s16)inst.SIMM_16);
-
-		ABI_PopRegistersAndAdjustStack(registersInUse, false);
-
-		// ! we must continue executing of the loop after exception handling, maybe there is still 0 in r0
-		//MOV(32, M(&PowerPC::ppcState.pc), Imm32(js.compilerPC));
-		WriteExceptionExit();
-
-		SetJumpTarget(noIdle);
-
-		//js.compilerPC += 8;
-		return;
-	}
-
 	// Determine whether this instruction updates inst.RA
 	bool update;
 	if (inst.OPCD == 31)
@@ -211,6 +179,18 @@ void Jit64::lXXx(UGeckoInstruction inst)
 	gpr.BindToRegister(d, js.memcheck, true);
 	SafeLoadToReg(gpr.RX(d), opAddress, accessSize, 0, RegistersInUse(), signExtend);
 
+	if (byteReverse)
+	{
+		MEMCHECK_START
+
+		// The loaded value is already swapped to host order, swap it back.
+		BSWAP(32, gpr.RX(d));
+		if (accessSize == 16)
+			SHR(32, gpr.R(d), Imm8(16));
+
+		MEMCHECK_END
+	}
+
 	if (update && js.memcheck && !zeroOffset)
 	{
 		gpr.BindToRegister(a, true, true);
@@ -319,6 +299,17 @@ void Jit64::stX(UGeckoInstruction inst)
 					gpr.SetImmediate32(a, addr);
 				return;
 			}
+			else if (!Core::g_CoreStartupParameter.bMMU && MMIO::IsMMIOAddress(addr))
+			{
+				MOV(32, M(&PC), Imm32(jit->js.compilerPC)); // Helps external systems know which instruction triggered the write
+				gpr.FlushLockX(ECX);
+				MOV(32, R(ECX), gpr.R(s));
+				MMIOWriteRegToAddr(Memory::mmio_mapping, ECX, RegistersInUse(), addr, accessSize);
+				if (update)
+					gpr.SetImmediate32(a, addr);
+				gpr.UnlockAllX();
+				return;
+			}
 			else
 			{
 				MOV(32, M(&PC), Imm32(jit->js.compilerPC)); // Helps external systems know which instruction triggered the write
@@ -426,16 +417,19 @@ void Jit64::stXx(UGeckoInstruction inst)
 		ADD(32, R(EDX), gpr.R(b));
 	}
 	int accessSize;
+	bool byteReverse = false;
 	switch (inst.SUBOP10 & ~32) {
 		case 151: accessSize = 32; break;
 		case 407: accessSize = 16; break;
 		case 215: accessSize = 8; break;
+		case 662: accessSize = 32; byteReverse = true; break; // stwbrx
+		case 918: accessSize = 16; byteReverse = true; break; // sthbrx
 		default: PanicAlert("stXx: invalid access size");
 			accessSize = 0; break;
 	}
 
 	MOV(32, R(ECX), gpr.R(s));
-	SafeWriteRegToReg(ECX, EDX, accessSize, 0, RegistersInUse());
+	SafeWriteRegToReg(ECX, EDX, accessSize, 0, RegistersInUse(), byteReverse ? SAFE_LOADSTORE_NO_SWAP : 0);
 
 	gpr.UnlockAll();
 	gpr.UnlockAllX();
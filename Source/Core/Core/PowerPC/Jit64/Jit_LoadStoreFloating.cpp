@@ -67,18 +67,37 @@ void Jit64::lfd(UGeckoInstruction inst)
 		return;
 	}
 
+	// lfdx and lfdux add rB instead of the immediate offset.
+	bool indexed = inst.OPCD == 31;
+	bool update = indexed && (inst.SUBOP10 & 32);
 	int d = inst.RD;
 	int a = inst.RA;
-	if (!a)
+	int b = inst.RB;
+	if (!a && !indexed)
 	{
 		FallBackToInterpreter(inst);
 		return;
 	}
 
-	s32 offset = (s32)(s16)inst.SIMM_16;
+	s32 offset = indexed ? 0 : (s32)(s16)inst.SIMM_16;
 	gpr.FlushLockX(ABI_PARAM1);
-	gpr.Lock(a);
-	MOV(32, R(ABI_PARAM1), gpr.R(a));
+	if (indexed)
+	{
+		gpr.Lock(a, b);
+		MOV(32, R(ABI_PARAM1), gpr.R(b));
+		if (a)
+			ADD(32, R(ABI_PARAM1), gpr.R(a));
+		if (update)
+		{
+			gpr.BindToRegister(a, true, true);
+			MOV(32, gpr.R(a), R(ABI_PARAM1));
+		}
+	}
+	else
+	{
+		gpr.Lock(a);
+		MOV(32, R(ABI_PARAM1), gpr.R(a));
+	}
 	// TODO - optimize. This has to load the previous value - upper double should stay unmodified.
 	fpr.Lock(d);
 	fpr.BindToRegister(d, true);
@@ -140,9 +159,13 @@ void Jit64::stfd(UGeckoInstruction inst)
 		return;
 	}
 
+	// stfdx and stfdux add rB instead of the immediate offset.
+	bool indexed = inst.OPCD == 31;
+	bool update = indexed && (inst.SUBOP10 & 32);
 	int s = inst.RS;
 	int a = inst.RA;
-	if (!a)
+	int b = inst.RB;
+	if (!a && !indexed)
 	{
 		FallBackToInterpreter(inst);
 		return;
@@ -161,12 +184,29 @@ void Jit64::stfd(UGeckoInstruction inst)
 #endif
 
 	gpr.FlushLockX(ABI_PARAM1);
-	gpr.Lock(a);
+	if (indexed)
+		gpr.Lock(a, b);
+	else
+		gpr.Lock(a);
 	fpr.Lock(s);
-	gpr.BindToRegister(a, true, false);
 
 	s32 offset = (s32)(s16)inst.SIMM_16;
-	LEA(32, ABI_PARAM1, MDisp(gpr.R(a).GetSimpleReg(), offset));
+	// The address is needed again by the slow path.
+	auto computeAddress = [&]() {
+		if (indexed)
+		{
+			MOV(32, R(ABI_PARAM1), gpr.R(b));
+			if (a)
+				ADD(32, R(ABI_PARAM1), gpr.R(a));
+		}
+		else
+		{
+			LEA(32, ABI_PARAM1, MDisp(gpr.R(a).GetSimpleReg(), offset));
+		}
+	};
+	if (!indexed)
+		gpr.BindToRegister(a, true, false);
+	computeAddress();
 	TEST(32, R(ABI_PARAM1), Imm32(mem_mask));
 	FixupBranch safe = J_CC(CC_NZ);
 
@@ -200,11 +240,18 @@ void Jit64::stfd(UGeckoInstruction inst)
 
 	MOVAPD(XMM0, fpr.R(s));
 	MOVD_xmm(R(EAX), XMM0);
-	LEA(32, ABI_PARAM1, MDisp(gpr.R(a).GetSimpleReg(), offset));
+	computeAddress();
 	SafeWriteRegToReg(EAX, ABI_PARAM1, 32, 4, RegistersInUse());
 
 	SetJumpTarget(exit);
 
+	if (update)
+	{
+		computeAddress();
+		gpr.BindToRegister(a, true, true);
+		MOV(32, gpr.R(a), R(ABI_PARAM1));
+	}
+
 	gpr.UnlockAll();
 	gpr.UnlockAllX();
 	fpr.UnlockAll();
@@ -286,19 +333,41 @@ void Jit64::stfsx(UGeckoInstruction inst)
 	INSTRUCTION_START
 	JITDISABLE(bJITLoadStoreFloatingOff)
 
+	// Also stfsux, and stfiwx which stores the low word of the double as is.
+	bool update = (inst.SUBOP10 & 32) != 0;
+	if (update && js.memcheck)
+	{
+		FallBackToInterpreter(inst);
+		return;
+	}
+
 	// We can take a shortcut here - it's not likely that a hardware access would use this instruction.
 	gpr.FlushLockX(ABI_PARAM1);
+	gpr.Lock(inst.RA, inst.RB);
 	MOV(32, R(ABI_PARAM1), gpr.R(inst.RB));
 	if (inst.RA)
 		ADD(32, R(ABI_PARAM1), gpr.R(inst.RA));
+	if (update)
+	{
+		gpr.BindToRegister(inst.RA, true, true);
+		MOV(32, gpr.R(inst.RA), R(ABI_PARAM1));
+	}
 
 	int s = inst.RS;
 	fpr.Lock(s);
 	fpr.BindToRegister(s, true, false);
-	ConvertDoubleToSingle(XMM0, fpr.RX(s));
-	MOVD_xmm(R(EAX), XMM0);
+	if (inst.SUBOP10 == 983)
+	{
+		MOVD_xmm(R(EAX), fpr.RX(s));
+	}
+	else
+	{
+		ConvertDoubleToSingle(XMM0, fpr.RX(s));
+		MOVD_xmm(R(EAX), XMM0);
+	}
 	SafeWriteRegToReg(EAX, ABI_PARAM1, 32, 0, RegistersInUse());
 
+	gpr.UnlockAll();
 	gpr.UnlockAllX();
 	fpr.UnlockAll();
 }
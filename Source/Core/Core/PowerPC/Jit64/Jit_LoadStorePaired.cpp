@@ -12,6 +12,19 @@
 #include "Core/PowerPC/Jit64/JitAsm.h"
 #include "Core/PowerPC/Jit64/JitRegCache.h"
 
+namespace {
+
+const u8 GC_ALIGNED16(pbswapShuffle1x4[16]) = {3, 2, 1, 0, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+const u8 GC_ALIGNED16(pbswapShuffle2x4[16]) = {3, 2, 1, 0, 7, 6, 5, 4, 8, 9, 10, 11, 12, 13, 14, 15};
+
+const float GC_ALIGNED16(m_one[]) = {1.0f, 0.0f, 0.0f, 0.0f};
+
+}
+
+// Games set up their GQRs once and hardly ever change them, so the quantized
+// loads and stores are compiled for the GQR value at compile time. The code
+// checks that it didn't change, and goes through the generic path otherwise.
+//
 // The big problem is likely instructions that set the quantizers in the same block.
 // We will have to break block after quantizers are written to.
 void Jit64::psq_st(UGeckoInstruction inst)
@@ -25,30 +38,66 @@ void Jit64::psq_st(UGeckoInstruction inst)
 		return;
 	}
 
-	if (!inst.RA)
+	// psq_stx and psq_stux take the address from rA + rB, and the GQR and W
+	// fields from elsewhere.
+	bool indexed = inst.OPCD == 4;
+	bool update = indexed ? (inst.SUBOP10 & 32) != 0 : inst.OPCD == 61;
+
+	if (!inst.RA && (update || !indexed))
 	{
 		// TODO: Support these cases if it becomes necessary.
 		FallBackToInterpreter(inst);
 		return;
 	}
 
-	bool update = inst.OPCD == 61;
-
-	int offset = inst.SIMM_12;
+	int offset = indexed ? 0 : inst.SIMM_12;
 	int a = inst.RA;
 	int s = inst.RS; // Fp numbers
+	int i = indexed ? inst.Ix : inst.I;
+	int w = indexed ? inst.Wx : inst.W;
 
 	gpr.FlushLockX(EAX, EDX);
 	gpr.FlushLockX(ECX);
 	if (update)
 		gpr.BindToRegister(inst.RA, true, true);
 	fpr.BindToRegister(inst.RS, true, false);
-	MOV(32, R(ECX), gpr.R(inst.RA));
-	if (offset)
-		ADD(32, R(ECX), Imm32((u32)offset));
-	if (update && offset)
+	if (indexed)
+	{
+		MOV(32, R(ECX), gpr.R(inst.RB));
+		if (a)
+			ADD(32, R(ECX), gpr.R(a));
+	}
+	else
+	{
+		MOV(32, R(ECX), gpr.R(inst.RA));
+		if (offset)
+			ADD(32, R(ECX), Imm32((u32)offset));
+	}
+	if (update && (offset || indexed))
 		MOV(32, gpr.R(a), R(ECX));
-	MOVZX(32, 16, EAX, M(&PowerPC::ppcState.spr[SPR_GQR0 + inst.I]));
+
+	u32 gqrValue = GQR(i);
+	int type = gqrValue & 7;
+	if (w)
+	{
+		PXOR(XMM0, R(XMM0));  // TODO: See if we can get rid of this cheaply by tweaking the code in the singleStore* functions.
+		CVTSD2SS(XMM0, fpr.R(s));
+	}
+	else
+	{
+		CVTPD2PS(XMM0, fpr.R(s));
+	}
+	CMP(32, M(&GQR(i)), Imm32(gqrValue));
+	FixupBranch slow = J_CC(CC_NE, true);
+	MOV(32, R(EAX), Imm32(gqrValue & 0xFFFF));
+	if (w)
+		CALL((void *)asm_routines.singleStoreQuantized[type]);
+	else
+		CALL((void *)asm_routines.pairedStoreQuantized[type]);
+	FixupBranch done = J(true);
+
+	SetJumpTarget(slow);
+	MOVZX(32, 16, EAX, M(&GQR(i)));
 	MOVZX(32, 8, EDX, R(AL));
 	// FIXME: Fix ModR/M encoding to allow [EDX*4+disp32] without a base register!
 #if _M_X86_32
@@ -56,16 +105,14 @@ void Jit64::psq_st(UGeckoInstruction inst)
 #else
 	int addr_scale = SCALE_8;
 #endif
-	if (inst.W) {
+	if (w) {
 		// One value
-		PXOR(XMM0, R(XMM0));  // TODO: See if we can get rid of this cheaply by tweaking the code in the singleStore* functions.
-		CVTSD2SS(XMM0, fpr.R(s));
 		CALLptr(MScaled(EDX, addr_scale, (u32)(u64)asm_routines.singleStoreQuantized));
 	} else {
 		// Pair of values
-		CVTPD2PS(XMM0, fpr.R(s));
 		CALLptr(MScaled(EDX, addr_scale, (u32)(u64)asm_routines.pairedStoreQuantized));
 	}
+	SetJumpTarget(done);
 	gpr.UnlockAll();
 	gpr.UnlockAllX();
 }
@@ -81,28 +128,78 @@ void Jit64::psq_l(UGeckoInstruction inst)
 		return;
 	}
 
-	if (!inst.RA)
+	bool indexed = inst.OPCD == 4;
+	bool update = indexed ? (inst.SUBOP10 & 32) != 0 : inst.OPCD == 57;
+
+	if (!inst.RA && (update || !indexed))
 	{
 		FallBackToInterpreter(inst);
 		return;
 	}
 
-	bool update = inst.OPCD == 57;
-	int offset = inst.SIMM_12;
+	int offset = indexed ? 0 : inst.SIMM_12;
+	int i = indexed ? inst.Ix : inst.I;
+	int w = indexed ? inst.Wx : inst.W;
 
 	gpr.FlushLockX(EAX, EDX);
 	gpr.FlushLockX(ECX);
-	gpr.BindToRegister(inst.RA, true, update && offset);
 	fpr.BindToRegister(inst.RS, false, true);
-	if (offset)
-		LEA(32, ECX, MDisp(gpr.RX(inst.RA), offset));
+	if (indexed)
+	{
+		gpr.Lock(inst.RA, inst.RB);
+		if (update)
+			gpr.BindToRegister(inst.RA, true, true);
+		MOV(32, R(ECX), gpr.R(inst.RB));
+		if (inst.RA)
+			ADD(32, R(ECX), gpr.R(inst.RA));
+		if (update)
+			MOV(32, gpr.R(inst.RA), R(ECX));
+	}
 	else
-		MOV(32, R(ECX), gpr.R(inst.RA));
-	if (update && offset)
-		MOV(32, gpr.R(inst.RA), R(ECX));
-	MOVZX(32, 16, EAX, M(((char *)&GQR(inst.I)) + 2));
+	{
+		gpr.BindToRegister(inst.RA, true, update && offset);
+		if (offset)
+			LEA(32, ECX, MDisp(gpr.RX(inst.RA), offset));
+		else
+			MOV(32, R(ECX), gpr.R(inst.RA));
+		if (update && offset)
+			MOV(32, gpr.R(inst.RA), R(ECX));
+	}
+
+	u32 gqrValue = GQR(i);
+	int type = (gqrValue >> 16) & 7;
+	CMP(32, M(&GQR(i)), Imm32(gqrValue));
+	FixupBranch slow = J_CC(CC_NE, true);
+#if _M_X86_64
+	if (type == QUANTIZE_FLOAT && cpu_info.bSSSE3)
+	{
+		// Same as the loadPairedFloat routines.
+		if (w)
+		{
+			MOVD_xmm(XMM0, MComplex(RBX, RCX, SCALE_1, 0));
+			PSHUFB(XMM0, M((void *)pbswapShuffle1x4));
+			UNPCKLPS(XMM0, M((void *)m_one));
+		}
+		else
+		{
+			MOVQ_xmm(XMM0, MComplex(RBX, RCX, SCALE_1, 0));
+			PSHUFB(XMM0, M((void *)pbswapShuffle2x4));
+		}
+	}
+	else
+#endif
+	{
+		MOV(32, R(EAX), Imm32(gqrValue >> 16));
+		ABI_AlignStack(0);
+		CALL((void *)asm_routines.pairedLoadQuantized[type + (w ? 8 : 0)]);
+		ABI_RestoreStack(0);
+	}
+	FixupBranch done = J(true);
+
+	SetJumpTarget(slow);
+	MOVZX(32, 16, EAX, M(((char *)&GQR(i)) + 2));
 	MOVZX(32, 8, EDX, R(AL));
-	if (inst.W)
+	if (w)
 		OR(32, R(EDX), Imm8(8));
 #if _M_X86_32
 	int addr_scale = SCALE_4;
@@ -112,6 +209,7 @@ void Jit64::psq_l(UGeckoInstruction inst)
 	ABI_AlignStack(0);
 	CALLptr(MScaled(EDX, addr_scale, (u32)(u64)asm_routines.pairedLoadQuantized));
 	ABI_RestoreStack(0);
+	SetJumpTarget(done);
 
 	// MEMCHECK_START // FIXME: MMU does not work here because of unsafe memory access
 
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include "Common/Common.h"
+#include "Common/CPUDetect.h"
 
 #include "Core/PowerPC/Jit64/Jit.h"
 #include "Core/PowerPC/Jit64/JitRegCache.h"
@@ -39,8 +40,8 @@ void Jit64::ps_mr(UGeckoInstruction inst)
 
 void Jit64::ps_sel(UGeckoInstruction inst)
 {
-	// we can't use (V)BLENDVPD here because it just looks at the sign bit
-	// but we need -0 = +0
+	// we can't use (V)BLENDVPD on a directly because it just looks at the sign bit
+	// but we need -0 = +0, so build a compare mask first
 
 	INSTRUCTION_START
 	JITDISABLE(bJITPairedOff)
@@ -61,6 +62,14 @@ void Jit64::ps_sel(UGeckoInstruction inst)
 	PXOR(XMM1, R(XMM1));
 	// XMM0 = XMM0 < 0 ? all 1s : all 0s
 	CMPPD(XMM0, R(XMM1), LT);
+	if (cpu_info.bAVX)
+	{
+		fpr.BindToRegister(c, true, false);
+		fpr.BindToRegister(d, d == b || d == c);
+		VBLENDVPD(fpr.RX(d), fpr.RX(c), fpr.R(b), XMM0);
+		fpr.UnlockAll();
+		return;
+	}
 	MOVAPD(XMM1, R(XMM0));
 	PAND(XMM0, fpr.R(b));
 	PANDN(XMM1, fpr.R(c));
@@ -126,36 +135,41 @@ add a,b,a
 */
 
 //There's still a little bit more optimization that can be squeezed out of this
-void Jit64::tri_op(int d, int a, int b, bool reversible, void (XEmitter::*op)(X64Reg, OpArg))
+void Jit64::tri_op(int d, int a, int b, bool reversible, void (XEmitter::*avxOp)(X64Reg, X64Reg, OpArg),
+                   void (XEmitter::*sseOp)(X64Reg, OpArg))
 {
 	fpr.Lock(d, a, b);
 
 	if (d == a)
 	{
 		fpr.BindToRegister(d, true);
-		(this->*op)(fpr.RX(d), fpr.R(b));
+		(this->*sseOp)(fpr.RX(d), fpr.R(b));
+	}
+	else if (d == b && reversible)
+	{
+		fpr.BindToRegister(d, true);
+		(this->*sseOp)(fpr.RX(d), fpr.R(a));
+	}
+	else if (cpu_info.bAVX)
+	{
+		// No copies needed with the three operand form.
+		fpr.BindToRegister(a, true, false);
+		fpr.BindToRegister(d, d == b);
+		(this->*avxOp)(fpr.RX(d), fpr.RX(a), fpr.R(b));
 	}
 	else if (d == b)
 	{
-		if (reversible)
-		{
-			fpr.BindToRegister(d, true);
-			(this->*op)(fpr.RX(d), fpr.R(a));
-		}
-		else
-		{
-			MOVAPD(XMM0, fpr.R(b));
-			fpr.BindToRegister(d, false);
-			MOVAPD(fpr.RX(d), fpr.R(a));
-			(this->*op)(fpr.RX(d), Gen::R(XMM0));
-		}
+		MOVAPD(XMM0, fpr.R(b));
+		fpr.BindToRegister(d, false);
+		MOVAPD(fpr.RX(d), fpr.R(a));
+		(this->*sseOp)(fpr.RX(d), Gen::R(XMM0));
 	}
 	else
 	{
 		//sources different from d, can use rather quick solution
 		fpr.BindToRegister(d, false);
 		MOVAPD(fpr.RX(d), fpr.R(a));
-		(this->*op)(fpr.RX(d), fpr.R(b));
+		(this->*sseOp)(fpr.RX(d), fpr.R(b));
 	}
 	ForceSinglePrecisionP(fpr.RX(d));
 	fpr.UnlockAll();
@@ -174,10 +188,10 @@ void Jit64::ps_arith(UGeckoInstruction inst)
 
 	switch (inst.SUBOP5)
 	{
-	case 18: tri_op(inst.FD, inst.FA, inst.FB, false, &XEmitter::DIVPD); break; //div
-	case 20: tri_op(inst.FD, inst.FA, inst.FB, false, &XEmitter::SUBPD); break; //sub
-	case 21: tri_op(inst.FD, inst.FA, inst.FB, true,  &XEmitter::ADDPD); break; //add
-	case 25: tri_op(inst.FD, inst.FA, inst.FC, true, &XEmitter::MULPD); break; //mul
+	case 18: tri_op(inst.FD, inst.FA, inst.FB, false, &XEmitter::VDIVPD, &XEmitter::DIVPD); break; //div
+	case 20: tri_op(inst.FD, inst.FA, inst.FB, false, &XEmitter::VSUBPD, &XEmitter::SUBPD); break; //sub
+	case 21: tri_op(inst.FD, inst.FA, inst.FB, true,  &XEmitter::VADDPD, &XEmitter::ADDPD); break; //add
+	case 25: tri_op(inst.FD, inst.FA, inst.FC, true,  &XEmitter::VMULPD, &XEmitter::MULPD); break; //mul
 	default:
 		_assert_msg_(DYNA_REC, 0, "ps_arith WTF!!!");
 	}
@@ -288,6 +302,31 @@ void Jit64::ps_mergeXX(UGeckoInstruction inst)
 	int b = inst.FB;
 	fpr.Lock(a,b,d);
 
+	if (cpu_info.bAVX)
+	{
+		fpr.BindToRegister(a, true, false);
+		fpr.BindToRegister(d, d == b);
+		switch (inst.SUBOP10)
+		{
+		case 528:
+			VUNPCKLPD(fpr.RX(d), fpr.RX(a), fpr.R(b));
+			break; //00
+		case 560:
+			VSHUFPD(fpr.RX(d), fpr.RX(a), fpr.R(b), 2);
+			break; //01
+		case 592:
+			VSHUFPD(fpr.RX(d), fpr.RX(a), fpr.R(b), 1);
+			break; //10
+		case 624:
+			VUNPCKHPD(fpr.RX(d), fpr.RX(a), fpr.R(b));
+			break; //11
+		default:
+			_assert_msg_(DYNA_REC, 0, "ps_merge - invalid op");
+		}
+		fpr.UnlockAll();
+		return;
+	}
+
 	MOVAPD(XMM0, fpr.R(a));
 	switch (inst.SUBOP10)
 	{
@@ -324,43 +363,36 @@ void Jit64::ps_maddXX(UGeckoInstruction inst)
 		return;
 	}
 
+	// Without FMA3, only the interpreter rounds once.
+	bool fused = Core::g_CoreStartupParameter.bFusedMultiplyAdd;
+	if (fused && !cpu_info.bFMA)
+	{
+		FallBackToInterpreter(inst);
+		return;
+	}
+
 	int a = inst.FA;
 	int b = inst.FB;
 	int c = inst.FC;
 	int d = inst.FD;
 	fpr.Lock(a,b,c,d);
 
-	MOVAPD(XMM0, fpr.R(a));
+	X64Reg multiplier = XMM1;
 	switch (inst.SUBOP5)
 	{
 	case 14: //madds0
 		MOVDDUP(XMM1, fpr.R(c));
-		MULPD(XMM0, R(XMM1));
-		ADDPD(XMM0, fpr.R(b));
 		break;
 	case 15: //madds1
 		MOVAPD(XMM1, fpr.R(c));
 		SHUFPD(XMM1, R(XMM1), 3); // copy higher to lower
-		MULPD(XMM0, R(XMM1));
-		ADDPD(XMM0, fpr.R(b));
 		break;
 	case 28: //msub
-		MULPD(XMM0, fpr.R(c));
-		SUBPD(XMM0, fpr.R(b));
-		break;
 	case 29: //madd
-		MULPD(XMM0, fpr.R(c));
-		ADDPD(XMM0, fpr.R(b));
-		break;
 	case 30: //nmsub
-		MULPD(XMM0, fpr.R(c));
-		SUBPD(XMM0, fpr.R(b));
-		PXOR(XMM0, M((void*)&psSignBits));
-		break;
 	case 31: //nmadd
-		MULPD(XMM0, fpr.R(c));
-		ADDPD(XMM0, fpr.R(b));
-		PXOR(XMM0, M((void*)&psSignBits));
+		fpr.BindToRegister(c, true, false);
+		multiplier = fpr.RX(c);
 		break;
 	default:
 		_assert_msg_(DYNA_REC, 0, "ps_maddXX WTF!!!");
@@ -368,8 +400,28 @@ void Jit64::ps_maddXX(UGeckoInstruction inst)
 		//fpr.UnlockAll();
 		return;
 	}
-	fpr.BindToRegister(d, false);
-	MOVAPD(fpr.RX(d), Gen::R(XMM0));
+
+	bool subtract = inst.SUBOP5 == 28 || inst.SUBOP5 == 30;
+	bool negate = inst.SUBOP5 == 30 || inst.SUBOP5 == 31;
+	if (cpu_info.bAVX && !fused)
+	{
+		fpr.BindToRegister(a, true, false);
+		VMULPD(XMM0, fpr.RX(a), R(multiplier));
+		fpr.BindToRegister(d, d == b);
+		if (subtract)
+			VSUBPD(fpr.RX(d), XMM0, fpr.R(b));
+		else
+			VADDPD(fpr.RX(d), XMM0, fpr.R(b));
+		if (negate)
+			PXOR(fpr.RX(d), M((void*)&psSignBits));
+	}
+	else
+	{
+		MOVAPD(XMM0, fpr.R(a));
+		MultiplyAdd(XMM0, multiplier, fpr.R(b), subtract, negate, true, fused);
+		fpr.BindToRegister(d, false);
+		MOVAPD(fpr.RX(d), Gen::R(XMM0));
+	}
 	ForceSinglePrecisionP(fpr.RX(d));
 	fpr.UnlockAll();
 }
@@ -712,7 +712,7 @@ static void DoWriteCode(IRBuilder* ibuild, JitIL* Jit, u32 exitAddress) {
 				regMarkUse(RI, I, getOp1(I), 1);
 			break;
 		case IdleBranch:
-			regMarkUse(RI, I, getOp1(getOp1(I)), 1);
+			regMarkUse(RI, I, getOp1(I), 1);
 			break;
 		case BranchCond: {
 			if (isICmp(*getOp1(I)) &&
@@ -1621,19 +1621,19 @@ static void DoWriteCode(IRBuilder* ibuild, JitIL* Jit, u32 exitAddress) {
 			break;
 
 		case IdleBranch: {
-			Jit->CMP(32, regLocForInst(RI, getOp1(getOp1(I))),
-					 Imm32(RI.Build->GetImmValue(getOp2(getOp1(I)))));
-			FixupBranch cont = Jit->J_CC(CC_NE);
+			// Like BranchCond, but the loop it takes only waits for the next event.
+			Jit->CMP(32, regLocForInst(RI, getOp1(I)), Imm8(0));
+			FixupBranch cont = Jit->J_CC(CC_Z);
 
 			RI.Jit->Cleanup(); // is it needed?
-			Jit->ABI_CallFunction((void *)&PowerPC::OnIdleIL);
+			Jit->ABI_CallFunctionC((void *)&PowerPC::OnIdleLoop, ibuild->GetImmValue(getOp2(I)));
 
 			Jit->MOV(32, M(&PC), Imm32(ibuild->GetImmValue( getOp2(I) )));
 			Jit->WriteExceptionExit();
 
 			Jit->SetJumpTarget(cont);
 			if (RI.IInfo[I - RI.FirstI] & 4)
-					regClearInst(RI, getOp1(getOp1(I)));
+				regClearInst(RI, getOp1(I));
 			if (RI.IInfo[I - RI.FirstI] & 8)
 				regClearInst(RI, getOp2(I));
 			break;
@@ -1682,7 +1682,7 @@ static void DoWriteCode(IRBuilder* ibuild, JitIL* Jit, u32 exitAddress) {
 		}
 		case ShortIdleLoop: {
 			unsigned InstLoc = ibuild->GetImmValue(getOp1(I));
-			Jit->ABI_CallFunction((void *)&CoreTiming::Idle);
+			Jit->ABI_CallFunctionC((void *)&PowerPC::OnIdleLoop, InstLoc);
 			Jit->MOV(32, M(&PC), Imm32(InstLoc));
 			Jit->WriteExceptionExit();
 			break;
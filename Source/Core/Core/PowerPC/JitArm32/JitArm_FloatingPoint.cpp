@@ -526,7 +526,8 @@ void JitArm::fmaddsx(UGeckoInstruction inst)
 	INSTRUCTION_START
 	JITDISABLE(bJITFloatingPointOff)
 
-	if (inst.Rc)
+	// VMLA and VMUL+VADD round twice, leave the single rounding to the interpreter.
+	if (inst.Rc || Core::g_CoreStartupParameter.bFusedMultiplyAdd)
 	{
 		FallBackToInterpreter(inst);
 		return;
@@ -557,7 +558,7 @@ void JitArm::fmaddx(UGeckoInstruction inst)
 	INSTRUCTION_START
 	JITDISABLE(bJITFloatingPointOff)
 
-	if (inst.Rc)
+	if (inst.Rc || Core::g_CoreStartupParameter.bFusedMultiplyAdd)
 	{
 		FallBackToInterpreter(inst);
 		return;
@@ -588,7 +589,7 @@ void JitArm::fnmaddx(UGeckoInstruction inst)
 
 	u32 a = inst.FA, b = inst.FB, c = inst.FC, d = inst.FD;
 
-	if (inst.Rc)
+	if (inst.Rc || Core::g_CoreStartupParameter.bFusedMultiplyAdd)
 	{
 		FallBackToInterpreter(inst);
 		return;
@@ -616,7 +617,7 @@ void JitArm::fnmaddsx(UGeckoInstruction inst)
 
 	u32 a = inst.FA, b = inst.FB, c = inst.FC, d = inst.FD;
 
-	if (inst.Rc)
+	if (inst.Rc || Core::g_CoreStartupParameter.bFusedMultiplyAdd)
 	{
 		FallBackToInterpreter(inst);
 		return;
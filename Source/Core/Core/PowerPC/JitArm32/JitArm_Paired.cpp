@@ -203,7 +203,8 @@ void JitArm::ps_nmadd(UGeckoInstruction inst)
 
 	u32 a = inst.FA, b = inst.FB, c = inst.FC, d = inst.FD;
 
-	if (inst.Rc)
+	// VMLA and VMUL+VADD round twice, leave the single rounding to the interpreter.
+	if (inst.Rc || Core::g_CoreStartupParameter.bFusedMultiplyAdd)
 	{
 		FallBackToInterpreter(inst);
 		return;
@@ -239,7 +240,7 @@ void JitArm::ps_madd(UGeckoInstruction inst)
 
 	u32 a = inst.FA, b = inst.FB, c = inst.FC, d = inst.FD;
 
-	if (inst.Rc)
+	if (inst.Rc || Core::g_CoreStartupParameter.bFusedMultiplyAdd)
 	{
 		FallBackToInterpreter(inst);
 		return;
@@ -273,7 +274,7 @@ void JitArm::ps_nmsub(UGeckoInstruction inst)
 
 	u32 a = inst.FA, b = inst.FB, c = inst.FC, d = inst.FD;
 
-	if (inst.Rc)
+	if (inst.Rc || Core::g_CoreStartupParameter.bFusedMultiplyAdd)
 	{
 		FallBackToInterpreter(inst);
 		return;
@@ -309,7 +310,7 @@ void JitArm::ps_msub(UGeckoInstruction inst)
 
 	u32 a = inst.FA, b = inst.FB, c = inst.FC, d = inst.FD;
 
-	if (inst.Rc)
+	if (inst.Rc || Core::g_CoreStartupParameter.bFusedMultiplyAdd)
 	{
 		FallBackToInterpreter(inst);
 		return;
@@ -343,7 +344,7 @@ void JitArm::ps_madds0(UGeckoInstruction inst)
 
 	u32 a = inst.FA, b = inst.FB, c = inst.FC, d = inst.FD;
 
-	if (inst.Rc)
+	if (inst.Rc || Core::g_CoreStartupParameter.bFusedMultiplyAdd)
 	{
 		FallBackToInterpreter(inst);
 		return;
@@ -377,7 +378,7 @@ void JitArm::ps_madds1(UGeckoInstruction inst)
 
 	u32 a = inst.FA, b = inst.FB, c = inst.FC, d = inst.FD;
 
-	if (inst.Rc)
+	if (inst.Rc || Core::g_CoreStartupParameter.bFusedMultiplyAdd)
 	{
 		FallBackToInterpreter(inst);
 		return;
@@ -270,7 +270,7 @@ static GekkoOPTemplate table31[] =
 	{83,  &JitArm::mfmsr},                  //"mfmsr",  OPTYPE_SYSTEM, FL_OUT_D}},
 	{144, &JitArm::mtcrf},                  //"mtcrf",  OPTYPE_SYSTEM, 0}},
 	{146, &JitArm::mtmsr},                  //"mtmsr",  OPTYPE_SYSTEM, FL_ENDBLOCK}},
-	{210, &JitArm::mtsr},                   //"mtsr",   OPTYPE_SYSTEM, 0}},
+	{210, &JitArm::FallBackToInterpreter},  //"mtsr",   OPTYPE_SYSTEM, 0}},
 	{242, &JitArm::FallBackToInterpreter},  //"mtsrin", OPTYPE_SYSTEM, 0}},
 	{339, &JitArm::mfspr},                  //"mfspr",  OPTYPE_SPR, FL_OUT_D}},
 	{467, &JitArm::mtspr},                  //"mtspr",  OPTYPE_SPR, 0, 2}},
@@ -48,6 +48,7 @@ protected:
 		bool optimizeGatherPipe;
 		bool fastInterrupts;
 		bool accurateSinglePrecision;
+		bool tieredCompilation; // recompile hot blocks with the optimizing tier
 	};
 	struct JitState
 	{
@@ -64,6 +65,9 @@ protected:
 		bool isLastInstruction;
 		bool memcheck;
 		bool skipnext;
+		// Whether results the analyzer found dead may be dropped. Not when
+		// something could look at them mid-block, like the debugger.
+		bool skipDeadResults;
 
 		int fifoBytesThisBlock;
 
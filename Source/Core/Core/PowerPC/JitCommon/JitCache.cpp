@@ -8,18 +8,34 @@
 // dependency is a little inconvenient and this is possibly a slight
 // performance hit, it's not enabled by default, but it's useful for
 // locating performance issues.
+//
+// On Linux, a perf map (/tmp/perf-<pid>.map) describing the generated blocks
+// can be written (the [Core] PerfMap setting), so that "perf report" can
+// attribute samples to guest functions instead of anonymous memory.
+
+#include <algorithm>
+#include <cinttypes>
 
 #include "disasm.h"
 
 #include "Common/Common.h"
+#include "Common/FileUtil.h"
 #include "Common/MemoryUtil.h"
+#include "Common/StringUtil.h"
 #include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/PPCSymbolDB.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 
 #ifdef _WIN32
 #include <windows.h>
 #endif
 
+#ifdef __linux__
+#include <unistd.h>
+
+static File::IOFile s_perf_map_file;
+#endif
+
 #if defined USE_OPROFILE && USE_OPROFILE
 #include <opagent.h>
 
@@ -36,7 +52,7 @@ using namespace Gen;
 
 	bool JitBaseBlockCache::IsFull() const
 	{
-		return GetNumBlocks() >= MAX_NUM_BLOCKS - 1;
+		return free_blocks.empty() && GetNumBlocks() >= MAX_NUM_BLOCKS - 1;
 	}
 
 	void JitBaseBlockCache::Init()
@@ -46,6 +62,8 @@ using namespace Gen;
 #endif
 		blocks = new JitBlock[MAX_NUM_BLOCKS];
 		blockCodePointers = new const u8*[MAX_NUM_BLOCKS];
+		block_pages.resize(NUM_BLOCK_PAGES);
+		memset(&stats, 0, sizeof(stats));
 		if (iCache == nullptr && iCacheEx == nullptr && iCacheVMEM == nullptr)
 		{
 			iCache = new u8[JIT_ICACHE_SIZE];
@@ -66,6 +84,13 @@ using namespace Gen;
 		Clear();
 	}
 
+	void JitBaseBlockCache::EnablePerfMap()
+	{
+#ifdef __linux__
+		s_perf_map_file.Open(StringFromFormat("/tmp/perf-%d.map", getpid()), "w");
+#endif
+	}
+
 	void JitBaseBlockCache::Shutdown()
 	{
 		delete[] blocks;
@@ -82,10 +107,20 @@ using namespace Gen;
 		blocks = nullptr;
 		blockCodePointers = nullptr;
 		num_blocks = 0;
+		links_to.clear();
+		block_pages.clear();
+		free_blocks.clear();
+		evicted_addresses.clear();
+		promoted_blocks.clear();
+		inline_counts.clear();
 #if defined USE_OPROFILE && USE_OPROFILE
 		op_close_agent(agent);
 #endif
 
+#ifdef __linux__
+		s_perf_map_file.Close();
+#endif
+
 #ifdef USE_VTUNE
 		iJIT_NotifyEvent(iJVM_EVENT_TYPE_SHUTDOWN, nullptr);
 #endif
@@ -107,10 +142,17 @@ using namespace Gen;
 			DestroyBlock(i, false);
 		}
 		links_to.clear();
-		block_map.clear();
+		for (auto& page : block_pages)
+			page.clear();
+		free_blocks.clear();
+		evicted_addresses.clear();
+		promoted_blocks.clear();
+		inline_counts.clear();
 
 		valid_block.ClearAll();
 
+		if (num_blocks)
+			stats.numFlushes++;
 		num_blocks = 0;
 		memset(blockCodePointers, 0, sizeof(u8*)*MAX_NUM_BLOCKS);
 	}
@@ -145,12 +187,35 @@ using namespace Gen;
 
 	int JitBaseBlockCache::AllocateBlock(u32 em_address)
 	{
-		JitBlock &b = blocks[num_blocks];
+		int block_num;
+		if (!free_blocks.empty())
+		{
+			block_num = free_blocks.back();
+			free_blocks.pop_back();
+		}
+		else
+		{
+			block_num = num_blocks;
+			num_blocks++; //commit the current block
+		}
+
+		JitBlock &b = blocks[block_num];
 		b.invalid = false;
 		b.originalAddress = em_address;
+		b.runCount = 0;
+		b.evictionRunCount = 0;
+		b.tier = 0;
+		b.used = false;
+		b.numFallbacks = 0;
+		b.numExitStores = 0;
+		b.numDeadStores = 0;
 		b.linkData.clear();
-		num_blocks++; //commit the current block
-		return num_blocks - 1;
+		b.inlinedCode.clear();
+
+		if (!evicted_addresses.empty() && evicted_addresses.erase(em_address))
+			stats.numRecompilations++;
+
+		return block_num;
 	}
 
 	void JitBaseBlockCache::FinalizeBlock(int block_num, bool block_link, const u8 *code_ptr)
@@ -160,18 +225,15 @@ using namespace Gen;
 		u32* icp = GetICachePtr(b.originalAddress);
 		*icp = block_num;
 
-		// Convert the logical address to a physical address for the block map
-		u32 pAddr = b.originalAddress & 0x1FFFFFFF;
+		AddBlockToPages(block_num, b.originalAddress, b.originalSize);
+		for (const auto& range : b.inlinedCode)
+			AddBlockToPages(block_num, range.first, range.second);
 
-		for (u32 i = 0; i < (b.originalSize + 7) / 8; ++i)
-			valid_block.Set(pAddr / 32 + i);
-
-		block_map[std::make_pair(pAddr + 4 * b.originalSize - 1, pAddr)] = block_num;
 		if (block_link)
 		{
 			for (const auto& e : b.linkData)
 			{
-				links_to.insert(std::pair<u32, int>(e.exitAddress, block_num));
+				links_to[e.exitAddress].push_back(block_num);
 			}
 
 			LinkBlock(block_num);
@@ -186,6 +248,17 @@ using namespace Gen;
 		                     blockStart, b.codeSize);
 #endif
 
+#ifdef __linux__
+		if (s_perf_map_file.IsOpen())
+		{
+			std::string name = g_symbolDB.GetDescription(b.originalAddress);
+			u32 size = (u32)(b.normalEntry - b.checkedEntry) + b.codeSize;
+			fprintf(s_perf_map_file.GetHandle(), "%" PRIx64 " %x EmuCode_0x%08x_%s\n",
+			        (u64)b.checkedEntry, size, b.originalAddress, name.c_str());
+			s_perf_map_file.Flush();
+		}
+#endif
+
 #ifdef USE_VTUNE
 		sprintf(b.blockName, "EmuCode_0x%08x", b.originalAddress);
 
@@ -209,11 +282,11 @@ using namespace Gen;
 	u32* JitBaseBlockCache::GetICachePtr(u32 addr)
 	{
 		if (addr & JIT_ICACHE_VMEM_BIT)
-			return (u32*)(jit->GetBlockCache()->iCacheVMEM + (addr & JIT_ICACHE_MASK));
+			return (u32*)(iCacheVMEM + (addr & JIT_ICACHE_MASK));
 		else if (addr & JIT_ICACHE_EXRAM_BIT)
-			return (u32*)(jit->GetBlockCache()->iCacheEx + (addr & JIT_ICACHEEX_MASK));
+			return (u32*)(iCacheEx + (addr & JIT_ICACHEEX_MASK));
 		else
-			return (u32*)(jit->GetBlockCache()->iCache + (addr & JIT_ICACHE_MASK));
+			return (u32*)(iCache + (addr & JIT_ICACHE_MASK));
 	}
 
 	int JitBaseBlockCache::GetBlockNumberFromStartAddress(u32 addr)
@@ -264,40 +337,94 @@ using namespace Gen;
 		}
 	}
 
-	using namespace std;
-
 	void JitBaseBlockCache::LinkBlock(int i)
 	{
 		LinkBlockExits(i);
 		JitBlock &b = blocks[i];
-		pair<multimap<u32, int>::iterator, multimap<u32, int>::iterator> ppp;
-		// equal_range(b) returns pair<iterator,iterator> representing the range
-		// of element with key b
-		ppp = links_to.equal_range(b.originalAddress);
-		if (ppp.first == ppp.second)
+		auto it = links_to.find(b.originalAddress);
+		if (it == links_to.end())
 			return;
-		for (multimap<u32, int>::iterator iter = ppp.first; iter != ppp.second; ++iter) {
-			// PanicAlert("Linking block %i to block %i", iter->second, i);
-			LinkBlockExits(iter->second);
+		for (int source : it->second)
+		{
+			// PanicAlert("Linking block %i to block %i", source, i);
+			LinkBlockExits(source);
 		}
 	}
 
 	void JitBaseBlockCache::UnlinkBlock(int i)
 	{
 		JitBlock &b = blocks[i];
-		pair<multimap<u32, int>::iterator, multimap<u32, int>::iterator> ppp;
-		ppp = links_to.equal_range(b.originalAddress);
-		if (ppp.first == ppp.second)
+		auto it = links_to.find(b.originalAddress);
+		if (it == links_to.end())
 			return;
-		for (multimap<u32, int>::iterator iter = ppp.first; iter != ppp.second; ++iter) {
-			JitBlock &sourceBlock = blocks[iter->second];
+		for (int source : it->second)
+		{
+			JitBlock &sourceBlock = blocks[source];
 			for (auto& e : sourceBlock.linkData)
 			{
 				if (e.exitAddress == b.originalAddress)
 					e.linkStatus = false;
 			}
 		}
-		links_to.erase(b.originalAddress);
+	}
+
+	void JitBaseBlockCache::RemoveBlockFromLinks(int i)
+	{
+		JitBlock &b = blocks[i];
+		for (const auto& e : b.linkData)
+		{
+			auto it = links_to.find(e.exitAddress);
+			if (it == links_to.end())
+				continue;
+			std::vector<int> &sources = it->second;
+			sources.erase(std::remove(sources.begin(), sources.end(), i), sources.end());
+			if (sources.empty())
+				links_to.erase(it);
+		}
+	}
+
+	// Registers size instructions of code at address as belonging to block i.
+	void JitBaseBlockCache::AddBlockToPages(int i, u32 address, u32 size)
+	{
+		// Convert the logical address to a physical address for the block map
+		u32 pAddr = address & 0x1FFFFFFF;
+
+		u32 pEnd = pAddr + std::max<u32>(4 * size, 1) - 1;
+
+		// Blocks aren't aligned to cache lines, so mark every line they touch.
+		for (u32 line = pAddr / 32; line <= pEnd / 32; ++line)
+			valid_block.Set(line);
+
+		u32 lastPage = pEnd >> BLOCK_PAGE_SHIFT;
+		for (u32 page = pAddr >> BLOCK_PAGE_SHIFT; page <= lastPage && page < NUM_BLOCK_PAGES; ++page)
+		{
+			std::vector<int> &pageBlocks = block_pages[page];
+			// Inlined code may share a page with the rest of the block.
+			if (pageBlocks.empty() || pageBlocks.back() != i)
+				pageBlocks.push_back(i);
+		}
+	}
+
+	void JitBaseBlockCache::RemoveBlockFromPages(int i)
+	{
+		JitBlock &b = blocks[i];
+		auto removeRange = [&](u32 address, u32 size) {
+			u32 pAddr = address & 0x1FFFFFFF;
+			u32 lastPage = (pAddr + std::max<u32>(4 * size, 1) - 1) >> BLOCK_PAGE_SHIFT;
+			for (u32 page = pAddr >> BLOCK_PAGE_SHIFT; page <= lastPage && page < NUM_BLOCK_PAGES; ++page)
+			{
+				std::vector<int> &pageBlocks = block_pages[page];
+				auto it = std::find(pageBlocks.begin(), pageBlocks.end(), i);
+				if (it != pageBlocks.end())
+				{
+					*it = pageBlocks.back();
+					pageBlocks.pop_back();
+				}
+			}
+		};
+		removeRange(b.originalAddress, b.originalSize);
+		for (const auto& range : b.inlinedCode)
+			removeRange(range.first, range.second);
 	}
 
 	void JitBaseBlockCache::DestroyBlock(int block_num, bool invalidate)
@@ -318,11 +445,93 @@ using namespace Gen;
 		*GetICachePtr(b.originalAddress) = JIT_ICACHE_INVALID_WORD;
 
 		UnlinkBlock(block_num);
+		RemoveBlockFromLinks(block_num);
 
 		// Send anyone who tries to run this block back to the dispatcher.
 		// Not entirely ideal, but .. pretty good.
 		// Spurious entrances from previously linked blocks can only come through checkedEntry
 		WriteDestroyBlock(b.checkedEntry, b.originalAddress);
+
+		// The code stays where it is, only the block number can be used again.
+		free_blocks.push_back(block_num);
+	}
+
+	int JitBaseBlockCache::EvictBlocks(const u8* start, const u8* end)
+	{
+		int evicted = 0;
+		for (int i = 0; i < num_blocks; i++)
+		{
+			JitBlock &b = blocks[i];
+			if (!b.invalid && b.checkedEntry >= start && b.checkedEntry < end)
+			{
+				DestroyBlock(i, false);
+				RemoveBlockFromPages(i);
+				evicted_addresses.insert(b.originalAddress);
+				evicted++;
+			}
+		}
+
+		// The remaining blocks may still jump into the evicted code, either to
+		// one of the blocks which were just evicted, or to what an earlier
+		// DestroyBlock left behind. Send all their unlinked exits back to the
+		// dispatcher.
+		for (int i = 0; i < num_blocks; i++)
+		{
+			JitBlock &b = blocks[i];
+			if (b.invalid)
+				continue;
+			for (const auto& e : b.linkData)
+			{
+				if (!e.linkStatus)
+					WriteDestroyBlock(e.exitPtrs, e.exitAddress);
+			}
+		}
+
+		stats.numEvictions++;
+		stats.numEvictedBlocks += evicted;
+		return evicted;
+	}
+
+	void JitBaseBlockCache::AddBlockExit(int block_num, u8 *location, u32 exit_address)
+	{
+		JitBlock &b = blocks[block_num];
+		JitBlock::LinkData linkData;
+		linkData.exitPtrs = location;
+		linkData.exitAddress = exit_address;
+		linkData.linkStatus = false;
+		WriteDestroyBlock(location, exit_address);
+		b.linkData.push_back(linkData);
+
+		links_to[exit_address].push_back(block_num);
+		LinkBlockExits(block_num);
+	}
+
+	void JitBaseBlockCache::PromoteBlock(int block_num)
+	{
+		JitBlock &b = blocks[block_num];
+		if (b.invalid)
+			return;
+
+		JitBlockBaseline &baseline = promoted_blocks[b.originalAddress];
+		baseline.ticCounter = b.ticCounter;
+		// The run which triggered the promotion isn't part of ticCounter.
+		baseline.numInstructions = (u64)(u32)(b.runCount - 1) * b.originalSize;
+
+		DestroyBlock(block_num, false);
+		RemoveBlockFromPages(block_num);
+		stats.numPromotions++;
+	}
+
+	const JitBlockBaseline* JitBaseBlockCache::GetPromotionBaseline(u32 em_address) const
+	{
+		auto it = promoted_blocks.find(em_address);
+		return it != promoted_blocks.end() ? &it->second : nullptr;
+	}
+
+	void JitBaseBlockCache::CountInlinedFunctions(const JitBlock &b)
+	{
+		for (const auto& range : b.inlinedCode)
+			inline_counts[range.first]++;
 	}
 
 	void JitBaseBlockCache::InvalidateICache(u32 address, const u32 length)
@@ -341,20 +550,39 @@ using namespace Gen;
 		}
 
 		// destroy JIT blocks
-		// !! this works correctly under assumption that any two overlapping blocks end at the same address
 		if (destroy_block)
 		{
-			std::map<pair<u32,u32>, u32>::iterator it1 = block_map.lower_bound(std::make_pair(pAddr, 0)), it2 = it1;
-			while (it2 != block_map.end() && it2->first.second < pAddr + length)
-			{
-				JitBlock &b = blocks[it2->second];
-				*GetICachePtr(b.originalAddress) = JIT_ICACHE_INVALID_WORD;
-				DestroyBlock(it2->second, true);
-				++it2;
-			}
-			if (it1 != it2)
+			// Invalidations past the end of the address space are clamped.
+			u32 end = pAddr + std::min<u32>(length, 0x20000000 - pAddr);
+			if (end == pAddr)
+				return;
+			u32 lastPage = (end - 1) >> BLOCK_PAGE_SHIFT;
+			for (u32 page = pAddr >> BLOCK_PAGE_SHIFT; page <= lastPage; ++page)
 			{
-				block_map.erase(it1, it2);
+				std::vector<int> &pageBlocks = block_pages[page];
+				for (size_t i = 0; i < pageBlocks.size();)
+				{
+					int block_num = pageBlocks[i];
+					JitBlock &b = blocks[block_num];
+					auto overlaps = [&](u32 code_address, u32 code_size) {
+						u32 start = code_address & 0x1FFFFFFF;
+						return start < end && start + 4 * code_size > pAddr;
+					};
+					bool overlap = overlaps(b.originalAddress, b.originalSize);
+					for (const auto& range : b.inlinedCode)
+						overlap = overlap || overlaps(range.first, range.second);
+					if (overlap)
+					{
+						DestroyBlock(block_num, true);
+						// This also removes the block from pageBlocks, moving
+						// another block into slot i.
+						RemoveBlockFromPages(block_num);
+					}
+					else
+					{
+						++i;
+					}
+				}
 			}
 		}
 	}
@@ -7,6 +7,8 @@
 #include <bitset>
 #include <map>
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "Core/PowerPC/Gekko.h"
@@ -38,7 +40,13 @@ struct JitBlock
 	u32 originalAddress;
 	u32 codeSize;
 	u32 originalSize;
-	int runCount;  // for profiling.
+	int runCount;  // for profiling, tiering and code eviction.
+	int evictionRunCount; // runCount when the eviction policy last looked at this block.
+	int tier;     // 0 when compiled quickly, 1 when recompiled after getting hot.
+	bool used;    // ran since the eviction policy last looked, for blocks which don't count their runs.
+	int numFallbacks; // instructions which call the interpreter, for profiling.
+	int numExitStores; // register write backs at the exits, for profiling.
+	int numDeadStores; // write backs at the exits skipped as dead, for profiling.
 
 	bool invalid;
 
@@ -49,13 +57,16 @@ struct JitBlock
 	};
 	std::vector<LinkData> linkData;
 
-#ifdef _WIN32
+	// Code outside the block which it depends on, see CodeBlock::m_inlined:
+	// start address, number of instructions. Writes to it have to invalidate
+	// the block too.
+	std::vector<std::pair<u32, u32>> inlinedCode;
+
 	// we don't really need to save start and stop
 	// TODO (mb2): ticStart and ticStop -> "local var" mean "in block" ... low priority ;)
 	u64 ticStart;   // for profiling - time.
 	u64 ticStop;    // for profiling - time.
 	u64 ticCounter; // for profiling - time.
-#endif
 
 #ifdef USE_VTUNE
 	char blockName[32];
@@ -99,24 +110,50 @@ public:
 	}
 };
 
+struct JitBlockCacheStats
+{
+	u64 numEvictions;        // code regions evicted
+	u64 numEvictedBlocks;    // blocks destroyed by evictions
+	u64 numRecompilations;   // evicted blocks which had to be compiled again
+	u64 numFlushes;          // full cache clears
+	u64 numPromotions;       // blocks recompiled in the optimizing tier
+};
+
+// How a block performed before it was promoted to the optimizing tier.
+struct JitBlockBaseline
+{
+	u64 ticCounter;
+	u64 numInstructions;   // guest instructions executed
+};
+
 class JitBaseBlockCache
 {
 	const u8 **blockCodePointers;
 	JitBlock *blocks;
 	int num_blocks;
-	std::multimap<u32, int> links_to;
-	std::map<std::pair<u32,u32>, u32> block_map; // (end_addr, start_addr) -> number
+	std::vector<int> free_blocks; // destroyed blocks which can be allocated again
+	std::unordered_set<u32> evicted_addresses;
+	std::unordered_map<u32, JitBlockBaseline> promoted_blocks; // address -> profile before promotion
+	std::map<u32, u64> inline_counts; // function address -> times inlined while profiling
+	JitBlockCacheStats stats;
+	std::unordered_map<u32, std::vector<int>> links_to; // exit address -> blocks exiting to it
+	std::vector<std::vector<int>> block_pages; // physical page -> blocks overlapping it
 	ValidBlockBitSet valid_block;
 
 	enum
 	{
 		MAX_NUM_BLOCKS = 65536*2,
+		BLOCK_PAGE_SHIFT = 12,
+		NUM_BLOCK_PAGES = 0x20000000 >> BLOCK_PAGE_SHIFT,
 	};
 
 	bool RangeIntersect(int s1, int e1, int s2, int e2) const;
 	void LinkBlockExits(int i);
 	void LinkBlock(int i);
 	void UnlinkBlock(int i);
+	void AddBlockToPages(int i, u32 address, u32 size);
+	void RemoveBlockFromPages(int i);
+	void RemoveBlockFromLinks(int i);
 
 	// Virtual for overloaded
 	virtual void WriteLinkBlock(u8* location, const u8* address) = 0;
@@ -126,6 +163,7 @@ public:
 	JitBaseBlockCache() :
 		blockCodePointers(nullptr), blocks(nullptr), num_blocks(0),
 		iCache(nullptr), iCacheEx(nullptr), iCacheVMEM(nullptr) {}
+	virtual ~JitBaseBlockCache() {}
 	int AllocateBlock(u32 em_address);
 	void FinalizeBlock(int block_num, bool block_link, const u8 *code_ptr);
 
@@ -134,6 +172,10 @@ public:
 	void Shutdown();
 	void Reset();
 
+	// Describes the blocks compiled from now on in /tmp/perf-<pid>.map, for
+	// perf to name them. Only on Linux; the file is closed by Shutdown.
+	void EnablePerfMap();
+
 	bool IsFull() const;
 
 	// Code Cache
@@ -152,9 +194,33 @@ public:
 	u32 GetOriginalFirstOp(int block_num);
 	CompiledCode GetCompiledCodeFromBlock(int block_num);
 
-	// DOES NOT WORK CORRECTLY WITH INLINING
 	void InvalidateICache(u32 address, const u32 length);
 	void DestroyBlock(int block_num, bool invalidate);
+
+	// Destroys all the blocks whose code starts in [start, end), so that this
+	// part of the code space can be reused. All unlinked exits of the remaining
+	// blocks are rewritten with WriteDestroyBlock, so that none of them jumps
+	// into the evicted code anymore; exits must leave room for this.
+	// Returns the number of evicted blocks.
+	int EvictBlocks(const u8* start, const u8* end);
+
+	// Adds an exit to a finalized block, e.g. once an indirect branch learnt
+	// where it goes. location needs room for WriteDestroyBlock.
+	void AddBlockExit(int block_num, u8 *location, u32 exit_address);
+
+	// Destroys a hot block, so that the next time it runs it is compiled again
+	// by the optimizing tier. Remembers its profile for comparison. Meant to be
+	// called on entry to the block, before the run is profiled.
+	void PromoteBlock(int block_num);
+	bool IsPromoted(u32 em_address) const { return promoted_blocks.count(em_address) != 0; }
+	const JitBlockBaseline* GetPromotionBaseline(u32 em_address) const;
+
+	// Counts the functions inlined into a block. Only called by the JIT
+	// thread, and only while blocks are profiled.
+	void CountInlinedFunctions(const JitBlock &b);
+	const std::map<u32, u64>& GetInlineCounts() const { return inline_counts; }
+
+	const JitBlockCacheStats& GetStats() const { return stats; }
 };
 
 // x86 BlockCache
@@ -0,0 +1,53 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#include "Common/Common.h"
+#include "Common/CPUDetect.h"
+
+#include "Core/PowerPC/JitCommon/Jit_Util.h"
+
+using namespace Gen;
+
+static const u64 GC_ALIGNED16(psSignBits[2]) = {0x8000000000000000ULL, 0x8000000000000000ULL};
+
+void EmuCodeBlock::MultiplyAdd(X64Reg xmm, X64Reg multiplier, const OpArg& addend, bool subtract, bool negate, bool packed, bool fused)
+{
+	if (fused)
+	{
+		_assert_msg_(DYNA_REC, cpu_info.bFMA, "Fused multiply-add without FMA3");
+		if (packed)
+		{
+			if (subtract)
+				VFMSUB213PD(xmm, multiplier, addend);
+			else
+				VFMADD213PD(xmm, multiplier, addend);
+		}
+		else
+		{
+			if (subtract)
+				VFMSUB213SD(xmm, multiplier, addend);
+			else
+				VFMADD213SD(xmm, multiplier, addend);
+		}
+	}
+	else if (packed)
+	{
+		MULPD(xmm, R(multiplier));
+		if (subtract)
+			SUBPD(xmm, addend);
+		else
+			ADDPD(xmm, addend);
+	}
+	else
+	{
+		MULSD(xmm, R(multiplier));
+		if (subtract)
+			SUBSD(xmm, addend);
+		else
+			ADDSD(xmm, addend);
+	}
+	// Not VFNMADD: -(a * c) - b rounds an exact zero to +0, not -0.
+	if (negate)
+		PXOR(xmm, M((void*)&psSignBits));
+}
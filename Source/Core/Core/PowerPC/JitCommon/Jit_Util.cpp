@@ -272,6 +272,144 @@ void EmuCodeBlock::MMIOLoadToReg(MMIO::Mapping* mmio, Gen::X64Reg reg_value,
 	}
 }
 
+// Visitor that generates code to write the value in a register to a MMIO.
+template <typename T>
+class MMIOWriteCodeGenerator : public MMIO::WriteHandlingMethodVisitor<T>
+{
+public:
+	MMIOWriteCodeGenerator(Gen::X64CodeBlock* code, u32 registers_in_use,
+	                       Gen::X64Reg src_reg, u32 address)
+		: m_code(code), m_registers_in_use(registers_in_use), m_src_reg(src_reg),
+		  m_address(address)
+	{
+	}
+
+	virtual void VisitNop()
+	{
+	}
+	virtual void VisitDirect(T* addr, u32 mask)
+	{
+		StoreRegMaskToAddr(8 * sizeof (T), addr, mask);
+	}
+	virtual void VisitComplex(const std::function<void(u32, T)>* lambda)
+	{
+		CallLambda(lambda);
+	}
+
+private:
+	void StoreRegMaskToAddr(int sbits, void* ptr, u32 mask)
+	{
+		u32 all_ones = (1ULL << sbits) - 1;
+		if ((all_ones & mask) != all_ones)
+			m_code->AND(32, R(m_src_reg), Imm32(mask));
+#ifdef _ARCH_64
+		m_code->MOV(64, R(EAX), ImmPtr(ptr));
+#else
+		m_code->MOV(32, R(EAX), ImmPtr(ptr));
+#endif
+		m_code->MOV(sbits, MDisp(EAX, 0), R(m_src_reg));
+	}
+
+	void CallLambda(const std::function<void(u32, T)>* lambda)
+	{
+		m_code->ABI_PushRegistersAndAdjustStack(m_registers_in_use, false);
+		m_code->ABI_CallLambdaCA(lambda, m_address, R(m_src_reg));
+		m_code->ABI_PopRegistersAndAdjustStack(m_registers_in_use, false);
+	}
+
+	Gen::X64CodeBlock* m_code;
+	u32 m_registers_in_use;
+	Gen::X64Reg m_src_reg;
+	u32 m_address;
+};
+
+void EmuCodeBlock::MMIOWriteRegToAddr(MMIO::Mapping* mmio, Gen::X64Reg reg_value,
+                                      u32 registers_in_use, u32 address,
+                                      int access_size)
+{
+	switch (access_size)
+	{
+	case 8:
+		{
+			MMIOWriteCodeGenerator<u8> gen(this, registers_in_use, reg_value,
+			                               address);
+			mmio->GetHandlerForWrite8(address).Visit(gen);
+			break;
+		}
+	case 16:
+		{
+			MMIOWriteCodeGenerator<u16> gen(this, registers_in_use, reg_value,
+			                                address);
+			mmio->GetHandlerForWrite16(address).Visit(gen);
+			break;
+		}
+	case 32:
+		{
+			MMIOWriteCodeGenerator<u32> gen(this, registers_in_use, reg_value,
+			                                address);
+			mmio->GetHandlerForWrite32(address).Visit(gen);
+			break;
+		}
+	}
+}
+
+#if _M_X86_64
+// Scratch registers for the TLB probe: caller saved on both ABIs, so free
+// whenever the caller doesn't list them as in use.
+static const X64Reg tlbProbeCandidates[] = {RAX, RDX, RCX, R8, R9, R10, R11};
+
+bool EmuCodeBlock::TLBProbe(X64Reg reg_addr, u32 registersInUse, X64Reg* reg_phys, FixupBranch* miss)
+{
+	X64Reg regs[2];
+	int found = 0;
+	for (X64Reg reg : tlbProbeCandidates)
+	{
+		if (found < 2 && reg != reg_addr && !(registersInUse & (1 << reg)))
+			regs[found++] = reg;
+	}
+	// Not enough free registers; the caller's slow path handles everything.
+	if (found < 2)
+		return false;
+
+	X64Reg set = regs[0];
+	X64Reg scratch = regs[1];
+
+	// set = &ppcState.tlb[TLB_INDEX_DATA][page & (TLB_SETS - 1)], the page
+	// number scaled straight to a byte offset (sizeof(TLBSet) == 32).
+	MOV(32, R(scratch), R(reg_addr));
+	SHR(32, R(scratch), Imm8(12 - 5));
+	AND(32, R(scratch), Imm32((PowerPC::TLB_SETS - 1) << 5));
+	MOV(64, R(set), ImmPtr(&PowerPC::ppcState.tlb[PowerPC::TLB_INDEX_DATA][0]));
+	ADD(64, R(set), R(scratch));
+
+	MOV(32, R(scratch), R(reg_addr));
+	AND(32, R(scratch), Imm32(~0xfff));
+	CMP(32, R(scratch), MDisp(set, offsetof(PowerPC::TLBSet, tag)));
+	FixupBranch way1 = J_CC(CC_NE);
+	MOV(32, MDisp(set, offsetof(PowerPC::TLBSet, recent)), Imm32(0));
+	MOV(32, R(set), MDisp(set, offsetof(PowerPC::TLBSet, paddr)));
+	FixupBranch hit = J();
+	SetJumpTarget(way1);
+	CMP(32, R(scratch), MDisp(set, offsetof(PowerPC::TLBSet, tag) + sizeof(u32)));
+	FixupBranch miss_tag = J_CC(CC_NE, true);
+	MOV(32, MDisp(set, offsetof(PowerPC::TLBSet, recent)), Imm32(1));
+	MOV(32, R(set), MDisp(set, offsetof(PowerPC::TLBSet, paddr) + sizeof(u32)));
+	SetJumpTarget(hit);
+
+	MOV(32, R(scratch), R(reg_addr));
+	AND(32, R(scratch), Imm32(0xfff));
+	OR(32, R(set), R(scratch));
+	// Pages translating to anything but MEM1 go through the slow path too.
+	TEST(32, R(set), Imm32(~(u32)Memory::RAM_MASK));
+	FixupBranch miss_ram = J_CC(CC_NZ, true);
+
+	*reg_phys = set;
+	miss[0] = miss_tag;
+	miss[1] = miss_ram;
+	return true;
+}
+#endif
+
 void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg & opAddress, int accessSize, s32 offset, u32 registersInUse, bool signExtend, int flags)
 {
 	if (!jit->js.memcheck)
@@ -369,6 +507,23 @@ void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg & opAddress,
 
 			FixupBranch fast = J_CC(CC_Z, true);
 
+#if _M_X86_64
+			// With the MMU on, try the data TLB before calling out. A miss
+			// calls Memory::Read_*, which refills the TLB for next time.
+			X64Reg reg_phys;
+			FixupBranch tlb_miss[2];
+			bool tlb_probe = Core::g_CoreStartupParameter.bMMU && addr_loc.IsSimpleReg() &&
+			                 TLBProbe(addr_loc.GetSimpleReg(), registersInUse, &reg_phys, tlb_miss);
+			FixupBranch tlb_exit;
+			if (tlb_probe)
+			{
+				UnsafeLoadToReg(reg_value, R(reg_phys), accessSize, 0, signExtend);
+				tlb_exit = J(true);
+				SetJumpTarget(tlb_miss[0]);
+				SetJumpTarget(tlb_miss[1]);
+			}
+#endif
+
 			ABI_PushRegistersAndAdjustStack(registersInUse, false);
 			switch (accessSize)
 			{
@@ -396,6 +551,10 @@ void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg & opAddress,
 			SetJumpTarget(fast);
 			UnsafeLoadToReg(reg_value, addr_loc, accessSize, 0, signExtend);
 			SetJumpTarget(exit);
+#if _M_X86_64
+			if (tlb_probe)
+				SetJumpTarget(tlb_exit);
+#endif
 		}
 	}
 }
@@ -487,6 +646,23 @@ void EmuCodeBlock::SafeWriteRegToReg(X64Reg reg_value, X64Reg reg_addr, int acce
 	FixupBranch fast = J_CC(CC_Z, true);
 	bool noProlog = (0 != (flags & SAFE_LOADSTORE_NO_PROLOG));
 	bool swap = !(flags & SAFE_LOADSTORE_NO_SWAP);
+
+#if _M_X86_64
+	// See SafeLoadToReg; Memory::Write_* refills the TLB on a miss.
+	X64Reg reg_phys;
+	FixupBranch tlb_miss[2];
+	bool tlb_probe = Core::g_CoreStartupParameter.bMMU &&
+	                 TLBProbe(reg_addr, registersInUse | (1 << reg_value), &reg_phys, tlb_miss);
+	FixupBranch tlb_exit;
+	if (tlb_probe)
+	{
+		UnsafeWriteRegToReg(reg_value, reg_phys, accessSize, 0, swap);
+		tlb_exit = J(true);
+		SetJumpTarget(tlb_miss[0]);
+		SetJumpTarget(tlb_miss[1]);
+	}
+#endif
+
 	ABI_PushRegistersAndAdjustStack(registersInUse, noProlog);
 	switch (accessSize)
 	{
@@ -499,6 +675,10 @@ void EmuCodeBlock::SafeWriteRegToReg(X64Reg reg_value, X64Reg reg_addr, int acce
 	SetJumpTarget(fast);
 	UnsafeWriteRegToReg(reg_value, reg_addr, accessSize, 0, swap);
 	SetJumpTarget(exit);
+#if _M_X86_64
+	if (tlb_probe)
+		SetJumpTarget(tlb_exit);
+#endif
 }
 
 void EmuCodeBlock::SafeWriteFloatToReg(X64Reg xmm_value, X64Reg reg_addr, u32 registersInUse, int flags)
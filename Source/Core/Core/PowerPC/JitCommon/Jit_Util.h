@@ -37,6 +37,8 @@ public:
 	// Generate a load/write from the MMIO handler for a given address. Only
 	// call for known addresses in MMIO range (MMIO::IsMMIOAddress).
 	void MMIOLoadToReg(MMIO::Mapping* mmio, Gen::X64Reg reg_value, u32 registers_in_use, u32 address, int access_size, bool sign_extend);
+	// Trashes reg_value, which must not be EAX, and EAX.
+	void MMIOWriteRegToAddr(MMIO::Mapping* mmio, Gen::X64Reg reg_value, u32 registers_in_use, u32 address, int access_size);
 
 	enum SafeLoadStoreFlags
 	{
@@ -44,6 +46,12 @@ public:
 		SAFE_LOADSTORE_NO_PROLOG = 2,
 		SAFE_LOADSTORE_NO_FASTMEM = 4
 	};
+	// Looks reg_addr up in the data TLB using two free caller saved registers.
+	// On a hit in MEM1 falls through with the physical address in *reg_phys;
+	// otherwise takes one of the two *miss branches. Returns false, emitting
+	// nothing, when there are no registers to spare.
+	bool TLBProbe(Gen::X64Reg reg_addr, u32 registersInUse, Gen::X64Reg* reg_phys, Gen::FixupBranch* miss);
+
 	void SafeLoadToReg(Gen::X64Reg reg_value, const Gen::OpArg & opAddress, int accessSize, s32 offset, u32 registersInUse, bool signExtend, int flags = 0);
 	void SafeWriteRegToReg(Gen::X64Reg reg_value, Gen::X64Reg reg_addr, int accessSize, s32 offset, u32 registersInUse, int flags = 0);
 
@@ -59,6 +67,10 @@ public:
 	void ForceSinglePrecisionS(Gen::X64Reg xmm);
 	void ForceSinglePrecisionP(Gen::X64Reg xmm);
 
+	// xmm = xmm * multiplier +/- addend, negated for the fnmadd/fnmsub forms.
+	// If fused, it rounds only once, like the hardware, which needs FMA3.
+	void MultiplyAdd(Gen::X64Reg xmm, Gen::X64Reg multiplier, const Gen::OpArg& addend, bool subtract, bool negate, bool packed, bool fused);
+
 	// AX might get trashed
 	void ConvertSingleToDouble(Gen::X64Reg dst, Gen::X64Reg src, bool src_is_gpr = false);
 	void ConvertDoubleToSingle(Gen::X64Reg dst, Gen::X64Reg src);
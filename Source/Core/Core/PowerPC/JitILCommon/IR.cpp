@@ -887,11 +887,12 @@ InstLoc IRBuilder::FoldBranchCond(InstLoc Op1, InstLoc Op2) {
 }
 
 InstLoc IRBuilder::FoldIdleBranch(InstLoc Op1, InstLoc Op2) {
-	return EmitBiOp(
-		IdleBranch,
-		EmitICmpEq(getOp1(getOp1(Op1)),
-		getOp2(getOp1(Op1))), Op2
-		);
+	if (isImm(*Op1)) {
+		if (GetImmValue(Op1))
+			return EmitShortIdleLoop(Op2);
+		return nullptr;
+	}
+	return EmitBiOp(IdleBranch, Op1, Op2);
 }
 
 InstLoc IRBuilder::FoldICmp(unsigned Opcode, InstLoc Op1, InstLoc Op2) {
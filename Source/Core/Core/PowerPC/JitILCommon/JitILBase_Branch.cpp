@@ -53,8 +53,9 @@ void JitILBase::bx(UGeckoInstruction inst)
 	else
 		destination = js.compilerPC + SignExt26(inst.LI << 2);
 
-	if (destination == js.compilerPC) {
-		ibuild.EmitShortIdleLoop(ibuild.EmitIntConst(js.compilerPC));
+	if (destination == js.compilerPC ||
+	    (SConfig::GetInstance().m_LocalCoreStartupParameter.bSkipIdle && js.op->branchIsIdleLoop)) {
+		ibuild.EmitShortIdleLoop(ibuild.EmitIntConst(destination));
 		return;
 	}
 
@@ -113,12 +114,7 @@ void JitILBase::bcx(UGeckoInstruction inst)
 	else
 		destination = js.compilerPC + SignExt16(inst.BD << 2);
 
-	if (SConfig::GetInstance().m_LocalCoreStartupParameter.bSkipIdle &&
-		inst.hex == 0x4182fff8 &&
-		(Memory::ReadUnchecked_U32(js.compilerPC - 8) & 0xFFFF0000) == 0x800D0000 &&
-		(Memory::ReadUnchecked_U32(js.compilerPC - 4) == 0x28000000 ||
-		(SConfig::GetInstance().m_LocalCoreStartupParameter.bWii && Memory::ReadUnchecked_U32(js.compilerPC - 4) == 0x2C000000))
-		)
+	if (SConfig::GetInstance().m_LocalCoreStartupParameter.bSkipIdle && js.op->branchIsIdleLoop)
 	{
 		ibuild.EmitIdleBranch(Test, ibuild.EmitIntConst(destination));
 	}
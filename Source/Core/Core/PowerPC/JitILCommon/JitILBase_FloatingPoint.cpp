@@ -51,7 +51,8 @@ void JitILBase::fmaddXX(UGeckoInstruction inst)
 {
 	INSTRUCTION_START
 	JITDISABLE(bJITFloatingPointOff)
-	if (inst.Rc)
+	// The IR has no fused multiply-add, leave the single rounding to the interpreter.
+	if (inst.Rc || Core::g_CoreStartupParameter.bFusedMultiplyAdd)
 	{
 		FallBackToInterpreter(inst);
 		return;
@@ -144,7 +144,8 @@ void JitILBase::ps_maddXX(UGeckoInstruction inst)
 	INSTRUCTION_START
 	JITDISABLE(bJITPairedOff)
 
-	if (inst.Rc)
+	// The IR has no fused multiply-add, leave the single rounding to the interpreter.
+	if (inst.Rc || Core::g_CoreStartupParameter.bFusedMultiplyAdd)
 	{
 		FallBackToInterpreter(inst);
 		return;
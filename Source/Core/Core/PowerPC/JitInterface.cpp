@@ -12,6 +12,7 @@
 
 #include "Core/ConfigManager.h"
 #include "Core/HW/Memmap.h"
+#include "Core/PowerPC/CachedInterpreter.h"
 #include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
 #include "Core/PowerPC/Profiler.h"
@@ -34,6 +35,9 @@
 bool bFakeVMEM = false;
 bool bMMU = false;
 
+// How many of the hottest blocks the profile results start with.
+static const size_t NUM_TOP_BLOCKS = 20;
+
 namespace JitInterface
 {
 	void DoState(PointerWrap &p)
@@ -73,6 +77,11 @@ namespace JitInterface
 				break;
 			}
 			#endif
+			case 5:
+			{
+				ptr = new CachedInterpreter();
+				break;
+			}
 			default:
 			{
 				PanicAlert("Unrecognizable cpu_core: %d", core);
@@ -82,6 +91,8 @@ namespace JitInterface
 		}
 		jit = static_cast<JitBase*>(ptr);
 		jit->Init();
+		if (SConfig::GetInstance().m_LocalCoreStartupParameter.bJITPerfMap)
+			jit->GetBlockCache()->EnablePerfMap();
 		return ptr;
 	}
 	void InitTables(int core)
@@ -112,6 +123,11 @@ namespace JitInterface
 				break;
 			}
 			#endif
+			case 5:
+			{
+				// Uses the interpreter's tables.
+				break;
+			}
 			default:
 			{
 				PanicAlert("Unrecognizable cpu_core: %d", core);
@@ -132,26 +148,19 @@ namespace JitInterface
 		std::vector<BlockStat> stats;
 		stats.reserve(jit->GetBlockCache()->GetNumBlocks());
 		u64 cost_sum = 0;
-	#ifdef _WIN32
 		u64 timecost_sum = 0;
-		u64 countsPerSec;
-		QueryPerformanceFrequency((LARGE_INTEGER *)&countsPerSec);
-	#endif
+		u64 countsPerSec = Profiler::GetCountsPerSecond();
 		for (int i = 0; i < jit->GetBlockCache()->GetNumBlocks(); i++)
 		{
 			const JitBlock *block = jit->GetBlockCache()->GetBlock(i);
 			// Rough heuristic.  Mem instructions should cost more.
 			u64 cost = block->originalSize * (block->runCount / 4);
-	#ifdef _WIN32
 			u64 timecost = block->ticCounter;
-	#endif
 			// Todo: tweak.
 			if (block->runCount >= 1)
-				stats.push_back(BlockStat(i, cost));
+				stats.push_back(BlockStat(i, cost, timecost));
 			cost_sum += cost;
-	#ifdef _WIN32
 			timecost_sum += timecost;
-	#endif
 		}
 
 		sort(stats.begin(), stats.end());
@@ -161,7 +170,24 @@ namespace JitInterface
 			PanicAlert("Failed to open %s", filename.c_str());
 			return;
 		}
-		fprintf(f.GetHandle(), "origAddr\tblkName\tcost\ttimeCost\tpercent\ttimePercent\tOvAllinBlkTime(ms)\tblkCodeSize\n");
+
+		// The blocks most of the time went to, with the share they add up to.
+		fprintf(f.GetHandle(), "rank\torigAddr\tblkName\ttimePercent\ttotalTimePercent\n");
+		double totalTimePercent = 0.0;
+		for (size_t rank = 0; rank < std::min<size_t>(stats.size(), NUM_TOP_BLOCKS); rank++)
+		{
+			const JitBlock *block = jit->GetBlockCache()->GetBlock(stats[rank].blockNum);
+			double timePercent = timecost_sum ? 100.0 * (double)stats[rank].timeCost / (double)timecost_sum : 0.0;
+			totalTimePercent += timePercent;
+			fprintf(f.GetHandle(), "%i\t%08x\t%s\t%.2lf\t%.2lf\n", (int)rank + 1, block->originalAddress,
+					g_symbolDB.GetDescription(block->originalAddress).c_str(), timePercent, totalTimePercent);
+		}
+		fprintf(f.GetHandle(), "\n");
+
+		u64 fallbacks_sum = 0;
+		u64 exit_stores_sum = 0;
+		u64 dead_stores_sum = 0;
+		fprintf(f.GetHandle(), "origAddr\tblkName\tcost\ttimeCost\tpercent\ttimePercent\tOvAllinBlkTime(ms)\tblkCodeSize\trunCount\ttier\tcyclesPerInst\tbaseCyclesPerInst\tfallbacks\texitStores\tdeadStores\n");
 		for (auto& stat : stats)
 		{
 			const JitBlock *block = jit->GetBlockCache()->GetBlock(stat.blockNum);
@@ -169,18 +195,51 @@ namespace JitInterface
 			{
 				std::string name = g_symbolDB.GetDescription(block->originalAddress);
 				double percent = 100.0 * (double)stat.cost / (double)cost_sum;
-	#ifdef _WIN32
-				double timePercent = 100.0 * (double)block->ticCounter / (double)timecost_sum;
-				fprintf(f.GetHandle(), "%08x\t%s\t%" PRIu64 "\t%" PRIu64 "\t%.2lf\t%llf\t%lf\t%i\n",
+				double timePercent = timecost_sum ? 100.0 * (double)stat.timeCost / (double)timecost_sum : 0.0;
+				// Timer counts per guest instruction, before and after the block
+				// was promoted to the optimizing tier.
+				u64 numInstructions = (u64)block->runCount * block->originalSize;
+				double cyclesPerInst = numInstructions ? (double)stat.timeCost / (double)numInstructions : 0.0;
+				double baseCyclesPerInst = 0.0;
+				const JitBlockBaseline *baseline = jit->GetBlockCache()->GetPromotionBaseline(block->originalAddress);
+				if (baseline && baseline->numInstructions)
+					baseCyclesPerInst = (double)baseline->ticCounter / (double)baseline->numInstructions;
+				// Calls into the interpreter made by the block.
+				u64 fallbacks = (u64)block->runCount * block->numFallbacks;
+				fallbacks_sum += fallbacks;
+				// Register stores at the exits, and the ones the liveness found
+				// dead and left out, as compiled.
+				exit_stores_sum += block->numExitStores;
+				dead_stores_sum += block->numDeadStores;
+				fprintf(f.GetHandle(), "%08x\t%s\t%" PRIu64 "\t%" PRIu64 "\t%.2lf\t%.2lf\t%lf\t%i\t%i\t%i\t%.2lf\t%.2lf\t%" PRIu64 "\t%i\t%i\n",
 						block->originalAddress, name.c_str(), stat.cost,
-						block->ticCounter, percent, timePercent,
-						(double)block->ticCounter*1000.0/(double)countsPerSec, block->codeSize);
-	#else
-				fprintf(f.GetHandle(), "%08x\t%s\t%" PRIu64 "\t???\t%.2lf\t???\t???\t%i\n",
-						block->originalAddress, name.c_str(), stat.cost,  percent, block->codeSize);
-	#endif
+						stat.timeCost, percent, timePercent,
+						(double)stat.timeCost*1000.0/(double)countsPerSec, block->codeSize, block->runCount,
+						block->tier, cyclesPerInst, baseCyclesPerInst, fallbacks,
+						block->numExitStores, block->numDeadStores);
 			}
 		}
+
+		const JitBlockCacheStats& cacheStats = jit->GetBlockCache()->GetStats();
+		fprintf(f.GetHandle(), "\nevictions\tevictedBlocks\trecompilations\tflushes\tpromotions\tfallbacks\texitStores\tdeadStores\n");
+		fprintf(f.GetHandle(), "%" PRIu64 "\t%" PRIu64 "\t%" PRIu64 "\t%" PRIu64 "\t%" PRIu64 "\t%" PRIu64 "\t%" PRIu64 "\t%" PRIu64 "\n",
+				cacheStats.numEvictions, cacheStats.numEvictedBlocks,
+				cacheStats.numRecompilations, cacheStats.numFlushes,
+				cacheStats.numPromotions, fallbacks_sum, exit_stores_sum, dead_stores_sum);
+
+		fprintf(f.GetHandle(), "\nidleLoopAddr\tfuncName\tnumIdles\n");
+		for (const auto& idle_loop : PowerPC::GetIdleLoopCounts())
+		{
+			fprintf(f.GetHandle(), "%08x\t%s\t%" PRIu64 "\n", idle_loop.first,
+					g_symbolDB.GetDescription(idle_loop.first).c_str(), idle_loop.second);
+		}
+
+		fprintf(f.GetHandle(), "\ninlinedAddr\tfuncName\tnumInlines\n");
+		for (const auto& inlined : jit->GetBlockCache()->GetInlineCounts())
+		{
+			fprintf(f.GetHandle(), "%08x\t%s\t%" PRIu64 "\n", inlined.first,
+					g_symbolDB.GetDescription(inlined.first).c_str(), inlined.second);
+		}
 		#endif
 	}
 	bool IsInCodeSpace(u8 *ptr)
@@ -9,12 +9,14 @@
 
 #include "Core/ConfigManager.h"
 #include "Core/GeckoCode.h"
+#include "Core/HLE/HLE.h"
 #include "Core/HW/Memmap.h"
 #include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/PPCAnalyst.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
 #include "Core/PowerPC/PPCTables.h"
 #include "Core/PowerPC/SignatureDB.h"
+#include "Core/PowerPC/JitCommon/JitBase.h"
 #include "Core/PowerPC/JitCommon/JitCache.h"
 
 // Analyzes PowerPC code in memory to find functions
@@ -35,6 +37,14 @@ using namespace std;
 static const int CODEBUFFER_SIZE = 32000;
 // 0 does not perform block merging
 static const int FUNCTION_FOLLOWING_THRESHOLD = 16;
+// How far a block continues past an unconditional forward branch, in bytes.
+static const u32 FORWARD_JUMP_DISTANCE = 0x40;
+// Largest function that gets inlined, in instructions including the blr.
+static const u32 INLINE_LEAF_MAX_SIZE = 16;
+// How far the register liveness looks into the blocks a block exits to.
+static const u32 LIVENESS_LOOKAHEAD = 8;
+// Largest loop that can be an idle loop, in instructions including the branch.
+static const u32 IDLE_LOOP_MAX_SIZE = 8;
 
 CodeBuffer::CodeBuffer(int size)
 {
@@ -423,6 +433,9 @@ void PPCAnalyzer::ReorderInstructions(u32 instructions, CodeOp *code)
 	{
 		CodeOp &a = code[i];
 		CodeOp &b = code[i + 1];
+		// Jumps to either of them must still see them in order.
+		if (a.isBranchTarget || b.isBranchTarget)
+			continue;
 		// All integer compares can be reordered.
 		if ((a.inst.OPCD == 10 || a.inst.OPCD == 11) ||
 			(a.inst.OPCD == 31 && (a.inst.SUBOP10 == 0 || a.inst.SUBOP10 == 32)))
@@ -438,6 +451,246 @@ void PPCAnalyzer::ReorderInstructions(u32 instructions, CodeOp *code)
 	}
 }
 
+void PPCAnalyzer::FindInBlockBranches(u32 instructions, CodeOp *code)
+{
+	// Instructions of the block itself are contiguous, inlined functions are
+	// not part of this.
+	const u32 start = code[0].address;
+	u32 end = start;
+	for (u32 i = 0; i < instructions; ++i)
+	{
+		if (!code[i].inlined)
+			end = code[i].address;
+	}
+
+	for (u32 i = 0; i < instructions; ++i)
+	{
+		UGeckoInstruction inst = code[i].inst;
+		u32 destination;
+		if (inst.OPCD == 16 && !inst.LK)
+			destination = (inst.AA ? 0 : code[i].address) + SignExt16(inst.BD << 2);
+		else if (inst.OPCD == 18 && !inst.LK)
+			destination = (inst.AA ? 0 : code[i].address) + SignExt26(inst.LI << 2);
+		else
+			continue;
+
+		// Branches to themselves are idle loops, which are better left to the
+		// dispatcher.
+		if (destination < start || destination > end || destination == code[i].address)
+			continue;
+
+		u32 index = (destination - start) / 4;
+		// Skip over the inlined instructions in between.
+		for (u32 j = 0; j <= index && index < instructions; ++j)
+		{
+			if (code[j].inlined)
+				++index;
+		}
+		if (index >= instructions || code[index].address != destination)
+			continue;
+		if (index < i && !HasOption(OPTION_COMPLEX_BLOCK))
+			continue;
+		if (index > i && !HasOption(OPTION_FORWARD_JUMP))
+			continue;
+
+		code[i].branchTo = destination;
+		code[i].branchToIndex = index;
+		code[index].isBranchTarget = true;
+	}
+}
+
+// Returns the size in instructions of the function at address, if it is a leaf
+// which can be inlined: straight-line code ending in blr, which leaves LR alone.
+// Returns 0 otherwise.
+u32 PPCAnalyzer::GetInlinableLeafSize(u32 address)
+{
+	// HLE may replace the function.
+	if (HLE::GetFunctionIndex(address) != 0)
+		return 0;
+
+	for (u32 i = 0; i < INLINE_LEAF_MAX_SIZE; ++i)
+	{
+		UGeckoInstruction inst = JitInterface::Read_Opcode_JIT(address + i * 4);
+		if (inst.hex == 0x4e800020) // blr
+			return i + 1;
+
+		if (inst.hex == 0)
+			return 0;
+		const GekkoOPInfo *opinfo = GetOpInfo(inst);
+		if (opinfo->type == OPTYPE_BRANCH || (opinfo->flags & (FL_ENDBLOCK | FL_EVIL)))
+			return 0;
+		// mtlr
+		if (inst.OPCD == 31 && inst.SUBOP10 == 467 && ((inst.SPRU << 5) | (inst.SPRL & 0x1F)) == SPR_LR)
+			return 0;
+	}
+	return 0;
+}
+
+// What an instruction reads, and what it overwrites completely, for the
+// liveness passes. Bit n is rn or CRn. Instructions whose operands the flags
+// don't fully describe read everything, as do the ones which may leave the
+// block, and the ones which may raise an exception: the handler may look at
+// any register before it resumes at the instruction.
+struct OpUsage
+{
+	u32 gprIn, gprOut;
+	u8 crIn, crOut;
+	bool caIn, caOut;
+};
+
+static bool IsBranch(const UGeckoInstruction inst)
+{
+	return inst.OPCD == 16 || inst.OPCD == 18 ||
+	       (inst.OPCD == 19 && (inst.SUBOP10 == 16 || inst.SUBOP10 == 528));
+}
+
+static void GetOpUsage(const UGeckoInstruction inst, const GekkoOPInfo *opinfo, u32 address, OpUsage *usage)
+{
+	memset(usage, 0, sizeof(OpUsage));
+
+	if (opinfo->flags & FL_OUT_A)
+		usage->gprOut |= 1 << inst.RA;
+	if (opinfo->flags & FL_OUT_D)
+		usage->gprOut |= 1 << inst.RD;
+	if ((opinfo->flags & FL_IN_A) || (opinfo->flags & FL_IN_A0))
+		usage->gprIn |= 1 << inst.RA;
+	if (opinfo->flags & FL_IN_B)
+		usage->gprIn |= 1 << inst.RB;
+	if (opinfo->flags & FL_IN_C)
+		usage->gprIn |= 1 << inst.RC;
+	if (opinfo->flags & FL_IN_S)
+		usage->gprIn |= 1 << inst.RS;
+
+	if (opinfo->flags & FL_SET_CRn)
+		usage->crOut |= 1 << inst.CRFD;
+	if ((opinfo->flags & FL_SET_CR0) || ((opinfo->flags & FL_RC_BIT) && inst.Rc))
+		usage->crOut |= 1 << 0;
+	if ((opinfo->flags & FL_SET_CR1) || ((opinfo->flags & FL_RC_BIT_F) && inst.Rc))
+		usage->crOut |= 1 << 1;
+
+	usage->caIn = (opinfo->flags & FL_READ_CA) != 0;
+	usage->caOut = (opinfo->flags & FL_SET_CA) != 0;
+
+	bool precise;
+	switch (opinfo->type)
+	{
+	case OPTYPE_INTEGER:
+		precise = true;
+		break;
+	case OPTYPE_LOAD:
+		// DSI, which is only raised with the MMU emulated.
+		precise = !Core::g_CoreStartupParameter.bMMU;
+		break;
+	case OPTYPE_STORE:
+		// The JITs check for external exceptions before the stores known to
+		// write to the FIFO.
+		precise = !Core::g_CoreStartupParameter.bMMU &&
+			!(jit && jit->js.fifoWriteAddresses.count(address));
+		break;
+	default:
+		// Including the floating point instructions: FPU unavailable.
+		precise = false;
+		break;
+	}
+	if (opinfo->flags & (FL_ENDBLOCK | FL_EVIL | FL_CHECKEXCEPTIONS | FL_USE_FPU))
+		precise = false;
+	// HLE functions read their arguments from the registers.
+	if (!precise || IsBranch(inst) || HLE::GetFunctionIndex(address) != 0)
+	{
+		usage->gprIn = 0xffffffff;
+		usage->crIn = 0xff;
+		usage->caIn = true;
+	}
+}
+
+// The GPRs which may be read by the code at address before they are written,
+// looking at the straight-line code there. Registers the code there overwrites
+// are dead on the way in. That code is added to block->m_inlined, since the
+// block relies on it staying the same.
+u32 PPCAnalyzer::GetLiveGPRsAt(u32 address, CodeBlock *block)
+{
+	if (!HasOption(OPTION_SUCCESSOR_LIVENESS))
+		return 0xffffffff;
+
+	u32 read = 0, written = 0;
+	u32 size = 0;
+	for (; size < LIVENESS_LOOKAHEAD; ++size)
+	{
+		u32 op_address = address + size * 4;
+		UGeckoInstruction inst = JitInterface::Read_Opcode_JIT(op_address);
+		if (inst.hex == 0)
+			break;
+		OpUsage usage;
+		GetOpUsage(inst, GetOpInfo(inst), op_address, &usage);
+		if (usage.gprIn == 0xffffffff)
+			break;
+		read |= usage.gprIn & ~written;
+		written |= usage.gprOut;
+	}
+
+	u32 dead = written & ~read;
+	if (dead)
+		block->m_inlined.push_back(std::make_pair(address, size));
+	return ~dead;
+}
+
+// Finds the loops which only wait for memory to change: a flag set by an
+// interrupt handler, the VI retrace count, a register polled through MMIO.
+// Such a loop only loads and computes, and every iteration computes the same
+// as the one before unless memory changed, so nothing happens until the next
+// event and the JITs can skip ahead to it. Registers, CR fields and the
+// carry the loop reads must either not be written in it, or be written
+// before they're read.
+void PPCAnalyzer::FindIdleLoops(u32 instructions, CodeOp *code)
+{
+	for (u32 i = 0; i < instructions; ++i)
+	{
+		UGeckoInstruction inst = code[i].inst;
+		u32 destination;
+		if (inst.OPCD == 16 && !inst.LK && (inst.BO & BO_DONT_DECREMENT_FLAG))
+			destination = (inst.AA ? 0 : code[i].address) + SignExt16(inst.BD << 2);
+		else if (inst.OPCD == 18 && !inst.LK)
+			destination = (inst.AA ? 0 : code[i].address) + SignExt26(inst.LI << 2);
+		else
+			continue;
+		if (destination > code[i].address)
+			continue;
+		u32 size = (code[i].address - destination) / 4 + 1;
+		if (size > IDLE_LOOP_MAX_SIZE || size > i + 1)
+			continue;
+
+		// The loop has to be straight-line code of the block, ending here.
+		u32 start = i + 1 - size;
+		bool idle = true;
+		u32 gprRead = 0, gprWritten = 0;
+		u8 crRead = 0, crWritten = 0;
+		bool caRead = false, caWritten = false;
+		for (u32 j = start; j < i && idle; ++j)
+		{
+			if (code[j].inlined || code[j].skip ||
+			    code[j].address < destination || code[j].address > code[i].address ||
+			    (code[j].opinfo->type != OPTYPE_INTEGER && code[j].opinfo->type != OPTYPE_LOAD))
+			{
+				idle = false;
+				break;
+			}
+			OpUsage usage;
+			GetOpUsage(code[j].inst, code[j].opinfo, code[j].address, &usage);
+			gprRead |= usage.gprIn & ~gprWritten;
+			crRead |= usage.crIn & ~crWritten;
+			caRead |= usage.caIn && !caWritten;
+			if ((usage.gprOut & gprRead) || (usage.crOut & crRead) || (usage.caOut && caRead))
+				idle = false;
+			gprWritten |= usage.gprOut;
+			crWritten |= usage.crOut;
+			caWritten |= usage.caOut;
+		}
+		code[i].branchIsIdleLoop = idle;
+		if (idle)
+			DEBUG_LOG(DYNA_REC, "Idle loop at %08x", destination);
+	}
+}
+
 void PPCAnalyzer::SetInstructionStats(CodeBlock *block, CodeOp *code, GekkoOPInfo *opinfo, u32 index)
 {
 	code->wantsCR0 = false;
@@ -556,6 +809,7 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock *block, CodeBuffer *buffer, u32
 	block->m_broken = false;
 	block->m_memory_exception = false;
 	block->m_num_instructions = 0;
+	block->m_inlined.clear();
 
 	if (address == 0)
 	{
@@ -578,6 +832,7 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock *block, CodeBuffer *buffer, u32
 
 	bool found_exit = false;
 	u32 return_address = 0;
+	u32 inline_blr_address = 0;
 	u32 numFollows = 0;
 	u32 num_inst = 0;
 
@@ -609,47 +864,46 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock *block, CodeBuffer *buffer, u32
 			// Do we inline leaf functions?
 			if (HasOption(OPTION_LEAF_INLINE))
 			{
-				if (inst.OPCD == 18 && blockSize > 1)
+				if (inst.OPCD == 18 && inst.LK && return_address == 0 &&
+				    numFollows < FUNCTION_FOLLOWING_THRESHOLD)
 				{
-					//Is bx - should we inline? yes!
-					if (inst.AA)
-						destination = SignExt26(inst.LI << 2);
-					else
-						destination = address + SignExt26(inst.LI << 2);
-					if (destination != block->m_address)
+					// bl - continue in the called function if it is small
+					// enough and is guaranteed to return right after.
+					destination = (inst.AA ? 0 : address) + SignExt26(inst.LI << 2);
+					u32 size = GetInlinableLeafSize(destination);
+					if (size && i + size < blockSize)
+					{
 						follow = true;
-				}
-				else if (inst.OPCD == 19 && inst.SUBOP10 == 16 &&
-					(inst.BO & (1 << 4)) && (inst.BO & (1 << 2)) &&
-					return_address != 0)
-				{
-					// bclrx with unconditional branch = return
-					follow = true;
-					destination = return_address;
-					return_address = 0;
-
-					if (inst.LK)
+						numFollows++;
 						return_address = address + 4;
+						inline_blr_address = destination + (size - 1) * 4;
+						block->m_inlined.push_back(std::make_pair(destination, size));
+					}
 				}
-				else if (inst.OPCD == 31 && inst.SUBOP10 == 467)
+				else if (return_address != 0)
 				{
-					// mtspr
-					const u32 index = (inst.SPRU << 5) | (inst.SPRL & 0x1F);
-					if (index == SPR_LR) {
-						// We give up to follow the return address
-						// because we have to check the register usage.
+					code[i].inlined = true;
+					if (address == inline_blr_address)
+					{
+						// The blr of the inlined function, back to the caller.
+						code[i].skip = true;
+						follow = true;
+						destination = return_address;
 						return_address = 0;
 					}
 				}
+			}
 
-				// TODO: Find the optimal value for FUNCTION_FOLLOWING_THRESHOLD.
-				//       If it is small, the performance will be down.
-				//       If it is big, the size of generated code will be big and
-				//       cache clearning will happen many times.
-				// TODO: Investivate the reason why
-				//       "0" is fastest in some games, MP2 for example.
-				if (numFollows > FUNCTION_FOLLOWING_THRESHOLD)
-					follow = false;
+			if (HasOption(OPTION_FORWARD_JUMP))
+			{
+				if (inst.OPCD == 18 && !inst.LK && !inst.AA)
+				{
+					// Short unconditional forward branch, e.g. skipping the else
+					// part of an if. Continue the block up to its destination.
+					u32 distance = SignExt26(inst.LI << 2);
+					if ((s32)distance > 0 && distance <= FORWARD_JUMP_DISTANCE && i + distance / 4 < blockSize)
+						conditional_continue = true;
+				}
 			}
 
 			if (HasOption(OPTION_CONDITIONAL_CONTINUE))
@@ -690,18 +944,13 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock *block, CodeBuffer *buffer, u32
 				}
 				address += 4;
 			}
-			// XXX: We don't support inlining yet.
-#if 0
 			else
 			{
-				numFollows++;
 				// We don't "code[i].skip = true" here
 				// because bx may store a certain value to the link register.
 				// Instead, we skip a part of bx in Jit**::bx().
 				address = destination;
-				merged_addresses[size_of_merged_addresses++] = address;
 			}
-#endif
 		}
 		else
 		{
@@ -711,8 +960,13 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock *block, CodeBuffer *buffer, u32
 		}
 	}
 
-	if (block->m_num_instructions > 1)
-		ReorderInstructions(block->m_num_instructions, code);
+	if ((HasOption(OPTION_COMPLEX_BLOCK) || HasOption(OPTION_FORWARD_JUMP)) && num_inst > 0)
+		FindInBlockBranches(num_inst, code);
+
+	if (HasOption(OPTION_REORDER) && num_inst > 1)
+		ReorderInstructions(num_inst, code);
+
+	FindIdleLoops(num_inst, code);
 
 	if ((!found_exit && num_inst > 0) || blockSize == 1)
 	{
@@ -740,6 +994,64 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock *block, CodeBuffer *buffer, u32
 		code[i].wantsCR1 = wantsCR1;
 		code[i].wantsPS1 = wantsPS1;
 	}
+	// Liveness, for skipping work whose result is overwritten before it's read:
+	// stores of compare results only used by the following branch, carries,
+	// and register write backs at the exits. For the GPRs this looks into the
+	// code the block exits to. A broken block continues at address.
+	u32 gprLive = (block->m_broken && !found_exit && num_inst > 0) ? GetLiveGPRsAt(address, block) : 0xffffffff;
+	u8 crLive = 0xff;
+	bool caLive = true;
+	for (int i = num_inst - 1; i >= 0; i--)
+	{
+		UGeckoInstruction inst = code[i].inst;
+		code[i].crLiveAfter = crLive;
+		code[i].caLiveAfter = caLive;
+
+		if (code[i].skip)
+		{
+			code[i].gprLiveAfter = gprLive;
+			continue;
+		}
+
+		OpUsage usage;
+		GetOpUsage(inst, code[i].opinfo, code[i].address, &usage);
+		crLive = (crLive & ~usage.crOut) | usage.crIn;
+		caLive = (caLive && !usage.caOut) || usage.caIn;
+
+		if (IsBranch(inst))
+		{
+			// Either side of the branch may be taken.
+			bool conditional = (inst.OPCD == 16 || inst.OPCD == 19) &&
+				((inst.BO & BO_DONT_DECREMENT_FLAG) == 0 || (inst.BO & BO_DONT_CHECK_CONDITION) == 0);
+			bool last = i == (int)num_inst - 1;
+			u32 fallthrough = 0;
+			if (conditional)
+				fallthrough = last ? GetLiveGPRsAt(code[i].address + 4, block) : gprLive;
+
+			u32 target = 0xffffffff;
+			if (inst.OPCD == 16 || inst.OPCD == 18)
+			{
+				u32 offset = inst.OPCD == 16 ? SignExt16(inst.BD << 2) : SignExt26(inst.LI << 2);
+				u32 destination = (inst.AA ? 0 : code[i].address) + offset;
+				// A followed branch just continues with the destination. A loop
+				// may run out of time and take an interrupt on any iteration,
+				// so everything is live at its back edge.
+				if (!last && code[i + 1].address == destination)
+					target = gprLive;
+				else if (destination > code[i].address)
+					target = GetLiveGPRsAt(destination, block);
+			}
+
+			gprLive = fallthrough | target;
+			code[i].gprLiveAfter = gprLive;
+		}
+		else
+		{
+			code[i].gprLiveAfter = gprLive;
+			gprLive = (gprLive & ~usage.gprOut) | usage.gprIn;
+		}
+	}
+
 	block->m_num_instructions = num_inst;
 	return address;
 }
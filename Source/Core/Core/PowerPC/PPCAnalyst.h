@@ -37,7 +37,12 @@ struct CodeOp //16B
 	bool outputCR0;
 	bool outputCR1;
 	bool outputPS1;
+	u8 crLiveAfter; // CR fields that may be read after this instruction, bit n for CRn. Fall through side for branches
+	bool caLiveAfter; // XER[CA] may be read after this instruction
+	u32 gprLiveAfter; // GPRs that may be read after this instruction, including at its branch target
 	bool skip;  // followed BL-s for example
+	bool branchIsIdleLoop; // branch back to a loop which only waits for memory to change
+	bool inlined; // part of a function inlined into the block
 };
 
 struct BlockStats
@@ -127,6 +132,11 @@ struct CodeBlock
 
 	// Did we have a memory_exception?
 	bool m_memory_exception;
+
+	// Code outside the block which it depends on: start address, number of
+	// instructions. Inlined functions, and the code at the exits which the
+	// register liveness looked at.
+	std::vector<std::pair<u32, u32>> m_inlined;
 };
 
 class PPCAnalyzer
@@ -134,6 +144,10 @@ class PPCAnalyzer
 private:
 
 	void ReorderInstructions(u32 instructions, CodeOp *code);
+	void FindInBlockBranches(u32 instructions, CodeOp *code);
+	void FindIdleLoops(u32 instructions, CodeOp *code);
+	u32 GetInlinableLeafSize(u32 address);
+	u32 GetLiveGPRsAt(u32 address, CodeBlock *block);
 	void SetInstructionStats(CodeBlock *block, CodeOp *code, GekkoOPInfo *opinfo, u32 index);
 
 	// Options
@@ -148,23 +162,34 @@ public:
 		// Requires JIT support to be enabled.
 		OPTION_CONDITIONAL_CONTINUE = (1 << 0),
 
-		// If there is a unconditional branch that jumps to a leaf function then inline it.
-		// Might require JIT intervention to support it correctly.
-		// Requires JITBLock support for inlined code
-		// XXX: NOT COMPLETE
+		// If there is a bl to a short, branchless leaf function then inline it.
+		// The bl still has to set LR, the blr at the end of the inlined
+		// function is skipped. The JIT needs to treat a bx followed by its
+		// destination as falling through, and tell the block cache about
+		// CodeBlock::m_inlined.
 		OPTION_LEAF_INLINE = (1 << 1),
 
 		// Complex blocks support jumping backwards on to themselves.
 		// Happens commonly in loops, pretty complex to support.
-		// May require register caches to use register usage metrics.
-		// XXX: NOT COMPLETE
+		// Branches which stay within the block get branchTo/branchToIndex set,
+		// and their targets isBranchTarget.
+		// Requires JIT support to work.
 		OPTION_COMPLEX_BLOCK = (1 << 2),
 
 		// Similar to complex blocks.
 		// Instead of jumping backwards, this jumps forwards within the block.
+		// The block also continues past short unconditional forward branches.
 		// Requires JIT support to work.
-		// XXX: NOT COMPLETE
 		OPTION_FORWARD_JUMP = (1 << 3),
+
+		// Bubble compares down towards the branches that use them, so that the
+		// JIT can merge them. Costs an extra pass over the block.
+		OPTION_REORDER = (1 << 4),
+
+		// Look into the code at the block's exits to find registers it
+		// overwrites, so the JIT can skip writing them back. The block
+		// depends on that code, see CodeBlock::m_inlined.
+		OPTION_SUCCESSOR_LIVENESS = (1 << 5),
 	};
 
 
@@ -39,6 +39,8 @@ BreakPoints breakpoints;
 MemChecks memchecks;
 PPCDebugInterface debug_interface;
 
+static std::map<u32, u64> s_idle_loop_counts;
+
 u32 CompactCR()
 {
 	u32 new_cr = ppcState.cr_fast[0] << 28;
@@ -117,12 +119,8 @@ void Init(int cpu_core)
 
 	memset(ppcState.sr, 0, sizeof(ppcState.sr));
 	ppcState.DebugCount = 0;
-	ppcState.dtlb_last = 0;
-	memset(ppcState.dtlb_va, 0, sizeof(ppcState.dtlb_va));
-	memset(ppcState.dtlb_pa, 0, sizeof(ppcState.dtlb_pa));
-	ppcState.itlb_last = 0;
-	memset(ppcState.itlb_va, 0, sizeof(ppcState.itlb_va));
-	memset(ppcState.itlb_pa, 0, sizeof(ppcState.itlb_pa));
+	s_idle_loop_counts.clear();
+	Memory::InvalidateTLB();
 	ppcState.pagetable_base = 0;
 	ppcState.pagetable_hashmask = 0;
 
@@ -510,11 +508,17 @@ void OnIdle(u32 _uThreadAddr)
 		CoreTiming::Idle();
 }
 
-void OnIdleIL()
+void OnIdleLoop(u32 address)
 {
+	s_idle_loop_counts[address]++;
 	CoreTiming::Idle();
 }
 
+const std::map<u32, u64>& GetIdleLoopCounts()
+{
+	return s_idle_loop_counts;
+}
+
 }  // namespace
 
 
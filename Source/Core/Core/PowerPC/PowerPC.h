@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <map>
+
 #include "Common/BreakPoints.h"
 #include "Common/Common.h"
 
@@ -25,6 +27,30 @@ enum CoreMode
 	MODE_JIT,
 };
 
+// The software TLB: one for data and one for instructions, each 2-way set
+// associative over the low bits of the effective page number.
+enum
+{
+	TLB_SIZE = 128,
+	TLB_WAYS = 2,
+	TLB_SETS = TLB_SIZE / TLB_WAYS,
+	NUM_TLBS = 2,
+	TLB_INDEX_DATA = 0,
+	TLB_INDEX_INSTRUCTION = 1,
+	// Never equal to the page aligned tag of an address.
+	TLB_TAG_INVALID = 0xffffffff,
+};
+
+// JIT code probes the data TLB inline, and depends on this layout.
+struct TLBSet
+{
+	u32 tag[TLB_WAYS];
+	u32 paddr[TLB_WAYS];
+	u32 recent;  // The most recently used way.
+	u32 padding[3];
+};
+static_assert(sizeof(TLBSet) == 32, "JIT TLB probe relies on the set size");
+
 // This contains the entire state of the emulated PowerPC "Gekko" CPU.
 struct GC_ALIGNED64(PowerPCState)
 {
@@ -54,13 +80,8 @@ struct GC_ALIGNED64(PowerPCState)
 	// also for power management, but we don't care about that.
 	u32 spr[1024];
 
-	u32 dtlb_last;
-	u32 dtlb_va[128];
-	u32 dtlb_pa[128];
-
-	u32 itlb_last;
-	u32 itlb_va[128];
-	u32 itlb_pa[128];
+	// In here rather than in Memory so that savestates include it.
+	TLBSet tlb[NUM_TLBS][TLB_SETS];
 
 	u32 pagetable_base;
 	u32 pagetable_hashmask;
@@ -103,7 +124,10 @@ u32 CompactCR();
 void ExpandCR(u32 cr);
 
 void OnIdle(u32 _uThreadAddr);
-void OnIdleIL();
+// Called by the JITs for the loops the analyzer found to only wait.
+void OnIdleLoop(u32 address);
+// How often each of those loops idled, by address, for profiling.
+const std::map<u32, u64>& GetIdleLoopCounts();
 
 void UpdatePerformanceMonitor(u32 cycles, u32 num_load_stores, u32 num_fp_inst);
 
@@ -2,8 +2,19 @@
 // Licensed under GPLv2
 // Refer to the license.txt file included.
 
+#include <chrono>
 #include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <intrin.h>
+#elif _M_X86
+#include <x86intrin.h>
+#endif
+
+#include "Common/Thread.h"
 #include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/Profiler.h"
 
 namespace Profiler
 {
@@ -16,4 +27,30 @@ void WriteProfileResults(const std::string& filename)
 	JitInterface::WriteProfileResults(filename);
 }
 
+u64 GetCountsPerSecond()
+{
+#if defined(_WIN32) && _M_X86_32
+	u64 countsPerSec;
+	QueryPerformanceFrequency((LARGE_INTEGER *)&countsPerSec);
+	return countsPerSec;
+#elif _M_X86_64
+	// The TSC frequency isn't exposed anywhere, so measure it once.
+	static u64 countsPerSec = 0;
+	if (!countsPerSec)
+	{
+		auto start_time = std::chrono::steady_clock::now();
+		u64 start_tsc = __rdtsc();
+		Common::SleepCurrentThread(50);
+		u64 end_tsc = __rdtsc();
+		auto end_time = std::chrono::steady_clock::now();
+
+		double seconds = std::chrono::duration<double>(end_time - start_time).count();
+		countsPerSec = (u64)((end_tsc - start_tsc) / seconds);
+	}
+	return countsPerSec;
+#else
+	return 1;
+#endif
+}
+
 }  // namespace
@@ -7,13 +7,12 @@
 
 #include <string>
 
-#ifdef _WIN32
+#include "Common/CommonTypes.h"
 
-#if _M_X86_32
+#if defined(_WIN32) && _M_X86_32
 #define PROFILER_QUERY_PERFORMANCE_COUNTER(pt)      \
                     LEA(32, EAX, M(pt)); PUSH(EAX); \
                     CALL(QueryPerformanceCounter)
-// TODO: r64 way
 // asm write : (u64) dt += t1-t0
 #define PROFILER_ADD_DIFF_LARGE_INTEGER(pdt, pt1, pt0)  \
                     MOV(32, R(EAX), M(pt1));            \
@@ -29,13 +28,27 @@
 #define PROFILER_VPUSH  PUSH(EAX);PUSH(ECX);PUSH(EDX)
 #define PROFILER_VPOP   POP(EDX);POP(ECX);POP(EAX)
 
-#else
+#elif _M_X86_64
+// Uses the time stamp counter, which is cheap enough to read on every block
+// entry and exit. The counters live in the JitBlocks, which may be further
+// than 2GB away from the generated code, so they are addressed through RCX.
+#define PROFILER_QUERY_PERFORMANCE_COUNTER(pt)      \
+                    RDTSC();                        \
+                    SHL(64, R(RDX), Imm8(32));      \
+                    OR(64, R(RAX), R(RDX));         \
+                    MOV(64, R(RCX), ImmPtr(pt));    \
+                    MOV(64, MatR(RCX), R(RAX))
+// asm write : (u64) dt += t1-t0
+#define PROFILER_ADD_DIFF_LARGE_INTEGER(pdt, pt1, pt0)  \
+                    MOV(64, R(RCX), ImmPtr(pt1));       \
+                    MOV(64, R(RAX), MatR(RCX));         \
+                    MOV(64, R(RCX), ImmPtr(pt0));       \
+                    SUB(64, R(RAX), MatR(RCX));         \
+                    MOV(64, R(RCX), ImmPtr(pdt));       \
+                    ADD(64, MatR(RCX), R(RAX))
 
-#define PROFILER_QUERY_PERFORMANCE_COUNTER(pt)
-#define PROFILER_ADD_DIFF_LARGE_INTEGER(pdt, pt1, pt0)
-#define PROFILER_VPUSH
-#define PROFILER_VPOP
-#endif
+#define PROFILER_VPUSH  PUSH(RAX);PUSH(RCX);PUSH(RDX)
+#define PROFILER_VPOP   POP(RDX);POP(RCX);POP(RAX)
 
 #else
 // TODO
@@ -47,12 +60,15 @@
 
 struct BlockStat
 {
-	BlockStat(int bn, u64 c) : blockNum(bn), cost(c) {}
+	BlockStat(int bn, u64 c, u64 tc) : blockNum(bn), cost(c), timeCost(tc) {}
 	int blockNum;
 	u64 cost;
+	u64 timeCost;
 
+	// Blocks are sorted by the time spent in them, falling back on the cost
+	// heuristic if no timing information is available.
 	bool operator <(const BlockStat &other) const
-	{ return cost > other.cost; }
+	{ return timeCost != other.timeCost ? timeCost > other.timeCost : cost > other.cost; }
 };
 
 namespace Profiler
@@ -61,4 +77,7 @@ extern bool g_ProfileBlocks;
 extern bool g_ProfileInstructions;
 
 void WriteProfileResults(const std::string& filename);
+
+// Number of PROFILER_QUERY_PERFORMANCE_COUNTER ticks per second.
+u64 GetCountsPerSecond();
 }
@@ -69,6 +69,7 @@ const CPUCore CPUCores[] = {
 	{1, wxTRANSLATE("JIT Recompiler (recommended)")},
 	{2, wxTRANSLATE("JITIL Recompiler (slower, experimental)")},
 #endif
+	{5, wxTRANSLATE("Cached Interpreter (slower)")},
 };
 
 extern CFrame* main_frame;
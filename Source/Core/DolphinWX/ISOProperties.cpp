@@ -397,6 +397,8 @@ void CISOProperties::CreateGUIControls(bool IsWad)
 	TLBHack->SetToolTip(_("Fast version of the MMU.  Does not work for every game."));
 	DCBZOFF = new wxCheckBox(m_GameConfig, ID_DCBZOFF, _("Skip DCBZ clearing"), wxDefaultPosition, wxDefaultSize, GetElementStyle("Core", "DCBZ"));
 	DCBZOFF->SetToolTip(_("Bypass the clearing of the data cache by the DCBZ instruction. Usually leave this option disabled."));
+	FusedMultiplyAdd = new wxCheckBox(m_GameConfig, ID_FUSEDMULTIPLYADD, _("Fused Multiply-Add"), wxDefaultPosition, wxDefaultSize, GetElementStyle("Core", "FusedMultiplyAdd"));
+	FusedMultiplyAdd->SetToolTip(_("Rounds the result of multiply-add instructions once, like the console does. Slow on CPUs without FMA3."));
 	VBeam = new wxCheckBox(m_GameConfig, ID_VBEAM, _("VBeam Speed Hack"), wxDefaultPosition, wxDefaultSize, GetElementStyle("Core", "VBeam"));
 	VBeam->SetToolTip(_("Doubles the emulated GPU clock rate. May speed up some games (ON = Fast, OFF = Compatible)"));
 	SyncGPU = new wxCheckBox(m_GameConfig, ID_SYNCGPU, _("Synchronize GPU thread"), wxDefaultPosition, wxDefaultSize, GetElementStyle("Core", "SyncGPU"));
@@ -439,6 +441,7 @@ void CISOProperties::CreateGUIControls(bool IsWad)
 	sbCoreOverrides->Add(MMU, 0, wxLEFT, 5);
 	sbCoreOverrides->Add(TLBHack, 0, wxLEFT, 5);
 	sbCoreOverrides->Add(DCBZOFF, 0, wxLEFT, 5);
+	sbCoreOverrides->Add(FusedMultiplyAdd, 0, wxLEFT, 5);
 	sbCoreOverrides->Add(VBeam, 0, wxLEFT, 5);
 	sbCoreOverrides->Add(SyncGPU, 0, wxLEFT, 5);
 	sbCoreOverrides->Add(FastDiscSpeed, 0, wxLEFT, 5);
@@ -1034,6 +1037,7 @@ void CISOProperties::LoadGameConfig()
 	SetCheckboxValueFromGameini("Core", "MMU", MMU);
 	SetCheckboxValueFromGameini("Core", "TLBHack", TLBHack);
 	SetCheckboxValueFromGameini("Core", "DCBZ", DCBZOFF);
+	SetCheckboxValueFromGameini("Core", "FusedMultiplyAdd", FusedMultiplyAdd);
 	SetCheckboxValueFromGameini("Core", "VBeam", VBeam);
 	SetCheckboxValueFromGameini("Core", "SyncGPU", SyncGPU);
 	SetCheckboxValueFromGameini("Core", "FastDiscSpeed", FastDiscSpeed);
@@ -1111,6 +1115,7 @@ bool CISOProperties::SaveGameConfig()
 	SaveGameIniValueFrom3StateCheckbox("Core", "MMU", MMU);
 	SaveGameIniValueFrom3StateCheckbox("Core", "TLBHack", TLBHack);
 	SaveGameIniValueFrom3StateCheckbox("Core", "DCBZ", DCBZOFF);
+	SaveGameIniValueFrom3StateCheckbox("Core", "FusedMultiplyAdd", FusedMultiplyAdd);
 	SaveGameIniValueFrom3StateCheckbox("Core", "VBeam", VBeam);
 	SaveGameIniValueFrom3StateCheckbox("Core", "SyncGPU", SyncGPU);
 	SaveGameIniValueFrom3StateCheckbox("Core", "FastDiscSpeed", FastDiscSpeed);
@@ -63,7 +63,7 @@ private:
 	DECLARE_EVENT_TABLE();
 
 	// Core
-	wxCheckBox *CPUThread, *SkipIdle, *MMU, *DCBZOFF, *TLBHack;
+	wxCheckBox *CPUThread, *SkipIdle, *MMU, *DCBZOFF, *TLBHack, *FusedMultiplyAdd;
 	wxCheckBox *VBeam, *SyncGPU, *FastDiscSpeed, *BlockMerging, *DSPHLE;
 	// Wii
 	wxCheckBox *EnableWideScreen;
@@ -126,6 +126,7 @@ private:
 		ID_MMU,
 		ID_DCBZOFF,
 		ID_TLBHACK,
+		ID_FUSEDMULTIPLYADD,
 		ID_VBEAM,
 		ID_SYNCGPU,
 		ID_DISCSPEED,
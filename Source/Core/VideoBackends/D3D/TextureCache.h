@@ -26,7 +26,7 @@ private:
 		TCacheEntry(D3DTexture2D *_tex) : texture(_tex) {}
 		~TCacheEntry();
 
-		void Load(unsigned int width, unsigned int height,
+		void Load(const u8* data, unsigned int width, unsigned int height,
 			unsigned int expanded_width, unsigned int levels) override;
 
 		void FromRenderTarget(u32 dstAddr, unsigned int dstFormat,
@@ -132,6 +132,19 @@ void Init()
 	et_UpdateInterrupts = CoreTiming::RegisterEvent("CPInterrupt", UpdateInterrupts_Wrapper);
 }
 
+// In dual core, writing the FIFO pointers can hand the GPU thread new work,
+// so it is woken up rather than left to sleep out its timeout.
+static MMIO::WriteHandlingMethod<u16>* FifoPointerWrite(u16* ptr, u16 mask = 0xFFFF)
+{
+	if (!IsOnThread())
+		return MMIO::DirectWrite<u16>(ptr, mask);
+
+	return MMIO::ComplexWrite<u16>([ptr, mask](u32, u16 val) {
+		*ptr = val & mask;
+		WakeGpuLoop();
+	});
+}
+
 void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
 {
 	struct {
@@ -160,9 +173,7 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
 		{ FIFO_LO_WATERMARK_HI, MMIO::Utils::HighPart(&fifo.CPLoWatermark) },
 		// FIFO_RW_DISTANCE has some complex read code different for
 		// single/dual core.
-		{ FIFO_WRITE_POINTER_LO, MMIO::Utils::LowPart(&fifo.CPWritePointer), false, true },
-		{ FIFO_WRITE_POINTER_HI, MMIO::Utils::HighPart(&fifo.CPWritePointer) },
-		// FIFO_READ_POINTER has different code for single/dual core.
+		// FIFO_WRITE_POINTER and FIFO_READ_POINTER wake the GPU thread up.
 		{ FIFO_BP_LO, MMIO::Utils::LowPart(&fifo.CPBreakpoint), false, true },
 		{ FIFO_BP_HI, MMIO::Utils::HighPart(&fifo.CPBreakpoint) },
 	};
@@ -241,6 +252,15 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
 		MMIO::Nop<u16>()
 	);
 
+	mmio->Register(base | FIFO_WRITE_POINTER_LO,
+		MMIO::DirectRead<u16>(MMIO::Utils::LowPart(&fifo.CPWritePointer)),
+		FifoPointerWrite(MMIO::Utils::LowPart(&fifo.CPWritePointer), 0xFFE0)
+	);
+	mmio->Register(base | FIFO_WRITE_POINTER_HI,
+		MMIO::DirectRead<u16>(MMIO::Utils::HighPart(&fifo.CPWritePointer)),
+		FifoPointerWrite(MMIO::Utils::HighPart(&fifo.CPWritePointer))
+	);
+
 	// Some MMIOs have different handlers for single core vs. dual core mode.
 	mmio->Register(base | FIFO_RW_DISTANCE_LO,
 		IsOnThread()
@@ -251,7 +271,7 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
 					return ReadLow(fifo.CPEnd - fifo.SafeCPReadPointer + fifo.CPWritePointer - fifo.CPBase + 32);
 			  })
 			: MMIO::DirectRead<u16>(MMIO::Utils::LowPart(&fifo.CPReadWriteDistance)),
-		MMIO::DirectWrite<u16>(MMIO::Utils::LowPart(&fifo.CPReadWriteDistance), 0xFFE0)
+		FifoPointerWrite(MMIO::Utils::LowPart(&fifo.CPReadWriteDistance), 0xFFE0)
 	);
 	mmio->Register(base | FIFO_RW_DISTANCE_HI,
 		IsOnThread()
@@ -275,13 +295,15 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
 			}
 			if (!IsOnThread())
 				RunGpu();
+			else
+				WakeGpuLoop();
 		})
 	);
 	mmio->Register(base | FIFO_READ_POINTER_LO,
 		IsOnThread()
 			? MMIO::DirectRead<u16>(MMIO::Utils::LowPart(&fifo.SafeCPReadPointer))
 			: MMIO::DirectRead<u16>(MMIO::Utils::LowPart(&fifo.CPReadPointer)),
-		MMIO::DirectWrite<u16>(MMIO::Utils::LowPart(&fifo.CPReadPointer), 0xFFE0)
+		FifoPointerWrite(MMIO::Utils::LowPart(&fifo.CPReadPointer), 0xFFE0)
 	);
 	mmio->Register(base | FIFO_READ_POINTER_HI,
 		IsOnThread()
@@ -291,6 +313,7 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
 			? MMIO::ComplexWrite<u16>([](u32, u16 val) {
 				WriteHigh(fifo.CPReadPointer, val);
 				fifo.SafeCPReadPointer = fifo.CPReadPointer;
+				WakeGpuLoop();
 			  })
 			: MMIO::DirectWrite<u16>(MMIO::Utils::HighPart(&fifo.CPReadPointer))
 	);
@@ -333,6 +356,8 @@ void STACKALIGN GatherPipeBursted()
 
 	if (!IsOnThread())
 		RunGpu();
+	else
+		WakeGpuLoop();
 
 	_assert_msg_(COMMANDPROCESSOR, fifo.CPReadWriteDistance <= fifo.CPEnd - fifo.CPBase,
 	"FIFO is overflowed by GatherPipe !\nCPU thread is too fast!");
@@ -358,6 +383,8 @@ void UpdateInterrupts(u64 userdata)
 		ProcessorInterface::SetInterrupt(INT_CAUSE_CP, false);
 	}
 	interruptWaiting = false;
+	if (IsOnThread())
+		WakeGpuLoop();
 }
 
 void UpdateInterruptsFromVideoBackend(u64 userdata)
@@ -447,6 +474,9 @@ void ProcessFifoToLoWatermark()
 {
 	if (IsOnThread())
 	{
+		// The GPU thread may be asleep, and would leave us spinning until its
+		// timeout.
+		WakeGpuLoop();
 		while (!CommandProcessor::interruptWaiting && fifo.bFF_GPReadEnable &&
 			fifo.CPReadWriteDistance > fifo.CPLoWatermark && !AtBreakpoint())
 			Common::YieldCPU();
@@ -458,6 +488,9 @@ void ProcessFifoAllDistance()
 {
 	if (IsOnThread())
 	{
+		// The GPU thread may be asleep, and would leave us spinning until its
+		// timeout.
+		WakeGpuLoop();
 		while (!CommandProcessor::interruptWaiting && fifo.bFF_GPReadEnable &&
 			fifo.CPReadWriteDistance && !AtBreakpoint())
 			Common::YieldCPU();
@@ -527,6 +560,9 @@ void SetCpControlRegister()
 		fifo.bFF_GPReadEnable = m_CPCtrlReg.GPReadEnable;
 	}
 
+	if (IsOnThread())
+		WakeGpuLoop();
+
 	DEBUG_LOG(COMMANDPROCESSOR, "\t GPREAD %s | BP %s | Int %s | OvF %s | UndF %s | LINK %s"
 		, fifo.bFF_GPReadEnable              ? "ON" : "OFF"
 		, fifo.bFF_BPEnable                  ? "ON" : "OFF"
@@ -2,8 +2,12 @@
 // Licensed under GPLv2
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <chrono>
+
 #include "Common/Atomic.h"
 #include "Common/ChunkFile.h"
+#include "Common/Event.h"
 #include "Common/FPURoundMode.h"
 #include "Common/MemoryUtil.h"
 #include "Common/Thread.h"
@@ -26,11 +30,19 @@ namespace
 static volatile bool GpuRunningState = false;
 static volatile bool EmuRunningState = false;
 static std::mutex m_csHWVidOccupied;
+static Common::Event s_gpuWakeupEvent;
 // STATE_TO_SAVE
 static u8 *videoBuffer;
 static int size = 0;
 }  // namespace
 
+// Upper bound on the CP FIFO data the GPU thread consumes between updates of
+// the pointers and the CP status. Bigger batches mean fewer of them, but the
+// CPU thread only sees the FIFO drain once a batch is complete.
+#define GPU_READ_BATCH_SIZE (64 * 1024)
+// How long the GPU thread waits for work before checking for it again.
+#define GPU_IDLE_TIMEOUT_MS 1
+
 void Fifo_DoState(PointerWrap &p)
 {
 	p.DoArray(videoBuffer, FIFO_SIZE);
@@ -99,11 +111,20 @@ void ExitGpuLoop()
 	// Terminate GPU thread loop
 	GpuRunningState = false;
 	EmuRunningState = true;
+	WakeGpuLoop();
 }
 
 void EmulatorState(bool running)
 {
 	EmuRunningState = running;
+	WakeGpuLoop();
+}
+
+// May be executed from any thread. Wakes the GPU thread up if it is waiting
+// for work in RunGpuLoop().
+void WakeGpuLoop()
+{
+	s_gpuWakeupEvent.Set();
 }
 
 
@@ -133,6 +154,37 @@ void ResetVideoBuffer()
 }
 
 
+// Returns how many bytes of the CP FIFO the GPU thread can process at once:
+// everything the CPU has written so far, up to the end of the FIFO, the
+// breakpoint or GPU_READ_BATCH_SIZE. SyncGPU accounts for each 32 byte chunk
+// separately, so it keeps on reading one chunk at a time.
+static u32 GetReadBatchSize(const SCPFifoStruct &fifo)
+{
+	if (Core::g_CoreStartupParameter.bSyncGPU)
+		return 32;
+
+	u32 readPtr = fifo.CPReadPointer;
+	u32 end = fifo.CPEnd;
+	u32 breakpoint = fifo.CPBreakpoint;
+	u32 distance = Common::AtomicLoad(fifo.CPReadWriteDistance);
+	u32 len = std::min<u32>(distance, GPU_READ_BATCH_SIZE);
+
+	// CPEnd is the address of the last chunk before the FIFO wraps around.
+	if (readPtr <= end)
+		len = std::min<u32>(len, end - readPtr + 32);
+	if (fifo.bFF_BPEnable && breakpoint > readPtr)
+		len = std::min<u32>(len, breakpoint - readPtr);
+
+	// SetCpStatus raises and clears the watermark interrupts after each batch,
+	// so a batch ends in the chunk where the distance crosses a watermark.
+	if (fifo.bFF_HiWatermarkInt && distance > fifo.CPHiWatermark)
+		len = std::min<u32>(len, distance - fifo.CPHiWatermark);
+	if (fifo.bFF_LoWatermarkInt && distance >= fifo.CPLoWatermark)
+		len = std::min<u32>(len, distance - fifo.CPLoWatermark + 1);
+
+	return std::max<u32>(len & ~31, 32);
+}
+
 // Description: Main FIFO update loop
 // Purpose: Keep the Core HW updated about the CPU-GPU distance
 void RunGpuLoop()
@@ -170,24 +222,33 @@ void RunGpuLoop()
 			{
 				u32 readPtr = fifo.CPReadPointer;
 				u8 *uData = Memory::GetPointer(readPtr);
+				u32 len = GetReadBatchSize(fifo);
 
-				if (readPtr == fifo.CPEnd)
-					readPtr = fifo.CPBase;
-				else
-					readPtr += 32;
+				_assert_msg_(COMMANDPROCESSOR, (s32)fifo.CPReadWriteDistance - (s32)len >= 0 ,
+					"Negative fifo.CPReadWriteDistance = %i in FIFO Loop !\nThat can produce instability in the game. Please report it.", fifo.CPReadWriteDistance - len);
 
-				_assert_msg_(COMMANDPROCESSOR, (s32)fifo.CPReadWriteDistance - 32 >= 0 ,
-					"Negative fifo.CPReadWriteDistance = %i in FIFO Loop !\nThat can produce instability in the game. Please report it.", fifo.CPReadWriteDistance - 32);
+				// The batch is decoded one chunk at a time, so that the GPU stops
+				// in the same chunk as without batching when the CPU disables
+				// reads or an interrupt is waiting.
+				u32 done = 0;
+				while (done < len && fifo.bFF_GPReadEnable && !CommandProcessor::interruptWaiting)
+				{
+					ReadDataFromFifo(uData + done, 32);
+					done += 32;
 
-				ReadDataFromFifo(uData, 32);
+					cyclesExecuted = OpcodeDecoder_Run(g_bSkipCurrentFrame);
 
-				cyclesExecuted = OpcodeDecoder_Run(g_bSkipCurrentFrame);
+					if (Core::g_CoreStartupParameter.bSyncGPU && Common::AtomicLoad(CommandProcessor::VITicks) > cyclesExecuted)
+						Common::AtomicAdd(CommandProcessor::VITicks, -(s32)cyclesExecuted);
+				}
 
-				if (Core::g_CoreStartupParameter.bSyncGPU && Common::AtomicLoad(CommandProcessor::VITicks) > cyclesExecuted)
-					Common::AtomicAdd(CommandProcessor::VITicks, -(s32)cyclesExecuted);
+				if (done && readPtr + done - 32 == fifo.CPEnd)
+					readPtr = fifo.CPBase;
+				else
+					readPtr += done;
 
 				Common::AtomicStore(fifo.CPReadPointer, readPtr);
-				Common::AtomicAdd(fifo.CPReadWriteDistance, -32);
+				Common::AtomicAdd(fifo.CPReadWriteDistance, -(s32)done);
 				if ((GetVideoBufferEndPtr() - g_pVideoData) == 0)
 					Common::AtomicStore(fifo.SafeCPReadPointer, fifo.CPReadPointer);
 			}
@@ -205,12 +266,11 @@ void RunGpuLoop()
 
 		if (EmuRunningState)
 		{
-			// NOTE(jsd): Calling SwitchToThread() on Windows 7 x64 is a hot spot, according to profiler.
-			// See https://docs.google.com/spreadsheet/ccc?key=0Ah4nh0yGtjrgdFpDeF9pS3V6RUotRVE3S3J4TGM1NlE#gid=0
-			// for benchmark details.
-#if 0
-			Common::YieldCPU();
-#endif
+			// Sleep until the CPU thread sends more data (see WakeGpuLoop) instead
+			// of spinning on the FIFO. The timeout keeps host messages flowing
+			// and covers anything that does not wake us up.
+			if (GpuRunningState)
+				s_gpuWakeupEvent.WaitFor(std::chrono::milliseconds(GPU_IDLE_TIMEOUT_MS));
 		}
 		else
 		{
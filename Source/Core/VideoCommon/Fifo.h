@@ -25,6 +25,7 @@ void ReadDataFromFifo(u8* _uData, u32 len);
 void RunGpu();
 void RunGpuLoop();
 void ExitGpuLoop();
+void WakeGpuLoop();
 void EmulatorState(bool running);
 bool AtBreakpoint();
 void ResetVideoBuffer();
@@ -29,6 +29,8 @@ std::string Statistics::ToString()
 	std::string str;
 	str += StringFromFormat("Textures created: %i\n",stats.numTexturesCreated);
 	str += StringFromFormat("Textures alive: %i\n", stats.numTexturesAlive);
+	str += StringFromFormat("Textures pooled: %i (hits: %i, misses: %i)\n",
+		stats.numTexturesPooled, stats.numTexturePoolHits, stats.numTexturePoolMisses);
 	str += StringFromFormat("pshaders created: %i\n", stats.numPixelShadersCreated);
 	str += StringFromFormat("pshaders alive: %i\n",stats.numPixelShadersAlive);
 	str += StringFromFormat("pshaders (unique, delete cache first): %i\n",stats.numUniquePixelShaders);
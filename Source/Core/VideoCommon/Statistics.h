@@ -19,6 +19,9 @@ struct Statistics
 
 	int numTexturesCreated;
 	int numTexturesAlive;
+	int numTexturesPooled;
+	int numTexturePoolHits;
+	int numTexturePoolMisses;
 
 	int numRenderTargetsCreated;
 	int numRenderTargetsAlive;
@@ -3,6 +3,8 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <thread>
+#include <vector>
 
 #include "Common/FileUtil.h"
 #include "Common/MemoryUtil.h"
@@ -15,6 +17,7 @@
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/TextureCacheBase.h"
+#include "VideoCommon/TextureDecodeWorkers.h"
 #include "VideoCommon/VideoConfig.h"
 
 // ugly
@@ -23,14 +26,21 @@ extern int frameCount;
 enum
 {
 	TEXTURE_KILL_THRESHOLD = 200,
+	// Samples of the sampled hash checked before a full one.
+	SAMPLED_HASH_SAMPLES = 128,
 };
 
 TextureCache *g_texture_cache;
 
 GC_ALIGNED16(u8 *TextureCache::temp) = nullptr;
 unsigned int TextureCache::temp_size;
+u8 *TextureCache::mip_temp = nullptr;
+unsigned int TextureCache::mip_temp_size;
 
 TextureCache::TexCache TextureCache::textures;
+TexturePageIndex<TextureCache::TCacheEntryBase> TextureCache::texture_pages;
+TextureCache::TexPool TextureCache::texture_pool;
+size_t TextureCache::texture_pool_size;
 
 TextureCache::BackupConfig TextureCache::backup_config;
 
@@ -48,6 +58,13 @@ TextureCache::TextureCache()
 
 	TexDecoder_SetTexFmtOverlayOptions(g_ActiveConfig.bTexFmtOverlayEnable, g_ActiveConfig.bTexFmtOverlayCenter);
 
+	int decode_threads = g_ActiveConfig.iTextureDecodeThreads;
+	// Like the OpenMP decoder, leave most cores to the rest of the emulator.
+	if (decode_threads < 0)
+		decode_threads = std::max(0, ((int)std::thread::hardware_concurrency() + 2) / 3 - 1);
+	// The OpenMP decoder brings its own threads.
+	TextureDecodeWorkers::Init(g_ActiveConfig.bOMPDecoder ? 0 : decode_threads);
+
 	if (g_ActiveConfig.bHiresTextures && !g_ActiveConfig.bDumpTextures)
 		HiresTextures::Init(SConfig::GetInstance().m_LocalCoreStartupParameter.m_strUniqueID);
 
@@ -68,13 +85,83 @@ void TextureCache::Invalidate()
 		delete tex.second;
 	}
 	textures.clear();
+	texture_pages.Clear();
+
+	for (auto& tex : texture_pool)
+	{
+		delete tex.second;
+	}
+	texture_pool.clear();
+	texture_pool_size = 0;
+	SETSTAT(stats.numTexturesPooled, 0);
+}
+
+void TextureCache::AddEntry(TCacheEntryBase* entry)
+{
+	textures.insert(TexCache::value_type(entry->addr, entry));
+	texture_pages.Insert(entry);
+}
+
+TextureCache::TexCache::iterator TextureCache::RemoveEntry(TexCache::iterator iter)
+{
+	texture_pages.Remove(iter->second);
+	DisposeTexture(iter->second);
+	return textures.erase(iter);
+}
+
+// Worst case, with every level at 32 bits per texel.
+static size_t PooledTextureSize(const TextureCache::TexPoolKey& key)
+{
+	size_t size = (size_t)key.width * key.height * 4;
+	return key.levels > 1 ? size * 4 / 3 : size;
+}
+
+TextureCache::TCacheEntryBase* TextureCache::AllocateTexture(const TexPoolKey& key, unsigned int expanded_width)
+{
+	TexPool::iterator iter = texture_pool.find(key);
+	if (iter != texture_pool.end())
+	{
+		TCacheEntryBase* entry = iter->second;
+		texture_pool.erase(iter);
+		texture_pool_size -= PooledTextureSize(key);
+		INCSTAT(stats.numTexturePoolHits);
+		SETSTAT(stats.numTexturesPooled, texture_pool.size());
+
+		entry->Load(temp, key.width, key.height, expanded_width, 0);
+		return entry;
+	}
+
+	INCSTAT(stats.numTexturePoolMisses);
+	TCacheEntryBase* entry = g_texture_cache->CreateTexture(key.width, key.height, expanded_width, key.levels, key.pcfmt);
+	entry->pool_key = key;
+	return entry;
+}
+
+void TextureCache::DisposeTexture(TCacheEntryBase* entry)
+{
+	const size_t size = PooledTextureSize(entry->pool_key);
+	if (entry->pool_key.levels == 0 ||
+	    texture_pool_size + size > (size_t)std::max(0, g_ActiveConfig.iTexturePoolSize) << 20)
+	{
+		delete entry;
+		return;
+	}
+
+	entry->frameCount = frameCount;
+	texture_pool.insert(TexPool::value_type(entry->pool_key, entry));
+	texture_pool_size += size;
+	SETSTAT(stats.numTexturesPooled, texture_pool.size());
 }
 
 TextureCache::~TextureCache()
 {
 	Invalidate();
+	TextureDecodeWorkers::Shutdown();
 	FreeAlignedMemory(temp);
 	temp = nullptr;
+	FreeAlignedMemory(mip_temp);
+	mip_temp = nullptr;
+	mip_temp_size = 0;
 }
 
 void TextureCache::OnConfigChanged(VideoConfig& config)
@@ -131,61 +218,64 @@ void TextureCache::Cleanup()
             // EFB copies living on the host GPU are unrecoverable and thus shouldn't be deleted
 		    !iter->second->IsEfbCopy())
 		{
-			delete iter->second;
-			textures.erase(iter++);
+			iter = RemoveEntry(iter);
 		}
 		else
 		{
 			++iter;
 		}
 	}
-}
 
-void TextureCache::InvalidateRange(u32 start_address, u32 size)
-{
-	TexCache::iterator
-		iter = textures.begin(),
-		tcend = textures.end();
-	while (iter != tcend)
+	// Textures nothing asked for in as long go back to the backend.
+	TexPool::iterator pool_iter = texture_pool.begin();
+	while (pool_iter != texture_pool.end())
 	{
-		const int rangePosition = iter->second->IntersectsMemoryRange(start_address, size);
-		if (0 == rangePosition)
+		if (frameCount > TEXTURE_KILL_THRESHOLD + pool_iter->second->frameCount)
 		{
-			delete iter->second;
-			textures.erase(iter++);
+			texture_pool_size -= PooledTextureSize(pool_iter->first);
+			delete pool_iter->second;
+			texture_pool.erase(pool_iter++);
 		}
 		else
 		{
-			++iter;
+			++pool_iter;
 		}
 	}
+	SETSTAT(stats.numTexturesPooled, texture_pool.size());
 }
 
-void TextureCache::MakeRangeDynamic(u32 start_address, u32 size)
+void TextureCache::InvalidateRange(u32 start_address, u32 size)
 {
-	TexCache::iterator
-		iter = textures.lower_bound(start_address),
-		tcend = textures.upper_bound(start_address + size);
-
-	if (iter != textures.begin())
-		--iter;
+	std::vector<TCacheEntryBase*> invalid;
+	texture_pages.ForEachInRange(start_address, size, [&](TCacheEntryBase* entry) {
+		if (0 == entry->IntersectsMemoryRange(start_address, size))
+			invalid.push_back(entry);
+	});
 
-	for (; iter != tcend; ++iter)
+	for (TCacheEntryBase* entry : invalid)
 	{
-		const int rangePosition = iter->second->IntersectsMemoryRange(start_address, size);
-		if (0 == rangePosition)
-		{
-			iter->second->SetHashes(TEXHASH_INVALID);
-		}
+		auto range = textures.equal_range(entry->addr);
+		RemoveEntry(std::find_if(range.first, range.second,
+			[entry](const TexCache::value_type& tex) { return tex.second == entry; }));
 	}
 }
 
-bool TextureCache::Find(u32 start_address, u64 hash)
+void TextureCache::MakeRangeDynamic(u32 start_address, u32 size)
 {
-	TexCache::iterator iter = textures.lower_bound(start_address);
+	texture_pages.ForEachInRange(start_address, size, [&](TCacheEntryBase* entry) {
+		if (0 == entry->IntersectsMemoryRange(start_address, size))
+			entry->SetHashes(TEXHASH_INVALID);
+	});
+}
 
-	if (iter->second->hash == hash)
-		return true;
+bool TextureCache::Find(u32 start_address, u64 hash)
+{
+	auto range = textures.equal_range(start_address);
+	for (auto iter = range.first; iter != range.second; ++iter)
+	{
+		if (iter->second->hash == hash)
+			return true;
+	}
 
 	return false;
 }
@@ -211,8 +301,7 @@ void TextureCache::ClearRenderTargets()
 	{
 		if (iter->second->type == TCET_EC_VRAM)
 		{
-			delete iter->second;
-			textures.erase(iter++);
+			iter = RemoveEntry(iter);
 		}
 		else
 		{
@@ -319,6 +408,12 @@ static u32 CalculateLevelSize(u32 level_0_size, u32 level)
 	return (level_0_size + ((1 << level) - 1)) >> level;
 }
 
+// Room for a decoded level in mip_temp, keeping the next one aligned.
+static u32 MipBufferSize(const TextureDecodeWorkers::Job& job)
+{
+	return (job.width * job.height * 4 + 15) & ~15;
+}
+
 // Used by TextureCache::Load
 static TextureCache::TCacheEntryBase* ReturnEntry(unsigned int stage, TextureCache::TCacheEntryBase* entry)
 {
@@ -346,7 +441,6 @@ TextureCache::TCacheEntryBase* TextureCache::Load(unsigned int const stage,
 	const unsigned int nativeW = width;
 	const unsigned int nativeH = height;
 
-	u32 texID = address;
 	// Hash assigned to texcache entry (also used to generate filenames used for texture dumping and custom texture lookup)
 	u64 tex_hash = TEXHASH_INVALID;
 	u64 tlut_hash = TEXHASH_INVALID;
@@ -366,41 +460,87 @@ TextureCache::TCacheEntryBase* TextureCache::Load(unsigned int const stage,
 	else
 		src_data = Memory::GetPointer(address);
 
-	// TODO: This doesn't hash GB tiles for preloaded RGBA8 textures (instead, it's hashing more data from the low tmem bank than it should)
-	tex_hash = GetHash64(src_data, texture_size, g_ActiveConfig.iSafeTextureCache_ColorSamples);
 	if (isPaletteTexture)
 	{
 		const u32 palette_size = TexDecoder_GetPaletteSize(texformat);
 		tlut_hash = GetHash64(&texMem[tlutaddr], palette_size, g_ActiveConfig.iSafeTextureCache_ColorSamples);
-
-		// NOTE: For non-paletted textures, texID is equal to the texture address.
-		//       A paletted texture, however, may have multiple texIDs assigned though depending on the currently used tlut.
-		//       This (changing texID depending on the tlut_hash) is a trick to get around
-		//       an issue with Metroid Prime's fonts (it has multiple sets of fonts on each other
-		//       stored in a single texture and uses the palette to make different characters
-		//       visible or invisible. Thus, unless we want to recreate the textures for every drawn character,
-		//       we must make sure that a paletted texture gets assigned multiple IDs for each tlut used.
-		//
-		// TODO: Because texID isn't always the same as the address now, CopyRenderTargetToTexture might be broken now
-		texID ^= ((u32)tlut_hash) ^(u32)(tlut_hash >> 32);
-		tex_hash ^= tlut_hash;
 	}
 
+	// Fully hashing big textures on every use is expensive. With
+	// iSafeTextureCache_VerifyFrames set, a sampled hash is taken first, and
+	// the full one only once something needs it.
+	const bool verify_sampled = g_ActiveConfig.iSafeTextureCache_ColorSamples == 0 &&
+	                            g_ActiveConfig.iSafeTextureCache_VerifyFrames > 0;
+	bool have_tex_hash = false;
+	auto full_hash = [&]() -> u64
+	{
+		if (!have_tex_hash)
+		{
+			// TODO: This doesn't hash GB tiles for preloaded RGBA8 textures (instead, it's hashing more data from the low tmem bank than it should)
+			tex_hash = GetHash64(src_data, texture_size, g_ActiveConfig.iSafeTextureCache_ColorSamples);
+
+			// NOTE: A paletted texture may have one entry for every tlut used with it.
+			//       Metroid Prime's fonts need this: it has multiple sets of fonts on each other
+			//       stored in a single texture and uses the palette to make different characters
+			//       visible or invisible. Thus, unless we want to recreate the textures for every drawn character,
+			//       the tlut has to be part of what makes an entry match.
+			if (isPaletteTexture)
+				tex_hash ^= tlut_hash;
+			have_tex_hash = true;
+		}
+		return tex_hash;
+	};
+
+	u64 sampled_hash = TEXHASH_INVALID;
+	if (verify_sampled)
+		sampled_hash = GetHash64(src_data, texture_size, SAMPLED_HASH_SAMPLES) ^ tlut_hash;
+	else
+		full_hash();
+
 	// D3D doesn't like when the specified mipmap count would require more than one 1x1-sized LOD in the mipmap chain
 	// e.g. 64x64 with 7 LODs would have the mipmap chain 64x64,32x32,16x16,8x8,4x4,2x2,1x1,1x1, so we limit the mipmap count to 6 there
 	while (g_ActiveConfig.backend_info.bUseMinimalMipCount && std::max(expandedWidth, expandedHeight) >> maxlevel == 0)
 		--maxlevel;
 
-	TCacheEntryBase *entry = textures[texID];
-	if (entry)
+	// Entries at this address which don't match are kept, another draw may
+	// still use them. One of them can be reused for the new texture data,
+	// unless it was already used this frame.
+	TexCache::iterator reuse = textures.end();
+	auto range = textures.equal_range(address);
+	for (auto iter = range.first; iter != range.second; ++iter)
 	{
+		TCacheEntryBase *entry = iter->second;
+
 		// 1. Calculate reference hash:
 		// calculated from RAM texture data for normal textures. Hashes for paletted textures are modified by tlut_hash. 0 for virtual EFB copies.
+		// When verifying sampled hashes, a normal texture whose sampled hash matches is trusted until it's
+		// iSafeTextureCache_VerifyFrames frames old, and one whose sampled hash differs has changed.
+		u64 ref_hash;
 		if (g_ActiveConfig.bCopyEFBToTexture && entry->IsEfbCopy())
-			tex_hash = TEXHASH_INVALID;
+		{
+			ref_hash = TEXHASH_INVALID;
+		}
+		else if (!verify_sampled || entry->IsEfbCopy())
+		{
+			ref_hash = full_hash();
+		}
+		else if (entry->sampled_hash != sampled_hash)
+		{
+			ref_hash = ~entry->hash;
+		}
+		else if (frameCount - entry->verify_frame < g_ActiveConfig.iSafeTextureCache_VerifyFrames)
+		{
+			ref_hash = entry->hash;
+		}
+		else
+		{
+			ref_hash = full_hash();
+			if (ref_hash == entry->hash)
+				entry->verify_frame = frameCount;
+		}
 
 		// 2. a) For EFB copies, only the hash and the texture address need to match
-		if (entry->IsEfbCopy() && tex_hash == entry->hash && address == entry->addr)
+		if (entry->IsEfbCopy() && ref_hash == entry->hash)
 		{
 			entry->type = TCET_EC_VRAM;
 
@@ -411,7 +551,7 @@ TextureCache::TCacheEntryBase* TextureCache::Load(unsigned int const stage,
 		}
 
 		// 2. b) For normal textures, all texture parameters need to match
-		if (address == entry->addr && tex_hash == entry->hash && full_format == entry->format &&
+		if (ref_hash == entry->hash && full_format == entry->format &&
 			entry->num_mipmaps > maxlevel && entry->native_width == nativeW && entry->native_height == nativeH)
 		{
 			return ReturnEntry(stage, entry);
@@ -422,23 +562,40 @@ TextureCache::TCacheEntryBase* TextureCache::Load(unsigned int const stage,
 		//
 		// TODO: Don't we need to force texture decoding to RGBA8 for dynamic EFB copies?
 		// TODO: Actually, it should be enough if the internal texture format matches...
-		if ((entry->type == TCET_NORMAL &&
-		     width == entry->virtual_width &&
-		     height == entry->virtual_height &&
-		     full_format == entry->format &&
-		     entry->num_mipmaps > maxlevel) ||
-		    (entry->type == TCET_EC_DYNAMIC &&
-		     entry->native_width == width &&
-		     entry->native_height == height))
+		if (reuse == textures.end() &&
+		    ((entry->type == TCET_NORMAL &&
+		      entry->frameCount != frameCount &&
+		      width == entry->virtual_width &&
+		      height == entry->virtual_height &&
+		      full_format == entry->format &&
+		      entry->num_mipmaps > maxlevel) ||
+		     (entry->type == TCET_EC_DYNAMIC &&
+		      entry->native_width == width &&
+		      entry->native_height == height)))
 		{
-			// reuse the texture
+			reuse = iter;
 		}
+	}
+
+	// EFB copies which live in RAM are never cleaned up, so replace the ones
+	// that don't fit instead of keeping them around.
+	for (auto iter = range.first; iter != range.second;)
+	{
+		if (iter != reuse && iter->second->type == TCET_EC_DYNAMIC)
+			iter = RemoveEntry(iter);
 		else
-		{
-			// delete the texture and make a new one
-			delete entry;
-			entry = nullptr;
-		}
+			++iter;
+	}
+
+	// Everything from here on is keyed on the full hash.
+	full_hash();
+
+	TCacheEntryBase *entry = nullptr;
+	if (reuse != textures.end())
+	{
+		// The hash and maybe the size change, which the index is keyed on.
+		entry = reuse->second;
+		texture_pages.Remove(entry);
 	}
 
 	bool using_custom_texture = false;
@@ -457,7 +614,9 @@ TextureCache::TCacheEntryBase* TextureCache::Load(unsigned int const stage,
 				// If we thought we could reuse the texture before, make sure to pool it now!
 				if (entry)
 				{
-					delete entry;
+					DisposeTexture(entry);
+					textures.erase(reuse);
+					reuse = textures.end();
 					entry = nullptr;
 				}
 			}
@@ -469,8 +628,9 @@ TextureCache::TCacheEntryBase* TextureCache::Load(unsigned int const stage,
 	{
 		if (!(texformat == GX_TF_RGBA8 && from_tmem))
 		{
-			pcfmt = TexDecoder_Decode(temp, src_data, expandedWidth,
-						expandedHeight, texformat, tlutaddr, tlutfmt, g_ActiveConfig.backend_info.bUseRGBATextures);
+			TextureDecodeWorkers::Job job = { temp, src_data, (int)expandedWidth, (int)expandedHeight, PC_TEX_FMT_NONE };
+			TextureDecodeWorkers::Decode(&job, 1, texformat, tlutaddr, tlutfmt, g_ActiveConfig.backend_info.bUseRGBATextures);
+			pcfmt = job.pcfmt;
 		}
 		else
 		{
@@ -488,7 +648,7 @@ TextureCache::TCacheEntryBase* TextureCache::Load(unsigned int const stage,
 	// create the entry/texture
 	if (nullptr == entry)
 	{
-		textures[texID] = entry = g_texture_cache->CreateTexture(width, height, expandedWidth, texLevels, pcfmt);
+		entry = AllocateTexture(TexPoolKey(width, height, texLevels, pcfmt), expandedWidth);
 
 		// Sometimes, we can get around recreating a texture if only the number of mip levels changes
 		// e.g. if our texture cache entry got too many mipmap levels we can limit the number of used levels by setting the appropriate render states
@@ -505,12 +665,18 @@ TextureCache::TCacheEntryBase* TextureCache::Load(unsigned int const stage,
 	else
 	{
 		// load texture (CreateTexture also loads level 0)
-		entry->Load(width, height, expandedWidth, 0);
+		entry->Load(temp, width, height, expandedWidth, 0);
 	}
 
 	entry->SetGeneralParameters(address, texture_size, full_format, entry->num_mipmaps);
 	entry->SetDimensions(nativeW, nativeH, width, height);
-	entry->hash = tex_hash;
+	entry->SetHashes(tex_hash, sampled_hash);
+	entry->verify_frame = frameCount;
+
+	if (reuse != textures.end())
+		texture_pages.Insert(entry);
+	else
+		AddEntry(entry);
 
 	if (entry->IsEfbCopy() && !g_ActiveConfig.bCopyEFBToTexture)
 		entry->type = TCET_EC_DYNAMIC;
@@ -536,6 +702,10 @@ TextureCache::TCacheEntryBase* TextureCache::Load(unsigned int const stage,
 				ptr_odd = &texMem[bpmem.tex[stage/4].texImage2[stage%4].tmem_odd * TMEM_LINE_SIZE];
 			}
 
+			// All levels are decoded at once, each into its own part of
+			// mip_temp, and then uploaded in order.
+			std::vector<TextureDecodeWorkers::Job> mip_jobs(texLevels - 1);
+			u32 mip_buffer_size = 0;
 			for (; level != texLevels; ++level)
 			{
 				const u32 mip_width = CalculateLevelSize(width, level);
@@ -546,10 +716,32 @@ TextureCache::TCacheEntryBase* TextureCache::Load(unsigned int const stage,
 				const u8*& mip_src_data = from_tmem
 					? ((level % 2) ? ptr_odd : ptr_even)
 					: src_data;
-				TexDecoder_Decode(temp, mip_src_data, expanded_mip_width, expanded_mip_height, texformat, tlutaddr, tlutfmt, g_ActiveConfig.backend_info.bUseRGBATextures);
+				TextureDecodeWorkers::Job& job = mip_jobs[level - 1];
+				job.src = mip_src_data;
+				job.width = expanded_mip_width;
+				job.height = expanded_mip_height;
 				mip_src_data += TexDecoder_GetTextureSizeInBytes(expanded_mip_width, expanded_mip_height, texformat);
+				mip_buffer_size += MipBufferSize(job);
+			}
 
-				entry->Load(mip_width, mip_height, expanded_mip_width, level);
+			if (mip_temp_size < mip_buffer_size)
+			{
+				FreeAlignedMemory(mip_temp);
+				mip_temp_size = mip_buffer_size;
+				mip_temp = (u8*)AllocateAlignedMemory(mip_temp_size, 16);
+			}
+			u8* mip_dst = mip_temp;
+			for (TextureDecodeWorkers::Job& job : mip_jobs)
+			{
+				job.dst = mip_dst;
+				mip_dst += MipBufferSize(job);
+			}
+			TextureDecodeWorkers::Decode(mip_jobs.data(), mip_jobs.size(), texformat, tlutaddr, tlutfmt, g_ActiveConfig.backend_info.bUseRGBATextures);
+
+			for (level = 1; level != texLevels; ++level)
+			{
+				const TextureDecodeWorkers::Job& job = mip_jobs[level - 1];
+				entry->Load(job.dst, CalculateLevelSize(width, level), CalculateLevelSize(height, level), job.width, level);
 
 				if (g_ActiveConfig.bDumpTextures)
 					DumpTexture(entry, level);
@@ -563,7 +755,7 @@ TextureCache::TCacheEntryBase* TextureCache::Load(unsigned int const stage,
 				unsigned int mip_height = CalculateLevelSize(height, level);
 
 				LoadCustomTexture(tex_hash, texformat, level, mip_width, mip_height);
-				entry->Load(mip_width, mip_height, mip_width, level);
+				entry->Load(temp, mip_width, mip_height, mip_width, level);
 			}
 		}
 	}
@@ -856,32 +1048,43 @@ void TextureCache::CopyRenderTargetToTexture(u32 dstAddr, unsigned int dstFormat
 	unsigned int scaled_tex_h = g_ActiveConfig.bCopyEFBScaled ? Renderer::EFBToScaledY(tex_h) : tex_h;
 
 
-	TCacheEntryBase *entry = textures[dstAddr];
-	if (entry)
+	// The copy overwrites whatever was at dstAddr. Keep one EFB copy entry
+	// there if it fits, and remove the rest to recreate it as a render target.
+	TCacheEntryBase *entry = nullptr;
+	auto range = textures.equal_range(dstAddr);
+	for (auto iter = range.first; iter != range.second;)
 	{
-		if (entry->type == TCET_EC_DYNAMIC && entry->native_width == tex_w && entry->native_height == tex_h)
+		TCacheEntryBase *old = iter->second;
+		if (!entry && old->type == TCET_EC_DYNAMIC && old->native_width == tex_w && old->native_height == tex_h)
 		{
 			scaled_tex_w = tex_w;
 			scaled_tex_h = tex_h;
+			entry = old;
+			++iter;
+		}
+		else if (!entry && old->type == TCET_EC_VRAM && old->virtual_width == scaled_tex_w && old->virtual_height == scaled_tex_h)
+		{
+			entry = old;
+			++iter;
 		}
-		else if (!(entry->type == TCET_EC_VRAM && entry->virtual_width == scaled_tex_w && entry->virtual_height == scaled_tex_h))
+		else
 		{
-			// remove it and recreate it as a render target
-			delete entry;
-			entry = nullptr;
+			iter = RemoveEntry(iter);
 		}
 	}
 
 	if (nullptr == entry)
 	{
 		// create the texture
-		textures[dstAddr] = entry = g_texture_cache->CreateRenderTargetTexture(scaled_tex_w, scaled_tex_h);
+		entry = g_texture_cache->CreateRenderTargetTexture(scaled_tex_w, scaled_tex_h);
 
 		// TODO: Using the wrong dstFormat, dumb...
 		entry->SetGeneralParameters(dstAddr, 0, dstFormat, 1);
 		entry->SetDimensions(tex_w, tex_h, scaled_tex_w, scaled_tex_h);
 		entry->SetHashes(TEXHASH_INVALID);
 		entry->type = TCET_EC_VRAM;
+
+		AddEntry(entry);
 	}
 
 	entry->frameCount = frameCount;
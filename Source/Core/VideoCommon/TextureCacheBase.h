@@ -5,12 +5,14 @@
 #pragma once
 
 #include <map>
+#include <tuple>
 
 #include "Common/CommonTypes.h"
 #include "Common/Thread.h"
 
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/TextureDecoder.h"
+#include "VideoCommon/TexturePageIndex.h"
 #include "VideoCommon/VideoCommon.h"
 
 struct VideoConfig;
@@ -25,6 +27,24 @@ public:
 		TCET_EC_DYNAMIC, // EFB copy which sits in RAM and needs to be decoded before being used
 	};
 
+	// What CreateTexture made a texture with. Textures with the same key can
+	// be recycled for each other; render targets have an empty key.
+	struct TexPoolKey
+	{
+		unsigned int width, height, levels;
+		PC_TexFormat pcfmt;
+
+		TexPoolKey() : width(0), height(0), levels(0), pcfmt(PC_TEX_FMT_NONE) {}
+		TexPoolKey(unsigned int _width, unsigned int _height, unsigned int _levels, PC_TexFormat _pcfmt)
+			: width(_width), height(_height), levels(_levels), pcfmt(_pcfmt) {}
+
+		bool operator<(const TexPoolKey& other) const
+		{
+			return std::tie(width, height, levels, pcfmt) <
+			       std::tie(other.width, other.height, other.levels, other.pcfmt);
+		}
+	};
+
 	struct TCacheEntryBase
 	{
 #define TEXHASH_INVALID 0
@@ -34,6 +54,10 @@ public:
 		u32 size_in_bytes;
 		u64 hash;
 		//u32 pal_hash;
+		// Sampled hash of the data and the frame it was last fully hashed,
+		// for iSafeTextureCache_VerifyFrames.
+		u64 sampled_hash;
+		int verify_frame;
 		u32 format;
 
 		enum TexCacheEntryType type;
@@ -45,6 +69,8 @@ public:
 		// used to delete textures which haven't been used for TEXTURE_KILL_THRESHOLD frames
 		int frameCount;
 
+		TexPoolKey pool_key;
+
 
 		void SetGeneralParameters(u32 _addr, u32 _size, u32 _format, unsigned int _num_mipmaps)
 		{
@@ -62,10 +88,11 @@ public:
 			virtual_height = _virtual_height;
 		}
 
-		void SetHashes(u64 _hash/*, u32 _pal_hash*/)
+		void SetHashes(u64 _hash/*, u32 _pal_hash*/, u64 _sampled_hash = TEXHASH_INVALID)
 		{
 			hash = _hash;
 			//pal_hash = _pal_hash;
+			sampled_hash = _sampled_hash;
 		}
 
 
@@ -74,7 +101,8 @@ public:
 		virtual void Bind(unsigned int stage) = 0;
 		virtual bool Save(const std::string& filename, unsigned int level) = 0;
 
-		virtual void Load(unsigned int width, unsigned int height,
+		// data holds the decoded level, expanded_width texels per row.
+		virtual void Load(const u8* data, unsigned int width, unsigned int height,
 			unsigned int expanded_width, unsigned int level) = 0;
 		virtual void FromRenderTarget(u32 dstAddr, unsigned int dstFormat,
 			PEControl::PixelFormat srcFormat, const EFBRectangle& srcRect,
@@ -115,13 +143,33 @@ protected:
 	static unsigned int temp_size;
 
 private:
+	// Decoded mipmap levels, level 0 goes to temp.
+	static u8 *mip_temp;
+	static unsigned int mip_temp_size;
+
 	static bool CheckForCustomTextureLODs(u64 tex_hash, int texformat, unsigned int levels);
 	static PC_TexFormat LoadCustomTexture(u64 tex_hash, int texformat, unsigned int level, unsigned int& width, unsigned int& height);
 	static void DumpTexture(TCacheEntryBase* entry, unsigned int level);
 
-	typedef std::map<u32, TCacheEntryBase*> TexCache;
+	// Keyed by address. There can be several entries for one address, e.g.
+	// for different formats, sizes or palettes.
+	typedef std::multimap<u32, TCacheEntryBase*> TexCache;
+
+	static void AddEntry(TCacheEntryBase* entry);
+	static TexCache::iterator RemoveEntry(TexCache::iterator iter);
+
+	// Takes a texture from the pool, or creates one, and loads level 0.
+	static TCacheEntryBase* AllocateTexture(const TexPoolKey& key, unsigned int expanded_width);
+	// Puts a texture which isn't in textures any more into the pool, or
+	// deletes it if the pool is full.
+	static void DisposeTexture(TCacheEntryBase* entry);
+
+	typedef std::multimap<TexPoolKey, TCacheEntryBase*> TexPool;
 
 	static TexCache textures;
+	static TexturePageIndex<TCacheEntryBase> texture_pages;
+	static TexPool texture_pool;
+	static size_t texture_pool_size; // bytes
 
 	// Backup configuration values
 	static struct BackupConfig
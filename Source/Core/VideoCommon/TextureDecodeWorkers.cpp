@@ -0,0 +1,196 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Common/Thread.h"
+
+#include "VideoCommon/TextureDecodeWorkers.h"
+#include "VideoCommon/VideoConfig.h"
+
+namespace TextureDecodeWorkers
+{
+
+enum
+{
+	// Smaller strips cost more to hand out than to decode.
+	MIN_STRIP_TEXELS = 128 * 32,
+};
+
+struct Strip
+{
+	Job* job;
+	int first_row;
+	int num_rows;
+};
+
+static std::vector<std::thread> s_workers;
+static std::mutex s_mutex;
+static std::condition_variable s_work_available;
+static std::condition_variable s_work_done;
+static bool s_quit;
+
+// The strips of the current Decode call, and its format.
+static std::vector<Strip> s_strips;
+static size_t s_next_strip;
+static size_t s_strips_left;
+static int s_texformat;
+static int s_tlutaddr;
+static int s_tlutfmt;
+static bool s_rgba_only;
+
+// Size of a texel as TexDecoder_Decode writes it, 0 if a strip can't be
+// found from its rows.
+static int GetDecodedTexelSize(int texformat, int tlutfmt, bool rgba_only)
+{
+	if (rgba_only)
+		return 4;
+
+	switch (texformat)
+	{
+	case GX_TF_I4:
+	case GX_TF_I8:
+		return 1;
+	case GX_TF_IA4:
+	case GX_TF_IA8:
+	case GX_TF_RGB565:
+		return 2;
+	case GX_TF_C4:
+	case GX_TF_C8:
+	case GX_TF_C14X2:
+		// RGB5A3 palettes decode to BGRA32, the others to their raw 16 bits.
+		return tlutfmt == 2 ? 4 : 2;
+	case GX_TF_RGB5A3:
+	case GX_TF_RGBA8:
+	case GX_TF_CMPR:
+		return 4;
+	default:
+		return 0;
+	}
+}
+
+static void DecodeStrip(const Strip& strip)
+{
+	Job* job = strip.job;
+	const int texel_size = GetDecodedTexelSize(s_texformat, s_tlutfmt, s_rgba_only);
+	// Blocks are stored row after row, so the strip's are contiguous.
+	u8* dst = job->dst + strip.first_row * job->width * texel_size;
+	const u8* src = job->src + TexDecoder_GetTextureSizeInBytes(job->width, strip.first_row, s_texformat);
+
+	PC_TexFormat pcfmt = TexDecoder_Decode(dst, src, job->width, strip.num_rows,
+		s_texformat, s_tlutaddr, s_tlutfmt, s_rgba_only);
+	if (strip.first_row == 0)
+		job->pcfmt = pcfmt;
+}
+
+// Decodes strips until there are none left to take. Called with s_mutex
+// locked, returns with it locked.
+static void DecodeStrips(std::unique_lock<std::mutex>& lock)
+{
+	while (s_next_strip < s_strips.size())
+	{
+		const Strip strip = s_strips[s_next_strip++];
+		lock.unlock();
+		DecodeStrip(strip);
+		lock.lock();
+		if (--s_strips_left == 0)
+			s_work_done.notify_all();
+	}
+}
+
+static void WorkerThread()
+{
+	Common::SetCurrentThreadName("Texture decoder");
+
+	std::unique_lock<std::mutex> lock(s_mutex);
+	while (true)
+	{
+		s_work_available.wait(lock, [] { return s_quit || s_next_strip < s_strips.size(); });
+		if (s_quit)
+			return;
+		DecodeStrips(lock);
+	}
+}
+
+void Init(int num_workers)
+{
+	Shutdown();
+
+	s_quit = false;
+	for (int i = 0; i < num_workers; ++i)
+		s_workers.emplace_back(WorkerThread);
+}
+
+void Shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lock(s_mutex);
+		s_quit = true;
+	}
+	s_work_available.notify_all();
+
+	for (std::thread& worker : s_workers)
+		worker.join();
+	s_workers.clear();
+}
+
+void Decode(Job* jobs, size_t count, int texformat, int tlutaddr, int tlutfmt, bool rgba_only)
+{
+	const int texel_size = GetDecodedTexelSize(texformat, tlutfmt, rgba_only);
+	// The format overlay is drawn in the middle of whatever it is given.
+	const bool split = !s_workers.empty() && texel_size != 0 && !g_ActiveConfig.bTexFmtOverlayEnable;
+
+	if (s_workers.empty() || (count == 1 && !split))
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			jobs[i].pcfmt = TexDecoder_Decode(jobs[i].dst, jobs[i].src, jobs[i].width, jobs[i].height,
+				texformat, tlutaddr, tlutfmt, rgba_only);
+		}
+		return;
+	}
+
+	const int block_height = TexDecoder_GetBlockHeightInTexels(texformat);
+	const int num_threads = (int)s_workers.size() + 1;
+
+	std::unique_lock<std::mutex> lock(s_mutex);
+	s_strips.clear();
+	for (size_t i = 0; i < count; ++i)
+	{
+		Job& job = jobs[i];
+		job.pcfmt = PC_TEX_FMT_NONE;
+
+		int rows = job.height;
+		if (split)
+		{
+			int min_rows = (MIN_STRIP_TEXELS + job.width - 1) / job.width;
+			rows = std::max((job.height + num_threads - 1) / num_threads, min_rows);
+			rows = (rows + block_height - 1) / block_height * block_height;
+		}
+
+		for (int first_row = 0; first_row < job.height; first_row += rows)
+		{
+			Strip strip = { &job, first_row, std::min(rows, job.height - first_row) };
+			s_strips.push_back(strip);
+		}
+	}
+	s_next_strip = 0;
+	s_strips_left = s_strips.size();
+	s_texformat = texformat;
+	s_tlutaddr = tlutaddr;
+	s_tlutfmt = tlutfmt;
+	s_rgba_only = rgba_only;
+	s_work_available.notify_all();
+
+	DecodeStrips(lock);
+	s_work_done.wait(lock, [] { return s_strips_left == 0; });
+	s_strips.clear();
+	s_next_strip = 0;
+}
+
+}
@@ -0,0 +1,38 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/TextureDecoder.h"
+
+// Worker threads for TexDecoder_Decode. The rows of blocks of a texture are
+// independent of each other, so a texture is split into strips of them, and
+// the strips of all requested levels are decoded at once by the workers and
+// the thread asking for them.
+namespace TextureDecodeWorkers
+{
+
+struct Job
+{
+	u8* dst;
+	const u8* src;
+	// Expanded to whole blocks, like for TexDecoder_Decode.
+	int width;
+	int height;
+	// Set by Decode.
+	PC_TexFormat pcfmt;
+};
+
+// With no workers everything is decoded by the calling thread.
+void Init(int num_workers);
+void Shutdown();
+
+// Decodes every job like TexDecoder_Decode and returns when all are done.
+// Only one thread may call this at a time.
+void Decode(Job* jobs, size_t count, int texformat, int tlutaddr, int tlutfmt, bool rgba_only);
+
+}
@@ -956,10 +956,16 @@ PC_TexFormat TexDecoder_Decode_real(u8 *dst, const u8 *src, int width, int heigh
 // TODO: complete SSE2 optimization of less often used texture formats.
 // TODO: refactor algorithms using _mm_loadl_epi64 unaligned loads to prefer 128-bit aligned loads.
 
+// In TextureDecoder_x64_AVX2.cpp, false for the formats it doesn't have.
+bool TexDecoder_Decode_RGBA_AVX2(u32* dst, const u8* src, int width, int height, int texformat);
+
 PC_TexFormat TexDecoder_Decode_RGBA(u32 * dst, const u8 * src, int width, int height, int texformat, int tlutaddr, int tlutfmt)
 {
 	SetOpenMPThreadCount(width, height);
 
+	if (cpu_info.bAVX2 && TexDecoder_Decode_RGBA_AVX2(dst, src, width, height, texformat))
+		return PC_TEX_FMT_RGBA32;
+
 	const int Wsteps4 = (width + 3) / 4;
 	const int Wsteps8 = (width + 7) / 8;
 
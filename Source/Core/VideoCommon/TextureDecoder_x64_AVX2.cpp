@@ -0,0 +1,379 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+// AVX2 versions of the hot formats of TexDecoder_Decode_RGBA. The rest of
+// the build doesn't assume AVX2, so only these functions are compiled for
+// it, and TextureDecoder_x64.cpp only calls them when cpu_info.bAVX2 is set.
+
+#include <immintrin.h>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/TextureDecoder.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#elif defined __GNUC__
+#pragma GCC diagnostic ignored "-Wunknown-pragmas"
+#endif
+
+#ifdef _MSC_VER
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+// Repeats each of the bytes 0-3 of a lane's low qword four times in the low
+// lane, and bytes 4-7 in the high lane: one row of 8 I4 or I8 texels.
+TARGET_AVX2 static inline __m256i ExpandRowOf8(__m256i qword)
+{
+	const __m256i mask = _mm256_setr_epi8(
+		0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+		4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7);
+	return _mm256_shuffle_epi8(qword, mask);
+}
+
+// Loads two rows of a 4x4 block of 16 bit texels, the first into the low
+// lane and the second into the high lane, with each texel's two bytes
+// placed by mask.
+TARGET_AVX2 static inline __m256i LoadTwoRows16(const u8* src, __m256i mask)
+{
+	return _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)src)), mask);
+}
+
+// Stores the low lane to one row and the high lane to the next.
+TARGET_AVX2 static inline void StoreTwoRows4(u32* dst, int width, __m256i rows)
+{
+	_mm_storeu_si128((__m128i*)dst, _mm256_castsi256_si128(rows));
+	_mm_storeu_si128((__m128i*)(dst + width), _mm256_extracti128_si256(rows, 1));
+}
+
+// Eight 8 bit values in 32 bit lanes to RGBA texels.
+TARGET_AVX2 static inline __m256i MakeRGBA(__m256i r, __m256i g, __m256i b, __m256i a)
+{
+	return _mm256_or_si256(_mm256_or_si256(r, _mm256_slli_epi32(g, 8)),
+		_mm256_or_si256(_mm256_slli_epi32(b, 16), _mm256_slli_epi32(a, 24)));
+}
+
+TARGET_AVX2 static void DecodeI4(u32* dst, const u8* src, int width, int height)
+{
+	const int Wsteps8 = (width + 7) / 8;
+	const __m256i kMask_x0f = _mm256_set1_epi8(0x0f);
+	const __m256i kMask_xf0 = _mm256_set1_epi8((char)0xf0);
+
+	#pragma omp parallel for
+	for (int y = 0; y < height; y += 8)
+		for (int x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
+		{
+			// All 8 rows of 4 bytes.
+			const __m256i r = _mm256_loadu_si256((const __m256i*)(src + 32 * yStep));
+			const __m256i hi = _mm256_and_si256(r, kMask_xf0);
+			const __m256i hi8 = _mm256_or_si256(hi, _mm256_srli_epi16(hi, 4));
+			const __m256i lo = _mm256_and_si256(r, kMask_x0f);
+			const __m256i lo8 = _mm256_or_si256(lo, _mm256_slli_epi16(lo, 4));
+			// The high nibble is the first texel. Each qword is now a row:
+			// rows 0, 1, 4, 5 and 2, 3, 6, 7.
+			const __m256i rows0145 = _mm256_unpacklo_epi8(hi8, lo8);
+			const __m256i rows2367 = _mm256_unpackhi_epi8(hi8, lo8);
+
+			u32* row = dst + y * width + x;
+			_mm256_storeu_si256((__m256i*)(row + 0 * width), ExpandRowOf8(_mm256_permute4x64_epi64(rows0145, 0x00)));
+			_mm256_storeu_si256((__m256i*)(row + 1 * width), ExpandRowOf8(_mm256_permute4x64_epi64(rows0145, 0x55)));
+			_mm256_storeu_si256((__m256i*)(row + 2 * width), ExpandRowOf8(_mm256_permute4x64_epi64(rows2367, 0x00)));
+			_mm256_storeu_si256((__m256i*)(row + 3 * width), ExpandRowOf8(_mm256_permute4x64_epi64(rows2367, 0x55)));
+			_mm256_storeu_si256((__m256i*)(row + 4 * width), ExpandRowOf8(_mm256_permute4x64_epi64(rows0145, 0xaa)));
+			_mm256_storeu_si256((__m256i*)(row + 5 * width), ExpandRowOf8(_mm256_permute4x64_epi64(rows0145, 0xff)));
+			_mm256_storeu_si256((__m256i*)(row + 6 * width), ExpandRowOf8(_mm256_permute4x64_epi64(rows2367, 0xaa)));
+			_mm256_storeu_si256((__m256i*)(row + 7 * width), ExpandRowOf8(_mm256_permute4x64_epi64(rows2367, 0xff)));
+		}
+}
+
+TARGET_AVX2 static void DecodeI8(u32* dst, const u8* src, int width, int height)
+{
+	const int Wsteps8 = (width + 7) / 8;
+
+	#pragma omp parallel for
+	for (int y = 0; y < height; y += 4)
+		for (int x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 8, yStep++)
+		{
+			// 4 rows of 8 bytes.
+			const __m256i r = _mm256_loadu_si256((const __m256i*)(src + 32 * yStep));
+
+			u32* row = dst + y * width + x;
+			_mm256_storeu_si256((__m256i*)(row + 0 * width), ExpandRowOf8(_mm256_permute4x64_epi64(r, 0x00)));
+			_mm256_storeu_si256((__m256i*)(row + 1 * width), ExpandRowOf8(_mm256_permute4x64_epi64(r, 0x55)));
+			_mm256_storeu_si256((__m256i*)(row + 2 * width), ExpandRowOf8(_mm256_permute4x64_epi64(r, 0xaa)));
+			_mm256_storeu_si256((__m256i*)(row + 3 * width), ExpandRowOf8(_mm256_permute4x64_epi64(r, 0xff)));
+		}
+}
+
+TARGET_AVX2 static void DecodeIA8(u32* dst, const u8* src, int width, int height)
+{
+	const int Wsteps4 = (width + 3) / 4;
+	// Each texel is A then I, the result I, I, I, A.
+	const __m256i mask = _mm256_setr_epi8(
+		1, 1, 1, 0, 3, 3, 3, 2, 5, 5, 5, 4, 7, 7, 7, 6,
+		9, 9, 9, 8, 11, 11, 11, 10, 13, 13, 13, 12, 15, 15, 15, 14);
+
+	#pragma omp parallel for
+	for (int y = 0; y < height; y += 4)
+		for (int x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
+		{
+			const u8* block = src + 32 * yStep;
+			u32* row = dst + y * width + x;
+			StoreTwoRows4(row, width, LoadTwoRows16(block, mask));
+			StoreTwoRows4(row + 2 * width, width, LoadTwoRows16(block + 16, mask));
+		}
+}
+
+TARGET_AVX2 static inline __m256i DecodeRGB565(__m256i c0)
+{
+	// Same as the SSE2 version, see there for the bit juggling.
+	const __m256i kMaskR0 = _mm256_set1_epi32(0x000000F8);
+	const __m256i kMaskG0 = _mm256_set1_epi32(0x0000FC00);
+	const __m256i kMaskG1 = _mm256_set1_epi32(0x00000300);
+	const __m256i kMaskB0 = _mm256_set1_epi32(0x00F80000);
+	const __m256i kAlpha  = _mm256_set1_epi32((int)0xFF000000);
+
+	const __m256i r0 = _mm256_and_si256(c0, kMaskR0);
+	const __m256i r1 = _mm256_srli_epi32(r0, 5);
+	const __m256i gtmp = _mm256_srli_epi32(c0, 3);
+	const __m256i g0 = _mm256_and_si256(gtmp, kMaskG0);
+	const __m256i g1 = _mm256_and_si256(_mm256_srli_epi32(gtmp, 6), kMaskG1);
+	const __m256i b0 = _mm256_and_si256(_mm256_srli_epi32(c0, 5), kMaskB0);
+	const __m256i b1 = _mm256_srli_epi16(b0, 5);
+
+	return _mm256_or_si256(
+		_mm256_or_si256(_mm256_or_si256(r0, r1), _mm256_or_si256(g0, g1)),
+		_mm256_or_si256(_mm256_or_si256(b0, b1), kAlpha));
+}
+
+TARGET_AVX2 static void DecodeRGB565(u32* dst, const u8* src, int width, int height)
+{
+	const int Wsteps4 = (width + 3) / 4;
+	// Every texel's big endian bytes twice, like _mm_unpacklo_epi16(x, x).
+	const __m256i mask = _mm256_setr_epi8(
+		0, 1, 0, 1, 2, 3, 2, 3, 4, 5, 4, 5, 6, 7, 6, 7,
+		8, 9, 8, 9, 10, 11, 10, 11, 12, 13, 12, 13, 14, 15, 14, 15);
+
+	#pragma omp parallel for
+	for (int y = 0; y < height; y += 4)
+		for (int x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
+		{
+			const u8* block = src + 32 * yStep;
+			u32* row = dst + y * width + x;
+			StoreTwoRows4(row, width, DecodeRGB565(LoadTwoRows16(block, mask)));
+			StoreTwoRows4(row + 2 * width, width, DecodeRGB565(LoadTwoRows16(block + 16, mask)));
+		}
+}
+
+TARGET_AVX2 static inline __m256i DecodeRGB5A3(__m256i val)
+{
+	const __m256i kMask_x1f = _mm256_set1_epi32(0x1f);
+	const __m256i kMask_x0f = _mm256_set1_epi32(0x0f);
+	const __m256i kMask_x07 = _mm256_set1_epi32(0x07);
+
+	// RGB555, opaque. Swizzle bits: 00012345 -> 12345123
+	const __m256i r5 = _mm256_and_si256(_mm256_srli_epi32(val, 10), kMask_x1f);
+	const __m256i g5 = _mm256_and_si256(_mm256_srli_epi32(val, 5), kMask_x1f);
+	const __m256i b5 = _mm256_and_si256(val, kMask_x1f);
+	const __m256i rgb555 = MakeRGBA(
+		_mm256_or_si256(_mm256_slli_epi32(r5, 3), _mm256_srli_epi32(r5, 2)),
+		_mm256_or_si256(_mm256_slli_epi32(g5, 3), _mm256_srli_epi32(g5, 2)),
+		_mm256_or_si256(_mm256_slli_epi32(b5, 3), _mm256_srli_epi32(b5, 2)),
+		_mm256_set1_epi32(0xff));
+
+	// RGBA4443. Swizzle bits: 00001234 -> 12341234, 00000123 -> 12312312
+	const __m256i r4 = _mm256_and_si256(_mm256_srli_epi32(val, 8), kMask_x0f);
+	const __m256i g4 = _mm256_and_si256(_mm256_srli_epi32(val, 4), kMask_x0f);
+	const __m256i b4 = _mm256_and_si256(val, kMask_x0f);
+	const __m256i a3 = _mm256_and_si256(_mm256_srli_epi32(val, 12), kMask_x07);
+	const __m256i rgba4443 = MakeRGBA(
+		_mm256_or_si256(_mm256_slli_epi32(r4, 4), r4),
+		_mm256_or_si256(_mm256_slli_epi32(g4, 4), g4),
+		_mm256_or_si256(_mm256_slli_epi32(b4, 4), b4),
+		_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(a3, 5), _mm256_slli_epi32(a3, 2)), _mm256_srli_epi32(a3, 1)));
+
+	// Unlike the SSE versions, no branch on the mix of both kinds in the block:
+	// bit 15 picks per texel.
+	const __m256i is_rgb555 = _mm256_srai_epi32(_mm256_slli_epi32(val, 16), 31);
+	return _mm256_blendv_epi8(rgba4443, rgb555, is_rgb555);
+}
+
+TARGET_AVX2 static void DecodeRGB5A3(u32* dst, const u8* src, int width, int height)
+{
+	const int Wsteps4 = (width + 3) / 4;
+	// Every texel byteswapped into the low half of a 32 bit lane.
+	const __m256i mask = _mm256_setr_epi8(
+		1, 0, -1, -1, 3, 2, -1, -1, 5, 4, -1, -1, 7, 6, -1, -1,
+		9, 8, -1, -1, 11, 10, -1, -1, 13, 12, -1, -1, 15, 14, -1, -1);
+
+	#pragma omp parallel for
+	for (int y = 0; y < height; y += 4)
+		for (int x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
+		{
+			const u8* block = src + 32 * yStep;
+			u32* row = dst + y * width + x;
+			StoreTwoRows4(row, width, DecodeRGB5A3(LoadTwoRows16(block, mask)));
+			StoreTwoRows4(row + 2 * width, width, DecodeRGB5A3(LoadTwoRows16(block + 16, mask)));
+		}
+}
+
+TARGET_AVX2 static void DecodeRGBA8(u32* dst, const u8* src, int width, int height)
+{
+	const int Wsteps4 = (width + 3) / 4;
+	const __m256i mask0312 = _mm256_setr_epi8(
+		2, 1, 3, 0, 6, 5, 7, 4, 10, 9, 11, 8, 14, 13, 15, 12,
+		2, 1, 3, 0, 6, 5, 7, 4, 10, 9, 11, 8, 14, 13, 15, 12);
+
+	#pragma omp parallel for
+	for (int y = 0; y < height; y += 4)
+		for (int x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
+		{
+			// The AR halves of all 16 texels, then the GB halves.
+			const u8* block = src + 64 * yStep;
+			const __m256i ar = _mm256_loadu_si256((const __m256i*)block);
+			const __m256i gb = _mm256_loadu_si256((const __m256i*)(block + 32));
+
+			// Rows 0 and 2, and rows 1 and 3.
+			const __m256i rows02 = _mm256_shuffle_epi8(_mm256_unpacklo_epi8(ar, gb), mask0312);
+			const __m256i rows13 = _mm256_shuffle_epi8(_mm256_unpackhi_epi8(ar, gb), mask0312);
+
+			u32* row = dst + y * width + x;
+			_mm_storeu_si128((__m128i*)(row + 0 * width), _mm256_castsi256_si128(rows02));
+			_mm_storeu_si128((__m128i*)(row + 1 * width), _mm256_castsi256_si128(rows13));
+			_mm_storeu_si128((__m128i*)(row + 2 * width), _mm256_extracti128_si256(rows02, 1));
+			_mm_storeu_si128((__m128i*)(row + 3 * width), _mm256_extracti128_si256(rows13, 1));
+		}
+}
+
+TARGET_AVX2 static void DecodeCMPR(u32* dst, const u8* src, int width, int height)
+{
+	const int Wsteps8 = (width + 7) / 8;
+	// Both colors of every DXT block byteswapped into 32 bit lanes: color1
+	// in the even lanes, color2 in the odd ones.
+	const __m256i color_mask = _mm256_setr_epi8(
+		1, 0, -1, -1, 3, 2, -1, -1, 9, 8, -1, -1, 11, 10, -1, -1,
+		1, 0, -1, -1, 3, 2, -1, -1, 9, 8, -1, -1, 11, 10, -1, -1);
+	const __m256i kMask_x1f = _mm256_set1_epi32(0x1f);
+	const __m256i kMask_x3f = _mm256_set1_epi32(0x3f);
+	const __m256i kAlpha = _mm256_set1_epi32(0xff);
+	const __m256i kOne = _mm256_set1_epi32(1);
+	// Where the 2 bit index of each texel of a row is in its line byte.
+	const __m256i index_shift = _mm256_setr_epi32(6, 4, 2, 0, 6, 4, 2, 0);
+	const __m256i index_mask = _mm256_set1_epi32(3);
+	// The right half of a row looks up the second block's palette.
+	const __m256i index_offset = _mm256_setr_epi32(0, 0, 0, 0, 4, 4, 4, 4);
+
+	#pragma omp parallel for
+	for (int y = 0; y < height; y += 8)
+		for (int x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
+		{
+			// 4 DXT blocks: top left, top right, bottom left, bottom right.
+			const __m256i dxt = _mm256_loadu_si256((const __m256i*)(src + 32 * yStep));
+
+			// Every lane's color expanded to 8 bits per component. Each
+			// even lane also gets its block's other color.
+			const __m256i c = _mm256_shuffle_epi8(dxt, color_mask);
+			const __m256i r5 = _mm256_and_si256(_mm256_srli_epi32(c, 11), kMask_x1f);
+			const __m256i g6 = _mm256_and_si256(_mm256_srli_epi32(c, 5), kMask_x3f);
+			const __m256i b5 = _mm256_and_si256(c, kMask_x1f);
+			const __m256i red1 = _mm256_or_si256(_mm256_slli_epi32(r5, 3), _mm256_srli_epi32(r5, 2));
+			const __m256i green1 = _mm256_or_si256(_mm256_slli_epi32(g6, 2), _mm256_srli_epi32(g6, 4));
+			const __m256i blue1 = _mm256_or_si256(_mm256_slli_epi32(b5, 3), _mm256_srli_epi32(b5, 2));
+			const __m256i red2 = _mm256_shuffle_epi32(red1, _MM_SHUFFLE(2, 3, 0, 1));
+			const __m256i green2 = _mm256_shuffle_epi32(green1, _MM_SHUFFLE(2, 3, 0, 1));
+			const __m256i blue2 = _mm256_shuffle_epi32(blue1, _MM_SHUFFLE(2, 3, 0, 1));
+
+			// From here on only the even lanes matter, like decodeDXTBlockRGBA.
+			const __m256i color1_greater = _mm256_cmpgt_epi32(c, _mm256_shuffle_epi32(c, _MM_SHUFFLE(2, 3, 0, 1)));
+
+			const __m256i color0 = MakeRGBA(red1, green1, blue1, kAlpha);
+			const __m256i color1 = MakeRGBA(red2, green2, blue2, kAlpha);
+
+			// color1 > color2: colors 2 and 3 a third of the way from each end.
+			const __m256i red_diff = _mm256_sub_epi32(red2, red1);
+			const __m256i green_diff = _mm256_sub_epi32(green2, green1);
+			const __m256i blue_diff = _mm256_sub_epi32(blue2, blue1);
+			const __m256i red3 = _mm256_sub_epi32(_mm256_srai_epi32(red_diff, 1), _mm256_srai_epi32(red_diff, 3));
+			const __m256i green3 = _mm256_sub_epi32(_mm256_srai_epi32(green_diff, 1), _mm256_srai_epi32(green_diff, 3));
+			const __m256i blue3 = _mm256_sub_epi32(_mm256_srai_epi32(blue_diff, 1), _mm256_srai_epi32(blue_diff, 3));
+			const __m256i color2_far = MakeRGBA(_mm256_add_epi32(red1, red3), _mm256_add_epi32(green1, green3),
+				_mm256_add_epi32(blue1, blue3), kAlpha);
+			const __m256i color3_far = MakeRGBA(_mm256_sub_epi32(red2, red3), _mm256_sub_epi32(green2, green3),
+				_mm256_sub_epi32(blue2, blue3), kAlpha);
+
+			// Otherwise: the average, and color2 but transparent.
+			const __m256i color2_avg = MakeRGBA(
+				_mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(red1, red2), kOne), 1),
+				_mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(green1, green2), kOne), 1),
+				_mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(blue1, blue2), kOne), 1),
+				kAlpha);
+			const __m256i color3_clear = MakeRGBA(red2, green2, blue2, _mm256_setzero_si256());
+
+			const __m256i color2 = _mm256_blendv_epi8(color2_avg, color2_far, color1_greater);
+			const __m256i color3 = _mm256_blendv_epi8(color3_clear, color3_far, color1_greater);
+
+			// Gather the four colors of each block: the low lane of palettes02
+			// is the palette of the top left block, its high lane the one of
+			// the bottom left block.
+			const __m256i colors01_lo = _mm256_unpacklo_epi32(color0, color1);
+			const __m256i colors23_lo = _mm256_unpacklo_epi32(color2, color3);
+			const __m256i colors01_hi = _mm256_unpackhi_epi32(color0, color1);
+			const __m256i colors23_hi = _mm256_unpackhi_epi32(color2, color3);
+			const __m256i palettes02 = _mm256_unpacklo_epi64(colors01_lo, colors23_lo);
+			const __m256i palettes13 = _mm256_unpacklo_epi64(colors01_hi, colors23_hi);
+
+			for (int z = 0; z < 2; ++z)
+			{
+				// The palettes of the two blocks next to each other.
+				const __m256i palettes = z == 0 ?
+					_mm256_permute2x128_si256(palettes02, palettes13, 0x20) :
+					_mm256_permute2x128_si256(palettes02, palettes13, 0x31);
+				// The line bytes of the left block in the low lane, the
+				// ones of the right block in the high lane.
+				const __m256i lines = z == 0 ?
+					_mm256_permute4x64_epi64(dxt, _MM_SHUFFLE(1, 1, 0, 0)) :
+					_mm256_permute4x64_epi64(dxt, _MM_SHUFFLE(3, 3, 2, 2));
+
+				u32* row = dst + (y + z * 4) * width + x;
+				for (int iy = 0; iy < 4; ++iy)
+				{
+					const __m256i line = _mm256_shuffle_epi8(lines, _mm256_set1_epi32(4 + iy));
+					const __m256i index = _mm256_or_si256(
+						_mm256_and_si256(_mm256_srlv_epi32(line, index_shift), index_mask), index_offset);
+					_mm256_storeu_si256((__m256i*)(row + iy * width), _mm256_permutevar8x32_epi32(palettes, index));
+				}
+			}
+		}
+}
+
+bool TexDecoder_Decode_RGBA_AVX2(u32* dst, const u8* src, int width, int height, int texformat)
+{
+	switch (texformat)
+	{
+	case GX_TF_I4:
+		DecodeI4(dst, src, width, height);
+		return true;
+	case GX_TF_I8:
+		DecodeI8(dst, src, width, height);
+		return true;
+	case GX_TF_IA8:
+		DecodeIA8(dst, src, width, height);
+		return true;
+	case GX_TF_RGB565:
+		DecodeRGB565(dst, src, width, height);
+		return true;
+	case GX_TF_RGB5A3:
+		DecodeRGB5A3(dst, src, width, height);
+		return true;
+	case GX_TF_RGBA8:
+		DecodeRGBA8(dst, src, width, height);
+		return true;
+	case GX_TF_CMPR:
+		DecodeCMPR(dst, src, width, height);
+		return true;
+	default:
+		return false;
+	}
+}
@@ -0,0 +1,94 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+// Finds the texture cache entries close to a range of emulated memory
+// without looking at all of them. Every 16 KiB page of physical memory keeps
+// a list of the entries overlapping it.
+//
+// Entry needs addr and size_in_bytes members. An entry covers
+// [addr, addr + size_in_bytes], like TCacheEntryBase::IntersectsMemoryRange,
+// so EFB copies, which have no size, still cover their first byte. The two
+// members must not change between Insert and Remove.
+template <typename Entry>
+class TexturePageIndex
+{
+public:
+	TexturePageIndex() : m_pages(NUM_PAGES) {}
+
+	void Insert(Entry* entry)
+	{
+		u32 last = LastPage(entry->addr, entry->size_in_bytes);
+		for (u32 page = FirstPage(entry->addr); page <= last; ++page)
+			m_pages[page].push_back(entry);
+	}
+
+	void Remove(Entry* entry)
+	{
+		u32 last = LastPage(entry->addr, entry->size_in_bytes);
+		for (u32 page = FirstPage(entry->addr); page <= last; ++page)
+		{
+			std::vector<Entry*>& entries = m_pages[page];
+			auto it = std::find(entries.begin(), entries.end(), entry);
+			if (it != entries.end())
+			{
+				*it = entries.back();
+				entries.pop_back();
+			}
+		}
+	}
+
+	void Clear()
+	{
+		for (auto& entries : m_pages)
+			entries.clear();
+	}
+
+	// Calls f once for every entry sharing a page with
+	// [start_address, start_address + size]. These are candidates, the
+	// caller still has to check them. f must not change the index; collect
+	// the entries first to remove them.
+	template <typename F>
+	void ForEachInRange(u32 start_address, u32 size, F f) const
+	{
+		u32 first = FirstPage(start_address);
+		u32 last = LastPage(start_address, size);
+		for (u32 page = first; page <= last; ++page)
+		{
+			for (Entry* entry : m_pages[page])
+			{
+				// Entries spanning several pages of the range are only
+				// reported from the first of them.
+				if (page == first || FirstPage(entry->addr) == page)
+					f(entry);
+			}
+		}
+	}
+
+private:
+	enum
+	{
+		PAGE_SHIFT = 14,
+		NUM_PAGES = 0x20000000 >> PAGE_SHIFT,
+	};
+
+	static u32 FirstPage(u32 address)
+	{
+		return (address & 0x1FFFFFFF) >> PAGE_SHIFT;
+	}
+
+	static u32 LastPage(u32 address, u32 size)
+	{
+		u32 end = (address & 0x1FFFFFFF) + size;
+		return std::min<u32>(end >> PAGE_SHIFT, NUM_PAGES - 1);
+	}
+
+	std::vector<std::vector<Entry*>> m_pages;
+};
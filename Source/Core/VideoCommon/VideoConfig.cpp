@@ -51,6 +51,8 @@ void VideoConfig::Load(const std::string& ini_file)
 	iniFile.Get("Settings", "UseXFB", &bUseXFB, 0);
 	iniFile.Get("Settings", "UseRealXFB", &bUseRealXFB, 0);
 	iniFile.Get("Settings", "SafeTextureCacheColorSamples", &iSafeTextureCache_ColorSamples,128);
+	iniFile.Get("Settings", "SafeTextureCacheVerifyFrames", &iSafeTextureCache_VerifyFrames, 0);
+	iniFile.Get("Settings", "TexturePoolSize", &iTexturePoolSize, 64);
 	iniFile.Get("Settings", "ShowFPS", &bShowFPS, false); // Settings
 	iniFile.Get("Settings", "LogFPSToFile", &bLogFPSToFile, false);
 	iniFile.Get("Settings", "ShowInputDisplay", &bShowInputDisplay, false);
@@ -81,6 +83,7 @@ void VideoConfig::Load(const std::string& ini_file)
 	iniFile.Get("Settings", "DisableFog", &bDisableFog, 0);
 
 	iniFile.Get("Settings", "OMPDecoder", &bOMPDecoder, false);
+	iniFile.Get("Settings", "TextureDecodeThreads", &iTextureDecodeThreads, -1);
 
 	iniFile.Get("Settings", "EnableShaderDebugging", &bEnableShaderDebugging, false);
 
@@ -143,6 +146,8 @@ void VideoConfig::GameIniLoad()
 	CHECK_SETTING("Video_Settings", "UseXFB", bUseXFB);
 	CHECK_SETTING("Video_Settings", "UseRealXFB", bUseRealXFB);
 	CHECK_SETTING("Video_Settings", "SafeTextureCacheColorSamples", iSafeTextureCache_ColorSamples);
+	CHECK_SETTING("Video_Settings", "SafeTextureCacheVerifyFrames", iSafeTextureCache_VerifyFrames);
+	CHECK_SETTING("Video_Settings", "TexturePoolSize", iTexturePoolSize);
 	CHECK_SETTING("Video_Settings", "DLOptimize", iCompileDLsLevel);
 	CHECK_SETTING("Video_Settings", "HiresTextures", bHiresTextures);
 	CHECK_SETTING("Video_Settings", "AnaglyphStereo", bAnaglyphStereo);
@@ -181,6 +186,7 @@ void VideoConfig::GameIniLoad()
 	CHECK_SETTING("Video_Settings", "DstAlphaPass", bDstAlphaPass);
 	CHECK_SETTING("Video_Settings", "DisableFog", bDisableFog);
 	CHECK_SETTING("Video_Settings", "OMPDecoder", bOMPDecoder);
+	CHECK_SETTING("Video_Settings", "TextureDecodeThreads", iTextureDecodeThreads);
 
 	CHECK_SETTING("Video_Enhancements", "ForceFiltering", bForceFiltering);
 	CHECK_SETTING("Video_Enhancements", "MaxAnisotropy", iMaxAnisotropy);  // NOTE - this is x in (1 << x)
@@ -225,6 +231,8 @@ void VideoConfig::Save(const std::string& ini_file)
 	iniFile.Set("Settings", "UseXFB", bUseXFB);
 	iniFile.Set("Settings", "UseRealXFB", bUseRealXFB);
 	iniFile.Set("Settings", "SafeTextureCacheColorSamples", iSafeTextureCache_ColorSamples);
+	iniFile.Set("Settings", "SafeTextureCacheVerifyFrames", iSafeTextureCache_VerifyFrames);
+	iniFile.Set("Settings", "TexturePoolSize", iTexturePoolSize);
 	iniFile.Set("Settings", "ShowFPS", bShowFPS);
 	iniFile.Set("Settings", "LogFPSToFile", bLogFPSToFile);
 	iniFile.Set("Settings", "ShowInputDisplay", bShowInputDisplay);
@@ -254,6 +262,7 @@ void VideoConfig::Save(const std::string& ini_file)
 	iniFile.Set("Settings", "DisableFog", bDisableFog);
 
 	iniFile.Set("Settings", "OMPDecoder", bOMPDecoder);
+	iniFile.Set("Settings", "TextureDecodeThreads", iTextureDecodeThreads);
 
 	iniFile.Set("Settings", "EnableShaderDebugging", bEnableShaderDebugging);
 
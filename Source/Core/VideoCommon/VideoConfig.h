@@ -69,6 +69,7 @@ struct VideoConfig final
 
 	// OpenMP
 	bool bOMPDecoder;
+	int iTextureDecodeThreads; // Besides the GPU thread, -1 picks one from the number of cores
 
 	// Enhancements
 	int iMultisampleMode;
@@ -114,6 +115,10 @@ struct VideoConfig final
 	bool bCopyEFBToTexture;
 	bool bCopyEFBScaled;
 	int iSafeTextureCache_ColorSamples;
+	// With full hashing, textures whose sampled hash still matches are only
+	// fully hashed again after this many frames. 0 always hashes fully.
+	int iSafeTextureCache_VerifyFrames;
+	int iTexturePoolSize; // MiB of unused textures kept for reuse
 	int iPhackvalue[3];
 	std::string sPhackvalue[2];
 	float fAspectRatioHackW, fAspectRatioHackH;
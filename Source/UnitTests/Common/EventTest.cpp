@@ -2,6 +2,7 @@
 // Licensed under GPLv2
 // Refer to the license.txt file included.
 
+#include <chrono>
 #include <gtest/gtest.h>
 #include <thread>
 
@@ -40,3 +41,18 @@ TEST(Event, MultiThreaded)
 	sender_thread.join();
 	receiver_thread.join();
 }
+
+TEST(Event, WaitFor)
+{
+	Event ev;
+	EXPECT_FALSE(ev.WaitFor(std::chrono::milliseconds(1)));
+
+	ev.Set();
+	EXPECT_TRUE(ev.WaitFor(std::chrono::milliseconds(1)));
+	// The event was reset by the previous wait.
+	EXPECT_FALSE(ev.WaitFor(std::chrono::milliseconds(1)));
+
+	std::thread setter([&]() { ev.Set(); });
+	EXPECT_TRUE(ev.WaitFor(std::chrono::seconds(10)));
+	setter.join();
+}
@@ -0,0 +1,139 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <unordered_set>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "Common/CPUDetect.h"
+#include "Common/Hash.h"
+
+namespace
+{
+
+typedef u64 (*HashFunction)(const u8* src, int len, u32 samples);
+
+struct Hash
+{
+	const char* name;
+	HashFunction function;
+};
+
+// The 64 bit hashes GetHash64 can pick from on this machine.
+std::vector<Hash> GetHashes()
+{
+	std::vector<Hash> hashes;
+	hashes.push_back({ "MurmurHash3", &GetMurmurHash3 });
+	hashes.push_back({ "HiresTexture", &GetHashHiresTexture });
+	if (cpu_info.bSSE4_2)
+		hashes.push_back({ "CRC32", &GetCRC32 });
+	return hashes;
+}
+
+std::vector<u8> RandomData(size_t size)
+{
+	std::mt19937 rng(1234);
+	std::vector<u8> data(size);
+	for (u8& byte : data)
+		byte = (u8)rng();
+	return data;
+}
+
+}
+
+TEST(Hash, IgnoresDataPastLength)
+{
+	std::vector<u8> a = RandomData(128);
+	std::vector<u8> b = a;
+	for (const Hash& hash : GetHashes())
+	{
+		for (int len = 0; len < 100; ++len)
+		{
+			// Distinct bytes right after the end of the data.
+			for (size_t i = len; i < a.size(); ++i)
+				b[i] = ~a[i];
+			EXPECT_EQ(hash.function(a.data(), len, 0), hash.function(b.data(), len, 0)) << hash.name << " " << len;
+			for (size_t i = len; i < a.size(); ++i)
+				b[i] = a[i];
+		}
+	}
+}
+
+TEST(Hash, SingleBitFlipsDontCollide)
+{
+	std::vector<u8> data = RandomData(4096 + 5);
+	for (const Hash& hash : GetHashes())
+	{
+		std::unordered_set<u64> seen;
+		seen.insert(hash.function(data.data(), (int)data.size(), 0));
+		for (size_t bit = 0; bit < data.size() * 8; ++bit)
+		{
+			data[bit / 8] ^= 1 << (bit % 8);
+			EXPECT_TRUE(seen.insert(hash.function(data.data(), (int)data.size(), 0)).second) << hash.name << " bit " << bit;
+			data[bit / 8] ^= 1 << (bit % 8);
+		}
+	}
+}
+
+// Textures that mostly look alike: zeroes with a single byte set.
+TEST(Hash, SparseDataDoesntCollide)
+{
+	std::vector<u8> data(1024);
+	for (const Hash& hash : GetHashes())
+	{
+		std::unordered_set<u64> seen;
+		seen.insert(hash.function(data.data(), (int)data.size(), 0));
+		for (size_t i = 0; i < data.size(); ++i)
+		{
+			for (int value = 1; value < 256; ++value)
+			{
+				data[i] = value;
+				EXPECT_TRUE(seen.insert(hash.function(data.data(), (int)data.size(), 0)).second) << hash.name << " byte " << i << " = " << value;
+			}
+			data[i] = 0;
+		}
+	}
+}
+
+TEST(Hash, LengthChangesHash)
+{
+	std::vector<u8> data(1024);
+	for (const Hash& hash : GetHashes())
+	{
+		std::unordered_set<u64> seen;
+		for (int len = 1; len <= (int)data.size(); ++len)
+			EXPECT_TRUE(seen.insert(hash.function(data.data(), len, 0)).second) << hash.name << " " << len;
+	}
+}
+
+// Not a correctness test: MB/s of every hash, full and sampled.
+TEST(Hash, Benchmark)
+{
+	const int SIZE = 4 * 1024 * 1024;
+	const int RUNS = 20;
+	std::vector<u8> data = RandomData(SIZE);
+
+	printf("%-14s %12s %12s\n", "hash", "full", "128 samples");
+	for (const Hash& hash : GetHashes())
+	{
+		printf("%-14s", hash.name);
+		for (u32 samples : { 0u, 128u })
+		{
+			u64 result = 0;
+			auto start = std::chrono::high_resolution_clock::now();
+			for (int run = 0; run < RUNS; ++run)
+				result += hash.function(data.data(), SIZE, samples);
+			auto time = std::chrono::high_resolution_clock::now() - start;
+			double seconds = std::chrono::duration_cast<std::chrono::microseconds>(time).count() / 1e6;
+			printf(" %12.0f", (double)SIZE * RUNS / (1024 * 1024) / std::max(seconds, 1e-6));
+			// Keeps the hashing from being optimized out.
+			EXPECT_NE(0u, result);
+		}
+		printf("\n");
+	}
+}
@@ -0,0 +1,117 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <vector>
+
+// Before gtest: XEmitter has a TEST method, which the gtest macro breaks.
+#include "Common/x64Emitter.h"
+
+#include <gtest/gtest.h>
+
+using namespace Gen;
+
+namespace
+{
+
+class x64EmitterTest : public testing::Test
+{
+protected:
+	virtual void SetUp() override
+	{
+		memset(code_buffer, 0, sizeof(code_buffer));
+		emitter.SetCodePtr(code_buffer);
+	}
+
+	// Checks the code emitted since the last call, which is reset afterwards.
+	void ExpectBytes(const std::vector<u8>& expected)
+	{
+		std::vector<u8> emitted((const u8*)code_buffer, emitter.GetCodePtr());
+		EXPECT_EQ(expected, emitted);
+		emitter.SetCodePtr(code_buffer);
+	}
+
+	u8 code_buffer[64];
+	XEmitter emitter;
+};
+
+}  // namespace
+
+// The expected encodings are from an assembler.
+#define VEX_3OP_TEST(Name, Op, expected) \
+	TEST_F(x64EmitterTest, Name) \
+	{ \
+		emitter.Op(XMM0, XMM1, R(XMM2)); \
+		ExpectBytes(expected); \
+	}
+
+VEX_3OP_TEST(VADDPD, VADDPD, std::vector<u8>({0xC5, 0xF1, 0x58, 0xC2}))
+VEX_3OP_TEST(VSUBPD, VSUBPD, std::vector<u8>({0xC5, 0xF1, 0x5C, 0xC2}))
+VEX_3OP_TEST(VMULPD, VMULPD, std::vector<u8>({0xC5, 0xF1, 0x59, 0xC2}))
+VEX_3OP_TEST(VDIVPD, VDIVPD, std::vector<u8>({0xC5, 0xF1, 0x5E, 0xC2}))
+VEX_3OP_TEST(VANDPD, VANDPD, std::vector<u8>({0xC5, 0xF1, 0x54, 0xC2}))
+VEX_3OP_TEST(VANDNPD, VANDNPD, std::vector<u8>({0xC5, 0xF1, 0x55, 0xC2}))
+VEX_3OP_TEST(VORPD, VORPD, std::vector<u8>({0xC5, 0xF1, 0x56, 0xC2}))
+VEX_3OP_TEST(VXORPD, VXORPD, std::vector<u8>({0xC5, 0xF1, 0x57, 0xC2}))
+VEX_3OP_TEST(VPAND, VPAND, std::vector<u8>({0xC5, 0xF1, 0xDB, 0xC2}))
+VEX_3OP_TEST(VPANDN, VPANDN, std::vector<u8>({0xC5, 0xF1, 0xDF, 0xC2}))
+VEX_3OP_TEST(VPOR, VPOR, std::vector<u8>({0xC5, 0xF1, 0xEB, 0xC2}))
+VEX_3OP_TEST(VPXOR, VPXOR, std::vector<u8>({0xC5, 0xF1, 0xEF, 0xC2}))
+VEX_3OP_TEST(VUNPCKLPD, VUNPCKLPD, std::vector<u8>({0xC5, 0xF1, 0x14, 0xC2}))
+VEX_3OP_TEST(VUNPCKHPD, VUNPCKHPD, std::vector<u8>({0xC5, 0xF1, 0x15, 0xC2}))
+
+TEST_F(x64EmitterTest, ScalarDouble)
+{
+	emitter.VADDSD(XMM0, XMM1, R(XMM2));
+	ExpectBytes({0xC5, 0xF3, 0x58, 0xC2});
+	emitter.VSUBSD(XMM3, XMM4, R(XMM5));
+	ExpectBytes({0xC5, 0xDB, 0x5C, 0xDD});
+	emitter.VMULSD(XMM1, XMM2, R(XMM3));
+	ExpectBytes({0xC5, 0xEB, 0x59, 0xCB});
+	emitter.VDIVSD(XMM1, XMM2, R(XMM3));
+	ExpectBytes({0xC5, 0xEB, 0x5E, 0xCB});
+	emitter.VSQRTSD(XMM1, XMM2, R(XMM3));
+	ExpectBytes({0xC5, 0xEB, 0x51, 0xCB});
+}
+
+TEST_F(x64EmitterTest, ExtendedRegisters)
+{
+	// These need the three byte VEX prefix.
+	emitter.VADDSD(XMM8, XMM9, R(XMM10));
+	ExpectBytes({0xC4, 0x41, 0x33, 0x58, 0xC2});
+	emitter.VADDPD(XMM1, XMM2, R(XMM12));
+	ExpectBytes({0xC4, 0xC1, 0x69, 0x58, 0xCC});
+	emitter.VBLENDVPD(XMM9, XMM10, R(XMM11), XMM12);
+	ExpectBytes({0xC4, 0x43, 0x29, 0x4B, 0xCB, 0xC0});
+}
+
+TEST_F(x64EmitterTest, MemoryOperands)
+{
+	emitter.VMULPD(XMM1, XMM2, MComplex(RAX, RCX, SCALE_8, 0x10));
+	ExpectBytes({0xC5, 0xE9, 0x59, 0x4C, 0xC8, 0x10});
+	emitter.VADDSD(XMM1, XMM2, MatR(R8));
+	ExpectBytes({0xC4, 0xC1, 0x6B, 0x58, 0x08});
+}
+
+TEST_F(x64EmitterTest, Immediates)
+{
+	emitter.VSHUFPD(XMM0, XMM1, R(XMM2), 1);
+	ExpectBytes({0xC5, 0xF1, 0xC6, 0xC2, 0x01});
+	emitter.VBLENDPD(XMM0, XMM1, R(XMM2), 2);
+	ExpectBytes({0xC4, 0xE3, 0x71, 0x0D, 0xC2, 0x02});
+	emitter.VBLENDVPD(XMM0, XMM1, R(XMM2), XMM3);
+	ExpectBytes({0xC4, 0xE3, 0x71, 0x4B, 0xC2, 0x30});
+}
+
+TEST_F(x64EmitterTest, FusedMultiplyAdd)
+{
+	emitter.VFMADD213SD(XMM0, XMM1, R(XMM2));
+	ExpectBytes({0xC4, 0xE2, 0xF1, 0xA9, 0xC2});
+	emitter.VFMADD231PD(XMM8, XMM9, R(XMM10));
+	ExpectBytes({0xC4, 0x42, 0xB1, 0xB8, 0xC2});
+	emitter.VFMSUB213PD(XMM0, XMM1, MDisp(RAX, 0x10));
+	ExpectBytes({0xC4, 0xE2, 0xF1, 0xAA, 0x40, 0x10});
+	emitter.VFMSUB132SD(XMM0, XMM1, R(XMM2));
+	ExpectBytes({0xC4, 0xE2, 0xF1, 0x9B, 0xC2});
+}
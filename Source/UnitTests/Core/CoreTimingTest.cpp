@@ -0,0 +1,208 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "VideoCommon/VideoBackendBase.h"
+
+// CoreTiming.cpp is built into this test on its own, without the rest of the
+// emulator, so provide the few symbols it needs from it.
+namespace Core
+{
+bool IsCPUThread() { return true; }
+}
+VideoBackend* g_video_backend = nullptr;
+
+namespace
+{
+
+std::vector<u64> s_fired;
+
+void RecordCallback(u64 userdata, int cyclesLate)
+{
+	EXPECT_EQ(0, cyclesLate);
+	s_fired.push_back(userdata);
+}
+
+class CoreTimingTest : public testing::Test
+{
+protected:
+	virtual void SetUp() override
+	{
+		s_fired.clear();
+		CoreTiming::Init();
+	}
+
+	virtual void TearDown() override
+	{
+		CoreTiming::Shutdown();
+	}
+
+	// Runs the CPU up to the next event and processes it. The current slice
+	// is ended first so that newly scheduled events are taken into account.
+	void AdvanceToNextEvent()
+	{
+		CoreTiming::ForceExceptionCheck(0);
+		CoreTiming::Advance();
+		CoreTiming::downcount = 0;
+		CoreTiming::Advance();
+	}
+};
+
+}  // namespace
+
+TEST_F(CoreTimingTest, Ordering)
+{
+	int ev = CoreTiming::RegisterEvent("test", RecordCallback);
+
+	CoreTiming::ScheduleEvent(300, ev, 3);
+	CoreTiming::ScheduleEvent(100, ev, 1);
+	CoreTiming::ScheduleEvent(200, ev, 2);
+	// Events scheduled for the same time run in scheduling order.
+	CoreTiming::ScheduleEvent(200, ev, 4);
+	CoreTiming::ScheduleEvent(200, ev, 5);
+
+	// The three events at time 200 all run in the second slice.
+	for (int i = 0; i < 3; ++i)
+		AdvanceToNextEvent();
+
+	std::vector<u64> expected = {1, 2, 4, 5, 3};
+	EXPECT_EQ(expected, s_fired);
+	EXPECT_EQ(300u, CoreTiming::GetTicks());
+	EXPECT_FALSE(CoreTiming::IsScheduled(ev));
+}
+
+TEST_F(CoreTimingTest, RemoveEvent)
+{
+	int ev_a = CoreTiming::RegisterEvent("a", RecordCallback);
+	int ev_b = CoreTiming::RegisterEvent("b", RecordCallback);
+	int ev_c = CoreTiming::RegisterEvent("c", RecordCallback);
+
+	for (u64 i = 0; i < 10; ++i)
+	{
+		CoreTiming::ScheduleEvent(100 + (int)i * 10, ev_a, i);
+		CoreTiming::ScheduleEvent(105 + (int)i * 10, ev_b, 100 + i);
+	}
+	EXPECT_TRUE(CoreTiming::IsScheduled(ev_a));
+	EXPECT_TRUE(CoreTiming::IsScheduled(ev_b));
+	EXPECT_FALSE(CoreTiming::IsScheduled(ev_c));
+
+	CoreTiming::RemoveEvent(ev_a);
+	EXPECT_FALSE(CoreTiming::IsScheduled(ev_a));
+	EXPECT_TRUE(CoreTiming::IsScheduled(ev_b));
+
+	for (int i = 0; i < 10; ++i)
+		AdvanceToNextEvent();
+
+	ASSERT_EQ(10u, s_fired.size());
+	for (u64 i = 0; i < 10; ++i)
+		EXPECT_EQ(100 + i, s_fired[i]);
+}
+
+TEST_F(CoreTimingTest, ManyEvents)
+{
+	int ev = CoreTiming::RegisterEvent("test", RecordCallback);
+
+	// More events than the initial pool holds.
+	const int NUM_EVENTS = 5000;
+	for (int i = 0; i < NUM_EVENTS; ++i)
+		CoreTiming::ScheduleEvent(1 + (i * 7919) % NUM_EVENTS, ev, (i * 7919) % NUM_EVENTS);
+
+	for (int i = 0; i < NUM_EVENTS; ++i)
+		AdvanceToNextEvent();
+
+	ASSERT_EQ((size_t)NUM_EVENTS, s_fired.size());
+	for (int i = 0; i < NUM_EVENTS; ++i)
+		EXPECT_EQ((u64)i, s_fired[i]);
+}
+
+// Events from another thread keep their order even while the CPU thread moves
+// them concurrently and the ring overflows.
+TEST_F(CoreTimingTest, ThreadsafeOrdering)
+{
+	int ev = CoreTiming::RegisterEvent("test", RecordCallback);
+
+	const int NUM_EVENTS = 100000;
+	std::atomic<bool> done(false);
+	std::thread writer([&] {
+		for (int i = 0; i < NUM_EVENTS; ++i)
+			CoreTiming::ScheduleEvent_Threadsafe(0, ev, i);
+		done = true;
+	});
+	while (!done)
+		CoreTiming::MoveEvents();
+	writer.join();
+
+	AdvanceToNextEvent();
+
+	ASSERT_EQ((size_t)NUM_EVENTS, s_fired.size());
+	for (int i = 0; i < NUM_EVENTS; ++i)
+		ASSERT_EQ((u64)i, s_fired[i]);
+}
+
+namespace
+{
+
+std::vector<int> s_types;
+u32 s_random;
+
+// Spreads the events over the next 10000 cycles.
+int NextDelay()
+{
+	s_random = s_random * 1664525 + 1013904223;
+	return 100 + (int)(s_random >> 8) % 10000;
+}
+
+// Every type has one event pending at all times, which re-arms itself.
+void RearmCallback(u64 userdata, int cyclesLate)
+{
+	CoreTiming::ScheduleEvent(NextDelay(), s_types[userdata], userdata);
+}
+
+}  // namespace
+
+// Not a correctness test: mimics the hardware events that keep re-arming
+// themselves, and reports how long the scheduler takes to process them.
+TEST_F(CoreTimingTest, Benchmark)
+{
+	for (int num_events : {8, 16, 32, 64, 128, 256, 1024})
+	{
+		s_types.clear();
+		for (int i = 0; i < num_events; ++i)
+			s_types.push_back(CoreTiming::RegisterEvent("bench" + std::to_string(num_events) + "_" + std::to_string(i), RearmCallback));
+
+		for (int i = 0; i < num_events; ++i)
+			CoreTiming::ScheduleEvent(NextDelay(), s_types[i], i);
+
+		const int ITERATIONS = 1000000;
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < ITERATIONS; ++i)
+		{
+			AdvanceToNextEvent();
+			// Most hardware checks for and cancels pending events as well.
+			int slot = i % num_events;
+			int type = s_types[slot];
+			if (CoreTiming::IsScheduled(type))
+			{
+				CoreTiming::RemoveEvent(type);
+				CoreTiming::ScheduleEvent(NextDelay(), type, slot);
+			}
+		}
+		auto end = std::chrono::high_resolution_clock::now();
+
+		double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+		printf("%d scheduler iterations with %d pending events: %.1f ns/iteration\n",
+		       ITERATIONS, num_events, ns / ITERATIONS);
+
+		CoreTiming::ClearPendingEvents();
+	}
+}
@@ -0,0 +1,265 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+
+// Before gtest: XEmitter has a TEST method, which the gtest macro breaks.
+#include "Common/CommonTypes.h"
+#include "Common/CPUDetect.h"
+#include "Common/x64ABI.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/JitCommon/Jit_Util.h"
+
+#include <gtest/gtest.h>
+
+using namespace Gen;
+
+// The interpreter's floating point code is built into this test on its own,
+// without the rest of the emulator, so provide the few symbols it needs.
+namespace PowerPC
+{
+InstructionCache::InstructionCache() {}
+PowerPCState GC_ALIGNED16(ppcState);
+}
+void UpdateFPRF(double dvalue) {}
+bool Interpreter::m_FusedMultiplyAdd;
+u32 Interpreter::Helper_Get_EA_X(const UGeckoInstruction _inst) { return 0; }
+void Memory::Memset(const u32 _Address, const u8 _Data, const u32 _iLength) {}
+
+namespace
+{
+
+struct MultiplyAddOp
+{
+	const char* name;
+	void (*interpret)(UGeckoInstruction);
+	bool subtract;
+	bool negate;
+	bool packed;
+	bool single;
+};
+
+const MultiplyAddOp s_ops[] = {
+	{"fmadd",    Interpreter::fmaddx,    false, false, false, false},
+	{"fmsub",    Interpreter::fmsubx,    true,  false, false, false},
+	{"fnmadd",   Interpreter::fnmaddx,   false, true,  false, false},
+	{"fnmsub",   Interpreter::fnmsubx,   true,  true,  false, false},
+	{"fmadds",   Interpreter::fmaddsx,   false, false, false, true},
+	{"fmsubs",   Interpreter::fmsubsx,   true,  false, false, true},
+	{"fnmadds",  Interpreter::fnmaddsx,  false, true,  false, true},
+	{"fnmsubs",  Interpreter::fnmsubsx,  true,  true,  false, true},
+	{"ps_madd",  Interpreter::ps_madd,   false, false, true,  true},
+	{"ps_msub",  Interpreter::ps_msub,   true,  false, true,  true},
+	{"ps_nmadd", Interpreter::ps_nmadd,  false, true,  true,  true},
+	{"ps_nmsub", Interpreter::ps_nmsub,  true,  true,  true,  true},
+};
+
+// a, c, b and the result, two lanes each.
+struct GC_ALIGNED16(Operands)
+{
+	double a[2];
+	double c[2];
+	double b[2];
+	double d[2];
+};
+
+typedef void (*CompiledOp)(Operands* operands);
+
+u64 Bits(double d)
+{
+	u64 bits;
+	memcpy(&bits, &d, sizeof(bits));
+	return bits;
+}
+
+double RandomDouble(std::mt19937_64& rng, int max_exponent)
+{
+	std::uniform_int_distribution<int> exponent(-max_exponent, max_exponent);
+	u64 bits = (rng() & 0x800FFFFFFFFFFFFFULL) | ((u64)(1023 + exponent(rng)) << 52);
+	double d;
+	memcpy(&d, &bits, sizeof(d));
+	return d;
+}
+
+class FusedMultiplyAddTest : public testing::Test
+{
+protected:
+	virtual void SetUp() override
+	{
+		code.AllocCodeSpace(4096);
+	}
+
+	virtual void TearDown() override
+	{
+		code.FreeCodeSpace();
+	}
+
+	// The same sequence Jit64 emits for the op, with the operands in memory.
+	CompiledOp Compile(const MultiplyAddOp& op, bool fused)
+	{
+		CompiledOp func = (CompiledOp)code.GetCodePtr();
+		code.MOVAPD(XMM0, MDisp(ABI_PARAM1, offsetof(Operands, a)));
+		code.MOVAPD(XMM2, MDisp(ABI_PARAM1, offsetof(Operands, c)));
+		code.MultiplyAdd(XMM0, XMM2, MDisp(ABI_PARAM1, offsetof(Operands, b)), op.subtract, op.negate, op.packed, fused);
+		// What ForceSinglePrecision does with Jit64's options.
+		if (op.single && op.packed)
+		{
+			code.CVTPD2PS(XMM0, R(XMM0));
+			code.CVTPS2PD(XMM0, R(XMM0));
+		}
+		else if (op.single)
+		{
+			code.CVTSD2SS(XMM0, R(XMM0));
+			code.CVTSS2SD(XMM0, R(XMM0));
+		}
+		code.MOVAPD(MDisp(ABI_PARAM1, offsetof(Operands, d)), XMM0);
+		code.RET();
+		return func;
+	}
+
+	// Runs the op in the interpreter, the result ends up in operands.d.
+	void Interpret(const MultiplyAddOp& op, Operands* operands)
+	{
+		const int FA = 1, FB = 2, FC = 3, FD = 4;
+		UGeckoInstruction inst;
+		inst.FA = FA;
+		inst.FB = FB;
+		inst.FC = FC;
+		inst.FD = FD;
+		for (int i = 0; i < 2; ++i)
+		{
+			PowerPC::ppcState.ps[FA][i] = Bits(operands->a[i]);
+			PowerPC::ppcState.ps[FB][i] = Bits(operands->b[i]);
+			PowerPC::ppcState.ps[FC][i] = Bits(operands->c[i]);
+		}
+		op.interpret(inst);
+		for (int i = 0; i < 2; ++i)
+			memcpy(&operands->d[i], &PowerPC::ppcState.ps[FD][i], sizeof(double));
+	}
+
+	void Check(const MultiplyAddOp& op, CompiledOp func, const Operands& operands)
+	{
+		Operands interpreted = operands;
+		Interpret(op, &interpreted);
+		Operands jitted = operands;
+		func(&jitted);
+
+		for (int i = 0; i < (op.packed ? 2 : 1); ++i)
+		{
+			EXPECT_EQ(Bits(interpreted.d[i]), Bits(jitted.d[i]))
+				<< op.name << " lane " << i << ": " << operands.a[i] << " * " << operands.c[i]
+				<< " +/- " << operands.b[i];
+		}
+	}
+
+	// Compares the interpreter and the emitted code over special values and
+	// random operands, both rounding the same way.
+	void CheckAll(bool fused)
+	{
+		Interpreter::m_FusedMultiplyAdd = fused;
+
+		const double specials[] = {
+			0.0, -0.0, 1.0, -1.0, 0.5, 3.0,
+			std::numeric_limits<double>::infinity(),
+			-std::numeric_limits<double>::infinity(),
+			std::numeric_limits<double>::denorm_min(),
+			std::numeric_limits<double>::max(),
+			std::numeric_limits<float>::max(),
+		};
+
+		for (const MultiplyAddOp& op : s_ops)
+		{
+			CompiledOp func = Compile(op, fused);
+			std::mt19937_64 rng(12345);
+			Operands operands;
+
+			for (double a : specials)
+			{
+				for (double c : specials)
+				{
+					for (double b : specials)
+					{
+						operands.a[0] = operands.a[1] = a;
+						operands.c[0] = operands.c[1] = c;
+						operands.b[0] = b;
+						operands.b[1] = -b;
+						Check(op, func, operands);
+					}
+				}
+			}
+
+			// Keep the singles mostly in range.
+			int max_exponent = op.single ? 60 : 500;
+			for (int iteration = 0; iteration < 20000; ++iteration)
+			{
+				for (int i = 0; i < 2; ++i)
+				{
+					operands.a[i] = RandomDouble(rng, max_exponent);
+					operands.c[i] = RandomDouble(rng, max_exponent);
+					// Cancel out most of the product every other time: this is where
+					// a separate multiply and add lose the low bits.
+					if (iteration & 1)
+						operands.b[i] = (i ? -1 : 1) * operands.a[i] * operands.c[i];
+					else
+						operands.b[i] = RandomDouble(rng, max_exponent);
+				}
+				Check(op, func, operands);
+			}
+		}
+	}
+
+	EmuCodeBlock code;
+};
+
+}  // namespace
+
+// What every core does by default.
+TEST_F(FusedMultiplyAddTest, UnfusedMatchesInterpreter)
+{
+	CheckAll(false);
+}
+
+// Jit64 only emits the fused sequence on hosts with FMA3, and leaves the
+// instructions to the interpreter on the others.
+TEST_F(FusedMultiplyAddTest, FusedMatchesInterpreter)
+{
+	if (cpu_info.bFMA)
+		CheckAll(true);
+}
+
+// (1 + e) * (1 - e) = 1 - e^2, which rounds to 1 for small e: subtracting 1
+// leaves -e^2 if the product isn't rounded first, and 0 if it is.
+TEST_F(FusedMultiplyAddTest, InterpreterRoundsOnceWhenFused)
+{
+	for (bool fused : { false, true })
+	{
+		Interpreter::m_FusedMultiplyAdd = fused;
+		for (const MultiplyAddOp& op : s_ops)
+		{
+			for (int k = 27; k <= 52; ++k)
+			{
+				double e = std::ldexp(1.0, -k);
+				Operands operands;
+				for (int i = 0; i < 2; ++i)
+				{
+					operands.a[i] = 1.0 + e;
+					operands.c[i] = 1.0 - e;
+					operands.b[i] = op.subtract ? 1.0 : -1.0;
+				}
+				Interpret(op, &operands);
+
+				double expected = fused ? -e * e : 0.0;
+				if (op.negate)
+					expected = -expected;
+				for (int i = 0; i < (op.packed ? 2 : 1); ++i)
+					EXPECT_EQ(Bits(expected), Bits(operands.d[i])) << op.name << (fused ? " fused" : " unfused") << " e = 2^-" << k;
+			}
+		}
+	}
+}
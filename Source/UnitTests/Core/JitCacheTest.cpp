@@ -0,0 +1,290 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstdio>
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/PPCSymbolDB.h"
+#include "Core/PowerPC/JitCommon/JitCache.h"
+
+// JitCache.cpp is built into this test on its own, without the rest of the
+// emulator, so provide the few symbols it needs from it.
+class JitBase;
+JitBase* jit = nullptr;
+namespace PowerPC
+{
+InstructionCache::InstructionCache() {}
+PowerPCState ppcState;
+}
+PPCSymbolDB g_symbolDB;
+PPCSymbolDB::PPCSymbolDB() : debugger(nullptr) {}
+PPCSymbolDB::~PPCSymbolDB() {}
+Symbol* PPCSymbolDB::AddFunction(u32 startAddr) { return nullptr; }
+Symbol* PPCSymbolDB::GetSymbolFromAddr(u32 addr) { return nullptr; }
+const std::string PPCSymbolDB::GetDescription(u32 addr) { return ""; }
+
+namespace
+{
+
+// Keeps track of the blocks without generating any code.
+class TestBlockCache : public JitBaseBlockCache
+{
+public:
+	int num_destroyed = 0;
+
+	// Adds a block of num_instructions instructions at address, which exits
+	// to exit_address. Its code pretends to be at code.
+	int AddBlock(u32 address, u32 num_instructions, u32 exit_address, u8* code = s_code,
+	             const std::vector<std::pair<u32, u32>>& inlined = {})
+	{
+		int block_num = AllocateBlock(address);
+		JitBlock* b = GetBlock(block_num);
+		b->checkedEntry = b->normalEntry = code;
+		b->originalSize = num_instructions;
+		b->codeSize = 0;
+		b->inlinedCode = inlined;
+
+		JitBlock::LinkData link;
+		link.exitPtrs = code;
+		link.exitAddress = exit_address;
+		link.linkStatus = false;
+		b->linkData.push_back(link);
+
+		FinalizeBlock(block_num, true, code);
+		return block_num;
+	}
+
+private:
+	static u8 s_code[16];
+
+	void WriteLinkBlock(u8* location, const u8* address) override {}
+	void WriteDestroyBlock(const u8* location, u32 address) override { ++num_destroyed; }
+};
+
+u8 TestBlockCache::s_code[16];
+
+class JitCacheTest : public testing::Test
+{
+protected:
+	virtual void SetUp() override
+	{
+		cache.Init();
+	}
+
+	virtual void TearDown() override
+	{
+		cache.Shutdown();
+	}
+
+	TestBlockCache cache;
+};
+
+}  // namespace
+
+TEST_F(JitCacheTest, Lookup)
+{
+	int a = cache.AddBlock(0x80003000, 4, 0x80003010);
+	int b = cache.AddBlock(0x80003010, 8, 0x80003000);
+
+	EXPECT_EQ(a, cache.GetBlockNumberFromStartAddress(0x80003000));
+	EXPECT_EQ(b, cache.GetBlockNumberFromStartAddress(0x80003010));
+	EXPECT_EQ(-1, cache.GetBlockNumberFromStartAddress(0x80003004));
+
+	// Both blocks were linked to each other.
+	EXPECT_TRUE(cache.GetBlock(a)->linkData[0].linkStatus);
+	EXPECT_TRUE(cache.GetBlock(b)->linkData[0].linkStatus);
+}
+
+TEST_F(JitCacheTest, InvalidateICache)
+{
+	int a = cache.AddBlock(0x80003000, 4, 0x80003010);
+	int b = cache.AddBlock(0x80003010, 8, 0x80003000);
+	// Crosses a page boundary.
+	int c = cache.AddBlock(0x80003ff0, 8, 0x80003000);
+	// Same physical address through a different mapping.
+	int d = cache.AddBlock(0xC0005000, 4, 0x80003000);
+
+	// Only touches the last instruction of b.
+	cache.InvalidateICache(0x8000302c, 4);
+	EXPECT_FALSE(cache.GetBlock(a)->invalid);
+	EXPECT_TRUE(cache.GetBlock(b)->invalid);
+	EXPECT_EQ(-1, cache.GetBlockNumberFromStartAddress(0x80003010));
+	// a exited to b, so it needs to go through the dispatcher again.
+	EXPECT_FALSE(cache.GetBlock(a)->linkData[0].linkStatus);
+
+	// Only touches the part of c in the second page.
+	cache.InvalidateICache(0x80004008, 32);
+	EXPECT_TRUE(cache.GetBlock(c)->invalid);
+	EXPECT_FALSE(cache.GetBlock(a)->invalid);
+
+	cache.InvalidateICache(0x80005000, 0x1000);
+	EXPECT_TRUE(cache.GetBlock(d)->invalid);
+	EXPECT_FALSE(cache.GetBlock(a)->invalid);
+
+	EXPECT_EQ(3, cache.num_destroyed);
+
+	// Recompiling a block at the same address works.
+	int e = cache.AddBlock(0x80003010, 8, 0x80003000);
+	EXPECT_EQ(e, cache.GetBlockNumberFromStartAddress(0x80003010));
+	cache.InvalidateICache(0x80003000, 0x100);
+	EXPECT_TRUE(cache.GetBlock(a)->invalid);
+	EXPECT_TRUE(cache.GetBlock(e)->invalid);
+	EXPECT_EQ(5, cache.num_destroyed);
+}
+
+TEST_F(JitCacheTest, InvalidateInlinedCode)
+{
+	static u8 code[16];
+	// Calls a function at 0x80010000 which was inlined, and one in the same
+	// page as the block.
+	int a = cache.AddBlock(0x80003000, 8, 0x80003020, code,
+	                       {{0x80010000, 4}, {0x80003100, 2}});
+	int b = cache.AddBlock(0x80003020, 8, 0x80003000);
+
+	// Around the inlined function, but not in it.
+	cache.InvalidateICache(0x8000ffe0, 0x20);
+	cache.InvalidateICache(0x80010010, 0x20);
+	EXPECT_FALSE(cache.GetBlock(a)->invalid);
+
+	cache.InvalidateICache(0x8001000c, 4);
+	EXPECT_TRUE(cache.GetBlock(a)->invalid);
+	EXPECT_FALSE(cache.GetBlock(b)->invalid);
+
+	// The dcbi fast path knows about the inlined code as well.
+	a = cache.AddBlock(0x80003000, 8, 0x80003020, code, {{0x80003100, 2}});
+	cache.InvalidateICache(0x80003100, 32);
+	EXPECT_TRUE(cache.GetBlock(a)->invalid);
+	EXPECT_FALSE(cache.GetBlock(b)->invalid);
+
+	// Nothing is left behind in the page index.
+	cache.InvalidateICache(0x80000000, 0x20000);
+	EXPECT_TRUE(cache.GetBlock(b)->invalid);
+	EXPECT_EQ(3, cache.num_destroyed);
+}
+
+TEST_F(JitCacheTest, EvictBlocks)
+{
+	static u8 code[2][16];
+	int a = cache.AddBlock(0x80003000, 4, 0x80003010, code[0]);
+	int b = cache.AddBlock(0x80003010, 8, 0x80003000, code[1]);
+	int c = cache.AddBlock(0x80003100, 8, 0x80003010, code[0]);
+	ASSERT_TRUE(cache.GetBlock(a)->linkData[0].linkStatus);
+	ASSERT_TRUE(cache.GetBlock(c)->linkData[0].linkStatus);
+
+	EXPECT_EQ(1, cache.EvictBlocks(code[1], code[2]));
+	EXPECT_TRUE(cache.GetBlock(b)->invalid);
+	EXPECT_EQ(-1, cache.GetBlockNumberFromStartAddress(0x80003010));
+	EXPECT_FALSE(cache.GetBlock(a)->invalid);
+	EXPECT_FALSE(cache.GetBlock(c)->invalid);
+	// Both exits into b now go through the dispatcher.
+	EXPECT_FALSE(cache.GetBlock(a)->linkData[0].linkStatus);
+	EXPECT_FALSE(cache.GetBlock(c)->linkData[0].linkStatus);
+	EXPECT_EQ(1u, cache.GetStats().numEvictions);
+	EXPECT_EQ(1u, cache.GetStats().numEvictedBlocks);
+
+	// Recompiling b reuses its slot and links a and c to it again.
+	int d = cache.AddBlock(0x80003010, 8, 0x80003000, code[1]);
+	EXPECT_EQ(b, d);
+	EXPECT_TRUE(cache.GetBlock(a)->linkData[0].linkStatus);
+	EXPECT_TRUE(cache.GetBlock(c)->linkData[0].linkStatus);
+	EXPECT_EQ(1u, cache.GetStats().numRecompilations);
+
+	// Blocks outside of the range are left alone.
+	EXPECT_EQ(0, cache.EvictBlocks(code[1] + 1, code[2]));
+	EXPECT_EQ(2, cache.EvictBlocks(code[0], code[1]));
+	EXPECT_EQ(d, cache.GetBlockNumberFromStartAddress(0x80003010));
+	EXPECT_EQ(3u, cache.GetStats().numEvictedBlocks);
+}
+
+TEST_F(JitCacheTest, PromoteBlock)
+{
+	int a = cache.AddBlock(0x80003000, 4, 0x80003010);
+	int b = cache.AddBlock(0x80003010, 8, 0x80003000);
+	JitBlock* block = cache.GetBlock(b);
+	block->runCount = 11;
+	block->ticCounter = 800;
+
+	EXPECT_FALSE(cache.IsPromoted(0x80003010));
+	cache.PromoteBlock(b);
+	EXPECT_TRUE(block->invalid);
+	EXPECT_FALSE(cache.GetBlock(a)->linkData[0].linkStatus);
+	EXPECT_TRUE(cache.IsPromoted(0x80003010));
+	EXPECT_FALSE(cache.IsPromoted(0x80003000));
+	EXPECT_EQ(1u, cache.GetStats().numPromotions);
+
+	const JitBlockBaseline* baseline = cache.GetPromotionBaseline(0x80003010);
+	ASSERT_NE(nullptr, baseline);
+	EXPECT_EQ(800u, baseline->ticCounter);
+	EXPECT_EQ(80u, baseline->numInstructions);
+
+	// The promoted block is gone from the page index as well.
+	cache.InvalidateICache(0x80003000, 0x100);
+	EXPECT_TRUE(cache.GetBlock(a)->invalid);
+
+	cache.Clear();
+	EXPECT_FALSE(cache.IsPromoted(0x80003010));
+}
+
+TEST_F(JitCacheTest, CountInlinedFunctions)
+{
+	static u8 code[16];
+	int a = cache.AddBlock(0x80003000, 4, 0x80003010, code, {{0x80005000, 3}, {0x80006000, 2}});
+	int b = cache.AddBlock(0x80003010, 4, 0x80003000, code, {{0x80005000, 3}});
+	EXPECT_TRUE(cache.GetInlineCounts().empty());
+
+	cache.CountInlinedFunctions(*cache.GetBlock(a));
+	cache.CountInlinedFunctions(*cache.GetBlock(b));
+	const std::map<u32, u64>& counts = cache.GetInlineCounts();
+	ASSERT_EQ(2u, counts.size());
+	EXPECT_EQ(2u, counts.at(0x80005000));
+	EXPECT_EQ(1u, counts.at(0x80006000));
+
+	cache.Clear();
+	EXPECT_TRUE(cache.GetInlineCounts().empty());
+}
+
+// Not a correctness test: fills the whole cache with small blocks, then
+// invalidates it in large ranges the way code overlays and DMA do.
+TEST_F(JitCacheTest, InvalidateBenchmark)
+{
+	const u32 BLOCK_INSTRUCTIONS = 8;
+	const u32 RANGE = 0x10000;
+
+	for (int round = 0; round < 3; ++round)
+	{
+		auto fill_start = std::chrono::high_resolution_clock::now();
+		u32 address = 0x80000000;
+		while (!cache.IsFull())
+		{
+			cache.AddBlock(address, BLOCK_INSTRUCTIONS, address + BLOCK_INSTRUCTIONS * 4);
+			address += BLOCK_INSTRUCTIONS * 4;
+		}
+		int num_blocks = cache.GetNumBlocks();
+
+		// Ranges without any code in them, e.g. DMA to data buffers.
+		auto miss_start = std::chrono::high_resolution_clock::now();
+		for (u32 offset = 0; offset < 0x400000; offset += RANGE)
+			cache.InvalidateICache(0x81000000 + offset, RANGE);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		for (u32 offset = 0; offset < address - 0x80000000; offset += RANGE)
+			cache.InvalidateICache(0x80000000 + offset, RANGE);
+		auto end = std::chrono::high_resolution_clock::now();
+
+		for (int i = 0; i < num_blocks; ++i)
+			ASSERT_TRUE(cache.GetBlock(i)->invalid);
+
+		auto to_ms = [](std::chrono::high_resolution_clock::duration d) {
+			return std::chrono::duration_cast<std::chrono::microseconds>(d).count() / 1000.0;
+		};
+		printf("%d blocks: filled in %.2f ms, 0x%x byte ranges invalidated in %.2f ms, "
+		       "empty ranges in %.2f ms\n", num_blocks, to_ms(miss_start - fill_start),
+		       RANGE, to_ms(end - start), to_ms(start - miss_start));
+
+		cache.Clear();
+	}
+}
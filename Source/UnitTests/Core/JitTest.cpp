@@ -0,0 +1,693 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+// Before gtest: XEmitter has a TEST method, which the gtest macro breaks.
+#include "Core/PowerPC/JitCommon/JitBase.h"
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/Host.h"
+#include "Core/MemTools.h"
+#include "Core/HLE/HLE.h"
+#include "Core/HW/Memmap.h"
+#include "Core/HW/MMIO.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "VideoCommon/VideoBackendBase.h"
+
+// The CPU cores are run on their own, without a frontend or a video backend.
+bool Host_RendererHasFocus() { return false; }
+void Host_ConnectWiimote(int wm_idx, bool connect) {}
+void Host_GetRenderWindowSize(int& x, int& y, int& width, int& height) {}
+void Host_Message(int Id) {}
+void Host_NotifyMapLoaded() {}
+void Host_RefreshDSPDebuggerWindow() {}
+void Host_RequestRenderWindowSize(int width, int height) {}
+void Host_SetStartupDebuggingParameters() {}
+void Host_SetWiiMoteConnectionState(int _State) {}
+void Host_ShowJitResults(unsigned int address) {}
+void Host_SysMessage(const char *fmt, ...) {}
+void Host_UpdateBreakPointView() {}
+void Host_UpdateDisasmDialog() {}
+void Host_UpdateLogDisplay() {}
+void Host_UpdateMainFrame() {}
+void Host_UpdateStatusBar(const std::string& text, int Filed) {}
+void Host_UpdateTitle(const std::string& title) {}
+void* Host_GetInstance() { return nullptr; }
+void* Host_GetRenderHandle() { return nullptr; }
+
+namespace
+{
+
+// Only there for the command processor's MMIOs.
+class TestVideoBackend : public VideoBackendHardware
+{
+	void UpdateFPSDisplay(const std::string&) override {}
+	unsigned int PeekMessages() override { return 0; }
+	void Shutdown() override {}
+	std::string GetName() const override { return "Test"; }
+	void Video_Prepare() override {}
+	void Video_Cleanup() override {}
+};
+
+TestVideoBackend s_video_backend;
+
+}  // namespace
+
+VideoBackend* g_video_backend = &s_video_backend;
+
+namespace
+{
+
+enum
+{
+	CORE_JIT64 = 1,
+	CORE_CACHED_INTERPRETER = 5,
+};
+
+// The guest code ends by branching here, where it spins until the CPU core
+// is stopped.
+const u32 HALT_ADDRESS = 0x80003000;
+const u32 CODE_ADDRESS = 0x80004000;
+
+// Encodes the instructions the tests use.
+u32 DForm(u32 opcd, u32 rd, u32 ra, u32 imm) { return opcd << 26 | rd << 21 | ra << 16 | (imm & 0xFFFF); }
+u32 XForm(u32 xo, u32 rd, u32 ra, u32 rb, bool rc = false) { return 31 << 26 | rd << 21 | ra << 16 | rb << 11 | xo << 1 | rc; }
+u32 ADDI(u32 rd, u32 ra, s16 simm) { return DForm(14, rd, ra, simm); }
+u32 LI(u32 rd, s16 simm) { return ADDI(rd, 0, simm); }
+u32 ADDIS(u32 rd, u32 ra, s16 simm) { return DForm(15, rd, ra, simm); }
+u32 ORI(u32 ra, u32 rs, u16 uimm) { return DForm(24, rs, ra, uimm); }
+u32 CMPWI(u32 crf, u32 ra, s16 simm) { return DForm(11, crf << 2, ra, simm); }
+u32 LWZ(u32 rd, u32 ra, s16 d) { return DForm(32, rd, ra, d); }
+u32 LWZU(u32 rd, u32 ra, s16 d) { return DForm(33, rd, ra, d); }
+u32 LFS(u32 frd, u32 ra, s16 d) { return DForm(48, frd, ra, d); }
+u32 STFS(u32 frs, u32 ra, s16 d) { return DForm(52, frs, ra, d); }
+u32 FADDS(u32 frd, u32 fra, u32 frb) { return 59 << 26 | frd << 21 | fra << 16 | frb << 11 | 21 << 1; }
+u32 STW(u32 rs, u32 ra, s16 d) { return DForm(36, rs, ra, d); }
+u32 STWU(u32 rs, u32 ra, s16 d) { return DForm(37, rs, ra, d); }
+u32 STH(u32 rs, u32 ra, s16 d) { return DForm(44, rs, ra, d); }
+u32 STB(u32 rs, u32 ra, s16 d) { return DForm(38, rs, ra, d); }
+u32 ADD(u32 rd, u32 ra, u32 rb) { return XForm(266, rd, ra, rb); }
+u32 SUBF(u32 rd, u32 ra, u32 rb) { return XForm(40, rd, ra, rb); }
+u32 MTMSR(u32 rs) { return XForm(146, rs, 0, 0); }
+u32 XOR(u32 ra, u32 rs, u32 rb) { return XForm(316, rs, ra, rb); }
+u32 CMPW(u32 crf, u32 ra, u32 rb) { return XForm(0, crf << 2, ra, rb); }
+u32 MTCTR(u32 rs) { return 0x7C0903A6 | rs << 21; }
+u32 MFLR(u32 rd) { return 0x7C0802A6 | rd << 21; }
+u32 MTLR(u32 rs) { return 0x7C0803A6 | rs << 21; }
+const u32 BLR = 0x4E800020;
+const u32 BLRL = 0x4E800021;
+const u32 BCTR = 0x4E800420;
+
+// BO values of the conditional branches.
+enum
+{
+	BO_FALSE = 4,
+	BO_TRUE = 12,
+	BO_DNZ = 16,
+};
+
+// Writes guest code to memory, with branches to labels resolved as they are bound.
+class GuestCode
+{
+public:
+	explicit GuestCode(u32 address) : m_pc(address) {}
+
+	u32 Here() const { return m_pc; }
+
+	void Emit(u32 inst)
+	{
+		Memory::Write_U32(inst, m_pc);
+		m_pc += 4;
+	}
+
+	// Loads a 32 bit constant.
+	void LoadImm(u32 rd, u32 value)
+	{
+		Emit(ADDIS(rd, 0, (s16)(value >> 16)));
+		Emit(ORI(rd, rd, (u16)value));
+	}
+
+	void B(u32 target, bool link = false)
+	{
+		Emit(18 << 26 | ((target - m_pc) & 0x03FFFFFC) | link);
+	}
+
+	void BC(u32 bo, u32 bi, u32 target)
+	{
+		Emit(16 << 26 | bo << 21 | bi << 16 | ((target - m_pc) & 0xFFFC));
+	}
+
+	// A forward conditional branch, bound with SetTarget.
+	u32 BCForward(u32 bo, u32 bi)
+	{
+		u32 address = m_pc;
+		Emit(16 << 26 | bo << 21 | bi << 16);
+		return address;
+	}
+
+	void SetTarget(u32 branch)
+	{
+		Memory::Write_U32(Memory::Read_U32(branch) | ((m_pc - branch) & 0xFFFC), branch);
+	}
+
+	void Halt() { B(HALT_ADDRESS); }
+
+private:
+	u32 m_pc;
+};
+
+void StopAtHalt(int cyclesExecuted)
+{
+	if (PC == HALT_ADDRESS)
+		PowerPC::Pause();
+}
+
+// Raises a decrementer interrupt, which is taken once the code run next has
+// used up its time.
+void RaiseDecrementer(int cyclesExecuted)
+{
+	Common::AtomicOr(PowerPC::ppcState.Exceptions, EXCEPTION_DECREMENTER);
+	CoreTiming::ForceExceptionCheck(10);
+	CoreTiming::RegisterAdvanceCallback(&StopAtHalt);
+}
+
+class JitTest : public testing::Test
+{
+protected:
+	static void SetUpTestCase()
+	{
+		SConfig::Init();
+		Memory::Init();
+		EMM::InstallExceptionHandler();
+		Memory::Write_U32(18 << 26, HALT_ADDRESS);
+	}
+
+	static void TearDownTestCase()
+	{
+		Memory::Shutdown();
+		SConfig::Shutdown();
+	}
+
+	virtual void SetUp() override
+	{
+		CoreTiming::Init();
+		CoreTiming::RegisterAdvanceCallback(&StopAtHalt);
+	}
+
+	virtual void TearDown() override
+	{
+		PowerPC::Shutdown();
+		CoreTiming::RegisterAdvanceCallback(nullptr);
+		CoreTiming::Shutdown();
+	}
+
+	void StartCore(int core)
+	{
+		PowerPC::Init(core);
+	}
+
+	// Runs the guest code at address until it halts.
+	void Run(u32 address)
+	{
+		PC = address;
+		PowerPC::RunLoop();
+		ASSERT_EQ(HALT_ADDRESS, PC);
+	}
+};
+
+// Loops in which the optimizing tier has something to do: a compare with a
+// forward branch, memory accesses, and a call to a leaf function. Each
+// writes its code and returns where it starts.
+struct HotLoop
+{
+	const char* name;
+	u32 (*write)(GuestCode& code, u32 iterations);
+	int instructions_per_iteration;
+};
+
+u32 WriteArithmeticLoop(GuestCode& code, u32 iterations)
+{
+	u32 start = code.Here();
+	code.LoadImm(3, iterations);
+	code.Emit(MTCTR(3));
+	code.Emit(LI(4, 0));
+	code.Emit(LI(5, 1));
+	code.Emit(LI(6, 1000));
+	u32 loop = code.Here();
+	code.Emit(ADD(4, 4, 5));
+	code.Emit(XOR(7, 4, 5));
+	code.Emit(ADDI(5, 5, 3));
+	code.Emit(CMPW(0, 5, 6));
+	u32 skip = code.BCForward(BO_TRUE, 0);
+	code.Emit(SUBF(5, 6, 5));
+	code.SetTarget(skip);
+	code.BC(BO_DNZ, 0, loop);
+	code.Emit(ADD(4, 4, 7));
+	code.Halt();
+	return start;
+}
+
+u32 WriteCopyLoop(GuestCode& code, u32 iterations)
+{
+	const u32 src = 0x80100000;
+	const u32 dst = 0x80200000;
+	const u32 words = 256;
+	for (u32 i = 0; i < words; ++i)
+		Memory::Write_U32(i * 0x01010101, src + i * 4);
+
+	u32 start = code.Here();
+	code.LoadImm(11, iterations / words);
+	code.Emit(LI(4, 0));
+	u32 outer = code.Here();
+	code.LoadImm(8, src - 4);
+	code.LoadImm(9, dst - 4);
+	code.Emit(LI(3, words));
+	code.Emit(MTCTR(3));
+	u32 inner = code.Here();
+	code.Emit(LWZU(7, 8, 4));
+	code.Emit(ADD(4, 4, 7));
+	code.Emit(STWU(7, 9, 4));
+	code.BC(BO_DNZ, 0, inner);
+	code.Emit(ADDI(11, 11, -1));
+	code.Emit(CMPWI(0, 11, 0));
+	code.BC(BO_FALSE, 2, outer);
+	code.Halt();
+	return start;
+}
+
+u32 WriteCallLoop(GuestCode& code, u32 iterations)
+{
+	u32 function = code.Here();
+	code.Emit(ADD(4, 4, 5));
+	code.Emit(XOR(5, 5, 4));
+	code.Emit(BLR);
+
+	u32 start = code.Here();
+	code.LoadImm(3, iterations);
+	code.Emit(MTCTR(3));
+	code.Emit(LI(4, 0));
+	code.Emit(LI(5, 7));
+	u32 loop = code.Here();
+	code.B(function, true);
+	code.Emit(ADDI(5, 5, 1));
+	code.BC(BO_DNZ, 0, loop);
+	code.Halt();
+	return start;
+}
+
+u32 WriteFloatLoop(GuestCode& code, u32 iterations)
+{
+	const u32 data = 0x80100000;
+	u32 start = code.Here();
+	// The FP instructions need MSR[FP].
+	code.LoadImm(3, 1 << 13);
+	code.Emit(MTMSR(3));
+	code.LoadImm(3, iterations);
+	code.Emit(MTCTR(3));
+	code.LoadImm(8, data);
+	code.LoadImm(5, 0x3F800000);
+	code.Emit(STW(5, 8, 0));
+	code.Emit(LI(4, 0));
+	u32 loop = code.Here();
+	code.Emit(LFS(1, 8, 0));
+	code.Emit(FADDS(1, 1, 1));
+	code.Emit(STFS(1, 8, 0));
+	code.Emit(LWZ(5, 8, 0));
+	code.Emit(XOR(4, 4, 5));
+	code.BC(BO_DNZ, 0, loop);
+	code.Halt();
+	return start;
+}
+
+const HotLoop HOT_LOOPS[] = {
+	{ "arithmetic", &WriteArithmeticLoop, 6 },
+	{ "copy", &WriteCopyLoop, 4 },
+	{ "call", &WriteCallLoop, 6 },
+	{ "float", &WriteFloatLoop, 6 },
+};
+
+}  // namespace
+
+// The optimizing tier computes the same as the first one.
+TEST_F(JitTest, TiersAgree)
+{
+	for (const HotLoop& loop : HOT_LOOPS)
+	{
+		GuestCode code(CODE_ADDRESS);
+		u32 start = loop.write(code, 100000);
+
+		u32 results[2];
+		for (int tiered = 0; tiered < 2; ++tiered)
+		{
+			Core::g_CoreStartupParameter.bJITTieredCompilation = tiered != 0;
+			StartCore(CORE_JIT64);
+			Run(start);
+			results[tiered] = GPR(4);
+			u64 promotions = jit->GetBlockCache()->GetStats().numPromotions;
+			if (tiered)
+				EXPECT_NE(0u, promotions) << loop.name;
+			else
+				EXPECT_EQ(0u, promotions) << loop.name;
+			PowerPC::Shutdown();
+		}
+		EXPECT_EQ(results[0], results[1]) << loop.name;
+	}
+	StartCore(CORE_JIT64);
+}
+
+// Not a correctness test: host time per guest instruction of the hot loops,
+// with the blocks kept in the first tier and with them promoted.
+TEST_F(JitTest, TierBenchmark)
+{
+	const u32 ITERATIONS = 4 * 1024 * 1024;
+	const int RUNS = 5;
+
+	printf("%-12s %12s %12s\n", "loop", "tier 0 ns", "tier 1 ns");
+	for (const HotLoop& loop : HOT_LOOPS)
+	{
+		GuestCode code(CODE_ADDRESS);
+		u32 start = loop.write(code, ITERATIONS);
+
+		printf("%-12s", loop.name);
+		for (int tiered = 0; tiered < 2; ++tiered)
+		{
+			double best = 1e9;
+			for (int run = 0; run < RUNS; ++run)
+			{
+				Core::g_CoreStartupParameter.bJITTieredCompilation = tiered != 0;
+				StartCore(CORE_JIT64);
+				auto begin = std::chrono::high_resolution_clock::now();
+				Run(start);
+				auto time = std::chrono::high_resolution_clock::now() - begin;
+				PowerPC::Shutdown();
+				double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+				best = std::min(best, ns / ((double)ITERATIONS * loop.instructions_per_iteration));
+			}
+			printf(" %12.3f", best);
+		}
+		printf("\n");
+	}
+	StartCore(CORE_JIT64);
+}
+
+// blrl calls through LR, and the callee returns through the return stack,
+// from a nested call as well.
+TEST_F(JitTest, CallThroughLR)
+{
+	const u32 ITERATIONS = 5000;
+	GuestCode code(CODE_ADDRESS);
+	u32 leaf = code.Here();
+	code.Emit(ADDI(4, 4, 3));
+	code.Emit(BLR);
+
+	u32 function = code.Here();
+	code.Emit(MFLR(6));
+	code.B(leaf, true);
+	code.Emit(XOR(5, 5, 4));
+	code.Emit(MTLR(6));
+	code.Emit(BLR);
+
+	u32 start = code.Here();
+	code.LoadImm(3, ITERATIONS);
+	code.Emit(MTCTR(3));
+	code.LoadImm(7, function);
+	code.Emit(LI(4, 0));
+	code.Emit(LI(5, 0));
+	u32 loop = code.Here();
+	code.Emit(MTLR(7));
+	code.Emit(BLRL);
+	u32 return_address = code.Here();
+	code.Emit(ADDI(4, 4, 1));
+	code.BC(BO_DNZ, 0, loop);
+	code.Halt();
+
+	u32 results[2];
+	const int cores[2] = { CORE_CACHED_INTERPRETER, CORE_JIT64 };
+	for (int i = 0; i < 2; ++i)
+	{
+		StartCore(cores[i]);
+		Run(start);
+		EXPECT_EQ(4 * ITERATIONS, GPR(4)) << cores[i];
+		EXPECT_EQ(return_address, LR) << cores[i];
+		results[i] = GPR(5);
+		PowerPC::Shutdown();
+	}
+	EXPECT_EQ(results[0], results[1]);
+	StartCore(CORE_JIT64);
+}
+
+// A register the code after a block overwrites is dead at the block's exit,
+// unless an instruction before that may raise an exception: the handler may
+// look at the register.
+TEST_F(JitTest, SuccessorLivenessStopsAtExceptions)
+{
+	struct Successor
+	{
+		const char* name;
+		u32 first;
+		bool mmu;
+		bool fifo;
+		bool live;
+	};
+	const Successor successors[] = {
+		{ "addi", ADDI(5, 5, 1), false, false, false },
+		{ "lwz", LWZ(6, 4, 0), false, false, false },
+		{ "lwz with MMU", LWZ(6, 4, 0), true, false, true },
+		{ "lfs", LFS(1, 4, 0), false, false, true },
+		{ "stw", STW(6, 4, 0), false, false, false },
+		{ "stw to the FIFO", STW(6, 4, 0), false, true, true },
+	};
+
+	for (const Successor& successor : successors)
+	{
+		const u32 successor_address = CODE_ADDRESS + 0x100;
+		GuestCode code(CODE_ADDRESS);
+		code.Emit(ADDI(3, 3, 1));
+		code.B(successor_address);
+		GuestCode successor_code(successor_address);
+		successor_code.Emit(successor.first);
+		successor_code.Emit(LI(3, 0));
+		successor_code.Emit(BLR);
+		StartCore(CORE_JIT64);
+		// The external exception check in front of the FIFO writes.
+		if (successor.fifo)
+			jit->js.fifoWriteAddresses.insert(successor_address);
+
+		PPCAnalyst::PPCAnalyzer analyzer;
+		analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_SUCCESSOR_LIVENESS);
+		PPCAnalyst::CodeBlock block;
+		PPCAnalyst::BlockStats stats;
+		PPCAnalyst::BlockRegStats gpa, fpa;
+		block.m_stats = &stats;
+		block.m_gpa = &gpa;
+		block.m_fpa = &fpa;
+		PPCAnalyst::CodeBuffer buffer(32);
+
+		bool mmu = Core::g_CoreStartupParameter.bMMU;
+		Core::g_CoreStartupParameter.bMMU = successor.mmu;
+		analyzer.Analyze(CODE_ADDRESS, &block, &buffer, 32);
+		Core::g_CoreStartupParameter.bMMU = mmu;
+
+		ASSERT_EQ(2u, block.m_num_instructions) << successor.name;
+		EXPECT_EQ(successor.live, (buffer.codebuffer[0].gprLiveAfter & (1 << 3)) != 0) << successor.name;
+		PowerPC::Shutdown();
+	}
+
+	// Interrupts are taken at the exits, once the block ran out of time, and
+	// the handler runs instead of the successor.
+	GuestCode handler(0x80000900);
+	handler.LoadImm(12, HALT_ADDRESS);
+	handler.Emit(MTCTR(12));
+	handler.Emit(BCTR);
+
+	// Far enough for the branch to end the block.
+	const u32 successor_address = CODE_ADDRESS + 0x1000;
+	GuestCode code(CODE_ADDRESS);
+	for (int i = 0; i < 32; ++i)
+		code.Emit(ADDI(4, 4, 1));
+	code.Emit(LI(3, 42));
+	code.B(successor_address);
+	GuestCode successor_code(successor_address);
+	successor_code.Emit(LI(3, 0));
+	successor_code.Halt();
+
+	// The successor's liveness is only looked at by the optimizing tier.
+	StartCore(CORE_JIT64);
+	Run(CODE_ADDRESS);
+	JitBaseBlockCache *blocks = jit->GetBlockCache();
+	blocks->PromoteBlock(blocks->GetBlockNumberFromStartAddress(CODE_ADDRESS));
+
+	GPR(3) = 7;
+	MSR = 0x8000;
+	CoreTiming::RegisterAdvanceCallback(&RaiseDecrementer);
+	Run(CODE_ADDRESS);
+	EXPECT_EQ(successor_address, SRR0);
+	EXPECT_EQ(42u, GPR(3));
+	MSR = 0;
+}
+
+// A loop keeps its registers in host registers, but has them in memory when it
+// runs out of time and an interrupt is taken.
+TEST_F(JitTest, InterruptInLoop)
+{
+	GuestCode handler(0x80000900);
+	handler.Emit(ADDI(5, 4, 0));
+	handler.LoadImm(12, HALT_ADDRESS);
+	handler.Emit(MTCTR(12));
+	handler.Emit(BCTR);
+
+	GuestCode code(CODE_ADDRESS);
+	code.Emit(LI(4, 0));
+	u32 loop = code.Here();
+	code.Emit(ADDI(4, 4, 1));
+	code.BC(BO_DNZ, 0, loop);
+	code.Halt();
+
+	// Loops within a block are only compiled by the optimizing tier.
+	StartCore(CORE_JIT64);
+	CTR = 1;
+	Run(CODE_ADDRESS);
+	JitBaseBlockCache *blocks = jit->GetBlockCache();
+	blocks->PromoteBlock(blocks->GetBlockNumberFromStartAddress(CODE_ADDRESS));
+
+	CTR = 1000000;
+	GPR(5) = 0;
+	MSR = 0x8000;
+	CoreTiming::RegisterAdvanceCallback(&RaiseDecrementer);
+	Run(CODE_ADDRESS);
+	EXPECT_EQ(loop, SRR0);
+	EXPECT_NE(0u, GPR(4));
+	EXPECT_EQ(GPR(4), GPR(5));
+	MSR = 0;
+}
+
+// The cached interpreter's worst case: every instruction is hooked by HLE
+// and checks for DSI, and the first one for FPU unavailable as well. Its code
+// array must fill up and be cleared without ever being reallocated, as the
+// blocks point into it.
+TEST_F(JitTest, CachedInterpreterCodeNeverMoves)
+{
+	const u32 BLOCK_SIZE = 128;
+	const u32 NUM_INSTRUCTIONS = 0x10000;
+
+	GuestCode code(CODE_ADDRESS);
+	for (u32 i = 0; i < NUM_INSTRUCTIONS; ++i)
+	{
+		HLE::Patch(code.Here(), "GeckoCodehandler");
+		if (i % BLOCK_SIZE == BLOCK_SIZE - 1)
+			code.B(code.Here() + 4);
+		else
+			code.Emit(i & 1 ? STFS(1, 4, 0) : LFS(1, 4, 0));
+	}
+
+	bool mmu = Core::g_CoreStartupParameter.bMMU;
+	Core::g_CoreStartupParameter.bMMU = true;
+	StartCore(CORE_CACHED_INTERPRETER);
+
+	JitBaseBlockCache* cache = jit->GetBlockCache();
+	const u8* base = nullptr;
+	u64 flushes = cache->GetStats().numFlushes;
+	// Every address starts a block of its own, up to the next branch.
+	for (u32 address = CODE_ADDRESS; address < code.Here() && cache->GetStats().numFlushes < flushes + 2; address += 4)
+	{
+		jit->Jit(address);
+		const JitBlock* b = cache->GetBlock(cache->GetBlockNumberFromStartAddress(address));
+		EXPECT_LE(b->codeSize, 5 * b->originalSize + 3) << std::hex << address;
+		if (!base)
+			base = b->normalEntry;
+		// Cleared, and back at the start of the same array.
+		if (cache->GetStats().numFlushes != flushes)
+		{
+			EXPECT_EQ(base, b->normalEntry) << std::hex << address;
+			flushes = cache->GetStats().numFlushes;
+		}
+	}
+	EXPECT_NE(0u, flushes);
+
+	PowerPC::Shutdown();
+	Core::g_CoreStartupParameter.bMMU = mmu;
+	HLE::PatchFunctions();
+	StartCore(CORE_JIT64);
+}
+
+// Stores to constant MMIO addresses are compiled against the handler of the
+// register: each handler has to get the value, at the width of the store.
+TEST_F(JitTest, MMIOStores)
+{
+	const u32 MMIO_BASE = 0xCC007000;
+	// Direct handlers, each followed by a guard which a wider store would hit.
+	struct
+	{
+		u32 value32, guard32;
+		u16 value16, guard16;
+		u8 value8, guard8;
+	} direct = {};
+	// The width each complex handler saw, and the value.
+	u32 complex_width[3] = {};
+	u32 complex_value[3] = {};
+
+	MMIO::Mapping* mmio = Memory::mmio_mapping;
+	mmio->RegisterWrite(MMIO_BASE + 0x00, MMIO::DirectWrite<u32>(&direct.value32, 0x00FF00FF));
+	mmio->RegisterWrite(MMIO_BASE + 0x10, MMIO::DirectWrite<u16>(&direct.value16));
+	mmio->RegisterWrite(MMIO_BASE + 0x20, MMIO::DirectWrite<u8>(&direct.value8));
+	mmio->RegisterWrite(MMIO_BASE + 0x40, MMIO::ComplexWrite<u32>([&](u32 addr, u32 val) {
+		complex_width[0] = 32;
+		complex_value[0] = val;
+	}));
+	mmio->RegisterWrite(MMIO_BASE + 0x50, MMIO::ComplexWrite<u16>([&](u32 addr, u16 val) {
+		complex_width[1] = 16;
+		complex_value[1] = val;
+	}));
+	mmio->RegisterWrite(MMIO_BASE + 0x60, MMIO::ComplexWrite<u8>([&](u32 addr, u8 val) {
+		complex_width[2] = 8;
+		complex_value[2] = val;
+	}));
+
+	GuestCode code(CODE_ADDRESS);
+	u32 start = code.Here();
+	code.Emit(ADDIS(4, 0, (s16)(MMIO_BASE >> 16)));
+	code.LoadImm(3, 0x12345678);
+	const s16 offset = (s16)(MMIO_BASE & 0xFFFF);
+	code.Emit(STW(3, 4, offset + 0x00));
+	code.Emit(STH(3, 4, offset + 0x10));
+	code.Emit(STB(3, 4, offset + 0x20));
+	code.Emit(STW(3, 4, offset + 0x40));
+	code.Emit(STH(3, 4, offset + 0x50));
+	code.Emit(STB(3, 4, offset + 0x60));
+	code.Halt();
+
+	StartCore(CORE_JIT64);
+	Run(start);
+
+	EXPECT_EQ(0x00340078u, direct.value32);
+	EXPECT_EQ(0x5678u, direct.value16);
+	EXPECT_EQ(0x78u, direct.value8);
+	EXPECT_EQ(0u, direct.guard32);
+	EXPECT_EQ(0u, direct.guard16);
+	EXPECT_EQ(0u, direct.guard8);
+
+	EXPECT_EQ(32u, complex_width[0]);
+	EXPECT_EQ(0x12345678u, complex_value[0]);
+	EXPECT_EQ(16u, complex_width[1]);
+	EXPECT_EQ(0x5678u, complex_value[1]);
+	EXPECT_EQ(8u, complex_width[2]);
+	EXPECT_EQ(0x78u, complex_value[2]);
+
+	// The handlers point into this frame.
+	for (u32 reg : { 0x00, 0x10, 0x20, 0x40, 0x50, 0x60 })
+	{
+		mmio->RegisterWrite(MMIO_BASE + reg, MMIO::Nop<u32>());
+		mmio->RegisterWrite(MMIO_BASE + reg, MMIO::Nop<u16>());
+		mmio->RegisterWrite(MMIO_BASE + reg, MMIO::Nop<u8>());
+	}
+}
@@ -0,0 +1,127 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "Common/Common.h"
+#include "VideoCommon/TextureDecodeWorkers.h"
+#include "VideoCommon/TextureDecoder.h"
+#include "VideoCommon/VideoConfig.h"
+
+// The workers only look at the format overlay setting, which stays off.
+VideoConfig g_ActiveConfig;
+VideoConfig::VideoConfig() {}
+
+namespace
+{
+
+struct Format
+{
+	const char* name;
+	int texformat;
+	int tlutfmt;
+};
+
+const Format FORMATS[] = {
+	{ "I4", GX_TF_I4, 0 },
+	{ "I8", GX_TF_I8, 0 },
+	{ "IA4", GX_TF_IA4, 0 },
+	{ "IA8", GX_TF_IA8, 0 },
+	{ "RGB565", GX_TF_RGB565, 0 },
+	{ "RGB5A3", GX_TF_RGB5A3, 0 },
+	{ "RGBA8", GX_TF_RGBA8, 0 },
+	{ "C4 IA8", GX_TF_C4, 0 },
+	{ "C4 RGB565", GX_TF_C4, 1 },
+	{ "C4 RGB5A3", GX_TF_C4, 2 },
+	{ "C8 IA8", GX_TF_C8, 0 },
+	{ "C8 RGB565", GX_TF_C8, 1 },
+	{ "C8 RGB5A3", GX_TF_C8, 2 },
+	{ "C14X2 IA8", GX_TF_C14X2, 0 },
+	{ "C14X2 RGB565", GX_TF_C14X2, 1 },
+	{ "C14X2 RGB5A3", GX_TF_C14X2, 2 },
+	{ "CMPR", GX_TF_CMPR, 0 },
+};
+
+// Whole 8x8 blocks, which every format fits. Most heights aren't a multiple
+// of the strips they are split into, so the last strip is a short one; the
+// narrow ones are split into few, tall strips.
+const int SIZES[][2] = { { 8, 8 }, { 64, 200 }, { 128, 136 }, { 256, 88 }, { 32, 1000 }, { 1024, 40 } };
+
+const int NUM_WORKERS = 3;
+
+class TextureDecodeWorkersTest : public ::testing::Test
+{
+protected:
+	TextureDecodeWorkersTest()
+		: m_src(1024 * 1024 * 4)
+	{
+		std::mt19937 rng(1234);
+		for (u8& byte : m_src)
+			byte = (u8)rng();
+		// Palettes at address 0 of TMEM.
+		for (int i = 0; i < 0x8000; ++i)
+			texMem[i] = (u8)rng();
+		TextureDecodeWorkers::Init(NUM_WORKERS);
+	}
+
+	~TextureDecodeWorkersTest()
+	{
+		TextureDecodeWorkers::Shutdown();
+	}
+
+	std::vector<u8> m_src;
+};
+
+}
+
+// Splitting textures into strips decodes them exactly like a single
+// TexDecoder_Decode call, with all sizes decoded at once like mip levels.
+TEST_F(TextureDecodeWorkersTest, StripsMatchWholeTexture)
+{
+	for (bool rgba_only : { false, true })
+	{
+		for (const Format& format : FORMATS)
+		{
+			std::vector<std::vector<u8>> expected;
+			std::vector<std::vector<u8>> decoded;
+			std::vector<PC_TexFormat> expected_formats;
+			std::vector<TextureDecodeWorkers::Job> jobs;
+			for (const auto& size : SIZES)
+			{
+				const int width = size[0];
+				const int height = size[1];
+				expected.emplace_back(width * height * 4, 0xcd);
+				decoded.emplace_back(width * height * 4, 0xcd);
+				expected_formats.push_back(TexDecoder_Decode(expected.back().data(), m_src.data(),
+					width, height, format.texformat, 0, format.tlutfmt, rgba_only));
+			}
+			for (size_t i = 0; i < decoded.size(); ++i)
+			{
+				TextureDecodeWorkers::Job job = { decoded[i].data(), m_src.data(), SIZES[i][0], SIZES[i][1], PC_TEX_FMT_NONE };
+				jobs.push_back(job);
+			}
+
+			TextureDecodeWorkers::Decode(jobs.data(), jobs.size(), format.texformat, 0, format.tlutfmt, rgba_only);
+
+			for (size_t i = 0; i < jobs.size(); ++i)
+			{
+				const char* mode = rgba_only ? " RGBA" : "";
+				EXPECT_EQ(expected_formats[i], jobs[i].pcfmt) << format.name << mode;
+				// The bytes past the decoded texels have to be left alone too.
+				for (size_t j = 0; j < expected[i].size(); ++j)
+				{
+					if (expected[i][j] != decoded[i][j])
+					{
+						ADD_FAILURE() << format.name << mode << " " << SIZES[i][0] << "x" << SIZES[i][1]
+						              << ": byte " << j << " is " << (int)decoded[i][j]
+						              << " instead of " << (int)expected[i][j];
+						break;
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,168 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "Common/Common.h"
+#include "Common/CPUDetect.h"
+#include "VideoCommon/LookUpTables.h"
+#include "VideoCommon/TextureDecoder.h"
+#include "VideoCommon/VideoConfig.h"
+
+// The generic decoder is the reference. It defines the same functions as the
+// x64 one, so it gets its own namespace here.
+namespace Generic
+{
+#include "VideoCommon/TextureDecoder_Generic.cpp"
+}
+
+// The decoders only look at the OpenMP setting, which stays off.
+VideoConfig g_ActiveConfig;
+VideoConfig::VideoConfig() {}
+
+namespace
+{
+
+struct Format
+{
+	const char* name;
+	int texformat;
+	int tlutfmt;
+};
+
+const Format FORMATS[] = {
+	{ "I4", GX_TF_I4, 0 },
+	{ "I8", GX_TF_I8, 0 },
+	{ "IA4", GX_TF_IA4, 0 },
+	{ "IA8", GX_TF_IA8, 0 },
+	{ "RGB565", GX_TF_RGB565, 0 },
+	{ "RGB5A3", GX_TF_RGB5A3, 0 },
+	{ "RGBA8", GX_TF_RGBA8, 0 },
+	{ "C4 IA8", GX_TF_C4, 0 },
+	{ "C4 RGB565", GX_TF_C4, 1 },
+	{ "C4 RGB5A3", GX_TF_C4, 2 },
+	{ "C8 IA8", GX_TF_C8, 0 },
+	{ "C8 RGB565", GX_TF_C8, 1 },
+	{ "C8 RGB5A3", GX_TF_C8, 2 },
+	{ "C14X2 IA8", GX_TF_C14X2, 0 },
+	{ "C14X2 RGB565", GX_TF_C14X2, 1 },
+	{ "C14X2 RGB5A3", GX_TF_C14X2, 2 },
+	{ "CMPR", GX_TF_CMPR, 0 },
+};
+
+// Enough source for any format at 1024x1024.
+const int MAX_SIZE = 1024;
+
+class TextureDecoderTest : public ::testing::Test
+{
+protected:
+	TextureDecoderTest()
+		: m_src(MAX_SIZE * MAX_SIZE * 4), m_had_avx2(cpu_info.bAVX2)
+	{
+		std::mt19937 rng(1234);
+		for (u8& byte : m_src)
+			byte = (u8)rng();
+		// Palettes at address 0 of both TMEMs.
+		for (int i = 0; i < 0x8000; ++i)
+			texMem[i] = Generic::texMem[i] = (u8)rng();
+	}
+
+	~TextureDecoderTest()
+	{
+		cpu_info.bAVX2 = m_had_avx2;
+	}
+
+	// The x64 paths to test: all it can pick from on this machine.
+	std::vector<bool> AVX2Paths() const
+	{
+		std::vector<bool> paths(1, false);
+		if (m_had_avx2)
+			paths.push_back(true);
+		return paths;
+	}
+
+	std::vector<u8> m_src;
+	bool m_had_avx2;
+};
+
+}
+
+TEST_F(TextureDecoderTest, MatchesGeneric)
+{
+	// Whole 8x8 blocks, which every format fits.
+	const int sizes[][2] = { { 8, 8 }, { 24, 16 }, { 64, 8 }, { 256, 256 } };
+
+	for (bool avx2 : AVX2Paths())
+	{
+		cpu_info.bAVX2 = avx2;
+		for (const Format& format : FORMATS)
+		{
+			for (const auto& size : sizes)
+			{
+				const int width = size[0];
+				const int height = size[1];
+				std::vector<u32> expected(width * height, 0xdeadbeef);
+				std::vector<u32> decoded(width * height, 0xdeadbeef);
+
+				PC_TexFormat expected_format = Generic::TexDecoder_Decode((u8*)expected.data(), m_src.data(),
+					width, height, format.texformat, 0, format.tlutfmt, true);
+				PC_TexFormat decoded_format = TexDecoder_Decode((u8*)decoded.data(), m_src.data(),
+					width, height, format.texformat, 0, format.tlutfmt, true);
+
+				EXPECT_EQ(expected_format, decoded_format) << format.name;
+				for (int i = 0; i < width * height; ++i)
+				{
+					if (expected[i] != decoded[i])
+					{
+						ADD_FAILURE() << format.name << (avx2 ? " AVX2" : " SSE") << " " << width << "x" << height
+						              << ": texel (" << i % width << ", " << i / width << ") is "
+						              << std::hex << decoded[i] << " instead of " << expected[i];
+						break;
+					}
+				}
+			}
+		}
+	}
+}
+
+// Not a correctness test: decoded MB/s of every format and path.
+TEST_F(TextureDecoderTest, Benchmark)
+{
+	const int SIZE = 512;
+	const int RUNS = 20;
+	std::vector<u32> dst(SIZE * SIZE);
+
+	auto measure = [&](const Format& format, bool generic) {
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int run = 0; run < RUNS; ++run)
+		{
+			if (generic)
+				Generic::TexDecoder_Decode((u8*)dst.data(), m_src.data(), SIZE, SIZE, format.texformat, 0, format.tlutfmt, true);
+			else
+				TexDecoder_Decode((u8*)dst.data(), m_src.data(), SIZE, SIZE, format.texformat, 0, format.tlutfmt, true);
+		}
+		auto time = std::chrono::high_resolution_clock::now() - start;
+		double seconds = std::chrono::duration_cast<std::chrono::microseconds>(time).count() / 1e6;
+		return SIZE * SIZE * 4.0 * RUNS / (1024 * 1024) / std::max(seconds, 1e-6);
+	};
+
+	printf("%-14s %10s %10s %10s\n", "format", "generic", "SSE", "AVX2");
+	for (const Format& format : FORMATS)
+	{
+		printf("%-14s %10.0f", format.name, measure(format, true));
+		for (bool avx2 : AVX2Paths())
+		{
+			cpu_info.bAVX2 = avx2;
+			printf(" %10.0f", measure(format, false));
+		}
+		printf("\n");
+	}
+}
@@ -0,0 +1,171 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/TexturePageIndex.h"
+
+namespace
+{
+
+struct TestEntry
+{
+	u32 addr;
+	u32 size_in_bytes;
+
+	// Same as TextureCache::TCacheEntryBase::IntersectsMemoryRange.
+	bool Intersects(u32 range_address, u32 range_size) const
+	{
+		return !(addr + size_in_bytes < range_address) &&
+		       !(addr >= range_address + range_size);
+	}
+};
+
+std::vector<TestEntry*> Query(const TexturePageIndex<TestEntry>& index, u32 start, u32 size)
+{
+	std::vector<TestEntry*> found;
+	index.ForEachInRange(start, size, [&](TestEntry* entry) { found.push_back(entry); });
+	return found;
+}
+
+// Random textures the way games lay them out: mostly small, some large,
+// in the first 24 MiB.
+std::vector<TestEntry> RandomEntries(std::mt19937& rng, int count)
+{
+	std::uniform_int_distribution<u32> address(0, 0x17FFFFF);
+	std::uniform_int_distribution<u32> log_size(5, 20);
+	std::vector<TestEntry> entries(count);
+	for (TestEntry& entry : entries)
+	{
+		entry.addr = address(rng) & ~31;
+		entry.size_in_bytes = 1 << log_size(rng);
+	}
+	return entries;
+}
+
+}
+
+TEST(TexturePageIndex, FindsOverlappingEntriesOnce)
+{
+	TexturePageIndex<TestEntry> index;
+	// Crosses several 16 KiB pages.
+	TestEntry big = { 0x3000, 0x10000 };
+	TestEntry small = { 0x20000, 0x20 };
+	// EFB copies have no size.
+	TestEntry efb_copy = { 0x40000, 0 };
+	index.Insert(&big);
+	index.Insert(&small);
+	index.Insert(&efb_copy);
+
+	std::vector<TestEntry*> found = Query(index, 0x8000, 0x20000);
+	std::multiset<TestEntry*> found_set(found.begin(), found.end());
+	EXPECT_EQ(1u, found_set.count(&big));
+	EXPECT_EQ(1u, found_set.count(&small));
+	EXPECT_EQ(0u, found_set.count(&efb_copy));
+
+	EXPECT_EQ(1u, Query(index, 0x40000, 4).size());
+
+	index.Remove(&big);
+	found = Query(index, 0, 0x20000);
+	EXPECT_EQ(0u, std::count(found.begin(), found.end(), &big));
+
+	index.Clear();
+	EXPECT_TRUE(Query(index, 0, 0x1000000).empty());
+}
+
+TEST(TexturePageIndex, MatchesLinearScan)
+{
+	std::mt19937 rng(1234);
+	std::vector<TestEntry> entries = RandomEntries(rng, 2000);
+	TexturePageIndex<TestEntry> index;
+	for (TestEntry& entry : entries)
+		index.Insert(&entry);
+	// Removing some has to leave the others findable.
+	for (size_t i = 0; i < entries.size(); i += 3)
+		index.Remove(&entries[i]);
+
+	std::uniform_int_distribution<u32> address(0, 0x17FFFFF);
+	std::uniform_int_distribution<u32> size(0, 0x80000);
+	for (int i = 0; i < 500; ++i)
+	{
+		u32 start = address(rng);
+		u32 range_size = size(rng);
+
+		std::set<TestEntry*> expected;
+		for (size_t j = 0; j < entries.size(); ++j)
+		{
+			if (j % 3 != 0 && entries[j].Intersects(start, range_size))
+				expected.insert(&entries[j]);
+		}
+
+		std::set<TestEntry*> found;
+		index.ForEachInRange(start, range_size, [&](TestEntry* entry) {
+			EXPECT_TRUE(found.insert(entry).second);
+			EXPECT_NE(0u, (entry - &entries[0]) % 3);
+			if (!entry->Intersects(start, range_size))
+				found.erase(entry);
+		});
+		EXPECT_EQ(expected, found);
+	}
+}
+
+// Not a correctness test: compares the index to the address ordered scan
+// the texture cache did before, for EFB copy sized ranges.
+TEST(TexturePageIndex, RangeBenchmark)
+{
+	const u32 RANGE = 640 * 528 * 2;
+
+	for (int count : {1000, 4000, 16000})
+	{
+		std::mt19937 rng(count);
+		std::vector<TestEntry> entries = RandomEntries(rng, count);
+		std::multimap<u32, TestEntry*> by_address;
+		TexturePageIndex<TestEntry> index;
+		for (TestEntry& entry : entries)
+		{
+			by_address.insert(std::make_pair(entry.addr, &entry));
+			index.Insert(&entry);
+		}
+
+		std::vector<u32> starts(1000);
+		std::uniform_int_distribution<u32> address(0, 0x17FFFFF);
+		for (u32& start : starts)
+			start = address(rng) & ~31;
+
+		int scan_hits = 0;
+		auto scan_start = std::chrono::high_resolution_clock::now();
+		for (u32 start : starts)
+		{
+			for (auto& entry : by_address)
+				scan_hits += entry.second->Intersects(start, RANGE);
+		}
+
+		int index_hits = 0;
+		auto index_start = std::chrono::high_resolution_clock::now();
+		for (u32 start : starts)
+		{
+			index.ForEachInRange(start, RANGE, [&](TestEntry* entry) {
+				index_hits += entry->Intersects(start, RANGE);
+			});
+		}
+		auto end = std::chrono::high_resolution_clock::now();
+
+		EXPECT_EQ(scan_hits, index_hits);
+
+		// Per range, averaged over the 1000 ranges.
+		auto to_us = [](std::chrono::high_resolution_clock::duration d) {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count() / 1000.0 / 1000;
+		};
+		printf("%d textures: per 0x%x byte range, %.2f us scanning, %.2f us indexed\n",
+		       count, RANGE, to_us(index_start - scan_start), to_us(end - index_start));
+	}
+}